@@ -63,8 +63,6 @@ CreateL3RrcUeSpecificSinrNeigh (long neighCellId, long sinr)
 }
 
 
-// The memory leaks occurring in this file are wanted because L3-RRC is usually freed after use in the Ric Indication Message
-
 int
 main (int argc, char *argv[])
 {
@@ -0,0 +1,419 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/oran-interface.h"
+#include "ns3/asn1c-types.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+
+/**
+* \file
+* Microbenchmark of the encoding of the KPM RIC Indication Headers and
+* Messages and of the decoding of the RIC Control Messages.
+*
+* For each benchmark the program reports the throughput, the time per
+* message and, on glibc, the number of heap allocations per message.
+*
+* Example:
+* ./ns3 run "oran-interface-bench --ues=100 --itemsPerUe=20 --cells=4 --qcis=4"
+*/
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OranInterfaceBench");
+
+#ifdef __GLIBC__
+// Count the heap allocations by wrapping the glibc allocator, so that the
+// allocations made by asn1c are counted as well
+
+static std::atomic<uint64_t> g_allocations (0);
+
+extern "C" {
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+
+void *
+malloc (size_t size)
+{
+  g_allocations.fetch_add (1, std::memory_order_relaxed);
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  g_allocations.fetch_add (1, std::memory_order_relaxed);
+  return __libc_calloc (nmemb, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  g_allocations.fetch_add (1, std::memory_order_relaxed);
+  return __libc_realloc (ptr, size);
+}
+}
+
+static uint64_t
+GetAllocations ()
+{
+  return g_allocations.load (std::memory_order_relaxed);
+}
+
+#else
+
+static uint64_t
+GetAllocations ()
+{
+  return 0;
+}
+
+#endif
+
+/**
+* Run a benchmark and print its results
+*
+* \param name the name of the benchmark
+* \param iterations number of timed iterations
+* \param body function processing one message
+*/
+static void
+RunBenchmark (std::string name, uint32_t iterations, std::function<void ()> body)
+{
+  // warm up the caches, the arenas and the encode buffers
+  for (uint32_t i = 0; i < std::min<uint32_t> (iterations, 10); i++)
+    {
+      body ();
+    }
+
+  uint64_t allocationsBefore = GetAllocations ();
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < iterations; i++)
+    {
+      body ();
+    }
+  auto end = std::chrono::steady_clock::now ();
+  uint64_t allocations = GetAllocations () - allocationsBefore;
+
+  double elapsedNs = std::chrono::duration<double, std::nano> (end - start).count ();
+  double nsPerMessage = elapsedNs / iterations;
+  std::cout << std::left << std::setw (36) << name << std::right << std::fixed
+            << std::setprecision (0) << std::setw (14) << 1e9 / nsPerMessage << std::setw (14)
+            << nsPerMessage << std::setprecision (1) << std::setw (12)
+            << (double) allocations / iterations << std::endl;
+}
+
+/**
+* Create the measurement items of a UE
+*
+* \param ue the UE index
+* \param itemsPerUe the number of measurement items
+* \return the list of items
+*/
+static Ptr<MeasurementItemList>
+CreateUeItems (uint32_t ue, uint32_t itemsPerUe)
+{
+  Ptr<MeasurementItemList> ueItems = Create<MeasurementItemList> ("UE-" + std::to_string (ue));
+  for (uint32_t item = 0; item < itemsPerUe; item++)
+    {
+      if (item % 2 == 0)
+        {
+          ueItems->AddItem<long> ("Bench.IntKpi" + std::to_string (item) + ".UEID", ue + item);
+        }
+      else
+        {
+          ueItems->AddItem<double> ("Bench.RealKpi" + std::to_string (item) + ".UEID",
+                                    ue * 0.5 + item);
+        }
+    }
+  return ueItems;
+}
+
+/**
+* Encode a RIC Control Request with a E2SM-RC handover control message
+*
+* \param buffer filled with the encoded PDU
+*/
+static void
+EncodeRicControlRequest (Ptr<EncodeBuffer> buffer)
+{
+  // E2SM-RC Control Header
+  E2SM_RC_ControlHeader_t *header =
+      (E2SM_RC_ControlHeader_t *) calloc (1, sizeof (E2SM_RC_ControlHeader_t));
+  header->present = E2SM_RC_ControlHeader_PR_controlHeader_Format1;
+  header->choice.controlHeader_Format1 =
+      (E2SM_RC_ControlHeader_Format1_t *) calloc (1, sizeof (E2SM_RC_ControlHeader_Format1_t));
+  OCTET_STRING_fromBuf (&header->choice.controlHeader_Format1->ueId, "111000", -1);
+  header->choice.controlHeader_Format1->ric_ControlStyle_Type = 3;
+  header->choice.controlHeader_Format1->ric_ControlAction_ID = 1;
+  Ptr<EncodeBuffer> headerBuffer = Create<EncodeBuffer> ();
+  headerBuffer->Encode (&asn_DEF_E2SM_RC_ControlHeader, header);
+  ASN_STRUCT_FREE (asn_DEF_E2SM_RC_ControlHeader, header);
+
+  // E2SM-RC Control Message with the target cell CGI
+  E2SM_RC_ControlMessage_t *message =
+      (E2SM_RC_ControlMessage_t *) calloc (1, sizeof (E2SM_RC_ControlMessage_t));
+  message->present = E2SM_RC_ControlMessage_PR_controlMessage_Format1;
+  E2SM_RC_ControlMessage_Format1_t *format1 =
+      (E2SM_RC_ControlMessage_Format1_t *) calloc (1, sizeof (E2SM_RC_ControlMessage_Format1_t));
+  message->choice.controlMessage_Format1 = format1;
+  format1->ranParameters_List = (decltype (format1->ranParameters_List)) calloc (
+      1, sizeof (*format1->ranParameters_List));
+  RANParameter_Item_t *item = (RANParameter_Item_t *) calloc (1, sizeof (RANParameter_Item_t));
+  item->ranParameterItem_ID = 1;
+  item->ranParameterItem_valueType =
+      (RANParameter_ValueType_t *) calloc (1, sizeof (RANParameter_ValueType_t));
+  item->ranParameterItem_valueType->present = RANParameter_ValueType_PR_ranParameter_Element;
+  RANParameter_ELEMENT_t *element =
+      (RANParameter_ELEMENT_t *) calloc (1, sizeof (RANParameter_ELEMENT_t));
+  element->ranParameter_Value.present = RANParameter_Value_PR_valueOctS;
+  OCTET_STRING_fromBuf (&element->ranParameter_Value.choice.valueOctS, "1112", -1);
+  item->ranParameterItem_valueType->choice.ranParameter_Element = element;
+  ASN_SEQUENCE_ADD (&format1->ranParameters_List->list, item);
+  Ptr<EncodeBuffer> messageBuffer = Create<EncodeBuffer> ();
+  messageBuffer->Encode (&asn_DEF_E2SM_RC_ControlMessage, message);
+  ASN_STRUCT_FREE (asn_DEF_E2SM_RC_ControlMessage, message);
+
+  // E2AP RIC Control Request
+  E2AP_PDU_t *pdu = (E2AP_PDU_t *) calloc (1, sizeof (E2AP_PDU_t));
+  pdu->present = E2AP_PDU_PR_initiatingMessage;
+  InitiatingMessage_t *initiatingMessage =
+      (InitiatingMessage_t *) calloc (1, sizeof (InitiatingMessage_t));
+  pdu->choice.initiatingMessage = initiatingMessage;
+  initiatingMessage->procedureCode = ProcedureCode_id_RICcontrol;
+  initiatingMessage->criticality = Criticality_reject;
+  initiatingMessage->value.present = InitiatingMessage__value_PR_RICcontrolRequest;
+  RICcontrolRequest_t *request = &initiatingMessage->value.choice.RICcontrolRequest;
+
+  RICcontrolRequest_IEs_t *requestId =
+      (RICcontrolRequest_IEs_t *) calloc (1, sizeof (RICcontrolRequest_IEs_t));
+  requestId->id = ProtocolIE_ID_id_RICrequestID;
+  requestId->criticality = Criticality_reject;
+  requestId->value.present = RICcontrolRequest_IEs__value_PR_RICrequestID;
+  requestId->value.choice.RICrequestID.ricRequestorID = RicControlMessage::TS;
+  requestId->value.choice.RICrequestID.ricInstanceID = 1;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, requestId);
+
+  RICcontrolRequest_IEs_t *functionId =
+      (RICcontrolRequest_IEs_t *) calloc (1, sizeof (RICcontrolRequest_IEs_t));
+  functionId->id = ProtocolIE_ID_id_RANfunctionID;
+  functionId->criticality = Criticality_reject;
+  functionId->value.present = RICcontrolRequest_IEs__value_PR_RANfunctionID;
+  functionId->value.choice.RANfunctionID = 300;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, functionId);
+
+  RICcontrolRequest_IEs_t *controlHeader =
+      (RICcontrolRequest_IEs_t *) calloc (1, sizeof (RICcontrolRequest_IEs_t));
+  controlHeader->id = ProtocolIE_ID_id_RICcontrolHeader;
+  controlHeader->criticality = Criticality_reject;
+  controlHeader->value.present = RICcontrolRequest_IEs__value_PR_RICcontrolHeader;
+  OCTET_STRING_fromBuf (&controlHeader->value.choice.RICcontrolHeader,
+                        (const char *) headerBuffer->GetData (), headerBuffer->GetSize ());
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, controlHeader);
+
+  RICcontrolRequest_IEs_t *controlMessage =
+      (RICcontrolRequest_IEs_t *) calloc (1, sizeof (RICcontrolRequest_IEs_t));
+  controlMessage->id = ProtocolIE_ID_id_RICcontrolMessage;
+  controlMessage->criticality = Criticality_reject;
+  controlMessage->value.present = RICcontrolRequest_IEs__value_PR_RICcontrolMessage;
+  OCTET_STRING_fromBuf (&controlMessage->value.choice.RICcontrolMessage,
+                        (const char *) messageBuffer->GetData (), messageBuffer->GetSize ());
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, controlMessage);
+
+  buffer->Encode (&asn_DEF_E2AP_PDU, pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t ues = 50;
+  uint32_t itemsPerUe = 10;
+  uint32_t cells = 4;
+  uint32_t qcis = 4;
+  uint32_t iterations = 2000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("ues", "Number of UEs per indication message", ues);
+  cmd.AddValue ("itemsPerUe", "Number of measurement items per UE", itemsPerUe);
+  cmd.AddValue ("cells", "Number of cells in the O-DU container", cells);
+  cmd.AddValue ("qcis", "Number of QCI report items per served PLMN", qcis);
+  cmd.AddValue ("iterations", "Number of timed iterations per benchmark", iterations);
+  cmd.Parse (argc, argv);
+
+  std::cout << "UEs " << ues << ", items per UE " << itemsPerUe << ", cells " << cells
+            << ", QCIs " << qcis << ", iterations " << iterations << std::endl;
+  std::cout << std::left << std::setw (36) << "benchmark" << std::right << std::setw (14)
+            << "msg/s" << std::setw (14) << "ns/msg" << std::setw (12) << "allocs/msg"
+            << std::endl;
+
+  Ptr<EncodeBuffer> encodeBuffer = Create<EncodeBuffer> ();
+
+  // RIC Indication Header
+  KpmIndicationHeader::KpmRicIndicationHeaderValues headerValues;
+  headerValues.m_plmId = "111";
+  headerValues.m_gnbId = "1";
+  headerValues.m_nrCellId = 1;
+  uint64_t timestamp = 1630000000000;
+
+  RunBenchmark ("KpmIndicationHeader", iterations, [&] () {
+    headerValues.m_timestamp = timestamp++;
+    Create<KpmIndicationHeader> (KpmIndicationHeader::gNB, headerValues);
+  });
+  RunBenchmark ("KpmIndicationHeader (buffer)", iterations, [&] () {
+    headerValues.m_timestamp = timestamp++;
+    Create<KpmIndicationHeader> (KpmIndicationHeader::gNB, headerValues, encodeBuffer);
+  });
+
+  // UE-specific measurement items, shared by all the messages
+  OrderedPtrVector<MeasurementItemList, MeasurementItemList::Less> ueIndications;
+  ueIndications.reserve (ues);
+  for (uint32_t ue = 0; ue < ues; ue++)
+    {
+      ueIndications.insert (CreateUeItems (ue, itemsPerUe));
+    }
+
+  // O-CU-UP
+  KpmIndicationMessage::KpmIndicationMessageValues cuUpValues;
+  cuUpValues.m_cellObjectId = "NRCellCU";
+  Ptr<OCuUpContainerValues> cuUpContainer = Create<OCuUpContainerValues> ();
+  cuUpContainer->m_plmId = "111";
+  cuUpContainer->m_pDCPBytesUL = 123456;
+  cuUpContainer->m_pDCPBytesDL = 654321;
+  cuUpValues.m_pmContainerValues = cuUpContainer;
+  cuUpValues.m_ueIndications = ueIndications;
+
+  RunBenchmark ("KpmIndicationMessage CU-UP", iterations,
+                [&] () { Create<KpmIndicationMessage> (cuUpValues); });
+  RunBenchmark ("KpmIndicationMessage CU-UP (buffer)", iterations,
+                [&] () { Create<KpmIndicationMessage> (cuUpValues, encodeBuffer); });
+
+  // O-CU-CP
+  KpmIndicationMessage::KpmIndicationMessageValues cuCpValues;
+  cuCpValues.m_cellObjectId = "NRCellCU";
+  Ptr<OCuCpContainerValues> cuCpContainer = Create<OCuCpContainerValues> ();
+  cuCpContainer->m_numActiveUes = ues;
+  cuCpValues.m_pmContainerValues = cuCpContainer;
+  cuCpValues.m_cellMeasurementItems = Create<MeasurementItemList> ();
+  cuCpValues.m_cellMeasurementItems->AddItem<long> ("DRB.EstabSucc.5QI", ues);
+  cuCpValues.m_ueIndications = ueIndications;
+
+  RunBenchmark ("KpmIndicationMessage CU-CP", iterations,
+                [&] () { Create<KpmIndicationMessage> (cuCpValues); });
+  RunBenchmark ("KpmIndicationMessage CU-CP (buffer)", iterations,
+                [&] () { Create<KpmIndicationMessage> (cuCpValues, encodeBuffer); });
+
+  // O-DU
+  KpmIndicationMessage::KpmIndicationMessageValues duValues;
+  duValues.m_cellObjectId = "NRCellCU";
+  Ptr<ODuContainerValues> duContainer = Create<ODuContainerValues> ();
+  for (uint32_t cell = 0; cell < cells; cell++)
+    {
+      Ptr<CellResourceReport> cellReport = Create<CellResourceReport> ();
+      cellReport->m_plmId = "111";
+      cellReport->m_nrCellId = cell + 1;
+      cellReport->dlAvailablePrbs = 100;
+      cellReport->ulAvailablePrbs = 100;
+
+      Ptr<ServedPlmnPerCell> servedPlmn = Create<ServedPlmnPerCell> ();
+      servedPlmn->m_plmId = "111";
+      servedPlmn->m_nrCellId = cell + 1;
+      for (uint32_t qci = 0; qci < qcis; qci++)
+        {
+          Ptr<EpcDuPmContainer> qciReport = Create<EpcDuPmContainer> ();
+          qciReport->m_qci = qci + 1;
+          qciReport->m_dlPrbUsage = (qci * 10) % 100;
+          qciReport->m_ulPrbUsage = (qci * 5) % 100;
+          servedPlmn->m_perQciReportItems.insert (qciReport);
+        }
+      cellReport->m_servedPlmnPerCellItems.insert (servedPlmn);
+      duContainer->m_cellResourceReportItems.insert (cellReport);
+    }
+  duValues.m_pmContainerValues = duContainer;
+  duValues.m_ueIndications = ueIndications;
+
+  RunBenchmark ("KpmIndicationMessage DU", iterations,
+                [&] () { Create<KpmIndicationMessage> (duValues); });
+  RunBenchmark ("KpmIndicationMessage DU (buffer)", iterations,
+                [&] () { Create<KpmIndicationMessage> (duValues, encodeBuffer); });
+
+  // RIC Control Message, decoded from the APER bytes as received from the RIC
+  Ptr<EncodeBuffer> controlBuffer = Create<EncodeBuffer> ();
+  EncodeRicControlRequest (controlBuffer);
+
+  RunBenchmark ("RicControlMessage decode", iterations, [&] () {
+    E2AP_PDU_t *pdu = nullptr;
+    asn_dec_rval_t rval = aper_decode_complete (nullptr, &asn_DEF_E2AP_PDU, (void **) &pdu,
+                                                controlBuffer->GetData (),
+                                                controlBuffer->GetSize ());
+    if (rval.code != RC_OK)
+      {
+        NS_FATAL_ERROR ("Unable to decode the RIC Control Request");
+      }
+    Create<RicControlMessage> (pdu);
+    ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  });
+
+  RicControlDecodeArena controlArena;
+  RunBenchmark ("RicControlMessage decode (arena)", iterations, [&] () {
+    E2AP_PDU_t *pdu = nullptr;
+    asn_dec_rval_t rval = aper_decode_complete (nullptr, &asn_DEF_E2AP_PDU, (void **) &pdu,
+                                                controlBuffer->GetData (),
+                                                controlBuffer->GetSize ());
+    if (rval.code != RC_OK)
+      {
+        NS_FATAL_ERROR ("Unable to decode the RIC Control Request");
+      }
+    RicControlMessage message (pdu, controlArena);
+    controlArena.Reset ();
+    ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  });
+
+  // RAN parameter dispatch, with handlers registered for other actions too
+  Ptr<RicControlDispatcher> dispatcher = Create<RicControlDispatcher> ();
+  uint64_t targetCells = 0;
+  for (long actionId = 1; actionId <= 64; actionId++)
+    {
+      dispatcher->RegisterNrCgiHandler (
+          300, 3, actionId, 1,
+          [&targetCells] (const RicControlAction &, const NrCgi &cgi) {
+            targetCells += cgi.m_nrCellId;
+          });
+    }
+  E2AP_PDU_t *controlPdu = nullptr;
+  aper_decode_complete (nullptr, &asn_DEF_E2AP_PDU, (void **) &controlPdu,
+                        controlBuffer->GetData (), controlBuffer->GetSize ());
+  RicControlMessage controlMessage (controlPdu, controlArena);
+  RunBenchmark ("RicControlDispatcher dispatch", iterations,
+                [&] () { dispatcher->Dispatch (controlMessage); });
+  controlArena.Reset ();
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, controlPdu);
+
+  return 0;
+}
@@ -0,0 +1,1063 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include "ns3/core-module.h"
+#include "ns3/oran-interface.h"
+#include "ns3/kpm-encode-offload.h"
+#include "ns3/kpm-delta-filter.h"
+#include "ns3/kpm-trace-reader.h"
+#include "ns3/ric-request-inbox.h"
+#include "ns3/ran-parameter-walker.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+extern "C" {
+  #include "E2SM-KPM-IndicationHeader.h"
+  #include "E2SM-KPM-IndicationHeader-Format1.h"
+  #include "RICsubscriptionRequest.h"
+  #include "RICsubscriptionDeleteRequest.h"
+  #include "RICindication.h"
+  #include "RICactionType.h"
+  #include "ProtocolIE-Field.h"
+  #include "InitiatingMessage.h"
+  #include "E2SM-KPM-EventTriggerDefinition.h"
+  #include "E2SM-KPM-EventTriggerDefinition-Format1.h"
+  #include "Trigger-ConditionIE-Item.h"
+  #include "RT-Period-IE.h"
+}
+
+/**
+* \file
+* Focused checks of the building blocks of the module that run without a
+* RIC. The program aborts on the first failed check.
+*
+* Example:
+* ./ns3 run oran-interface-checks
+*/
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OranInterfaceChecks");
+
+/**
+* Create the values of an O-CU-CP indication message
+*
+* \param index the index of the message, changing the values
+* \return the values
+*/
+static KpmIndicationMessage::KpmIndicationMessageValues
+CreateCuCpValues (uint32_t index)
+{
+  KpmIndicationMessage::KpmIndicationMessageValues values;
+  values.m_cellObjectId = "NRCellCU";
+  Ptr<OCuCpContainerValues> container = Create<OCuCpContainerValues> ();
+  container->m_numActiveUes = index % 32;
+  values.m_pmContainerValues = container;
+  for (uint32_t ue = 0; ue < 8; ue++)
+    {
+      Ptr<MeasurementItemList> ueItems =
+          Create<MeasurementItemList> ("UE-" + std::to_string (ue));
+      ueItems->AddItem<long> ("Check.IntKpi.UEID", index + ue);
+      ueItems->AddItem<double> ("Check.RealKpi.UEID", index * 0.5 + ue);
+      values.m_ueIndications.insert (ueItems);
+    }
+  return values;
+}
+
+/**
+* Encode messages with several encoding threads and check that they are
+* emitted in order, with the content of a synchronous encoding, that the
+* submitter keeps no reference to the values and that the values come back
+* with no reference held by the workers
+*/
+static void
+CheckEncodeOffload ()
+{
+  const uint32_t jobs = 500;
+  std::vector<uint64_t> expected;
+  for (uint32_t i = 0; i < jobs; i++)
+    {
+      expected.push_back (Create<KpmIndicationMessage> (CreateCuCpValues (i))->GetContentHash ());
+    }
+
+  // the emission is serialized by the pool, the mutex only publishes the
+  // results to this thread
+  std::mutex mutex;
+  uint32_t emitted = 0;
+  bool ordered = true;
+  bool matching = true;
+  {
+    KpmEncodeOffload offload (
+        4, 16, [&] (const KpmEncodeOffload::Job &job, Ptr<KpmIndicationMessage> message) {
+          std::lock_guard<std::mutex> lock (mutex);
+          ordered = ordered && job.m_ranFunctionId == (long) emitted
+                    && job.m_header.size () == 1 && job.m_header[0] == (uint8_t) emitted;
+          matching = matching && message->GetContentHash () == expected[job.m_ranFunctionId];
+          emitted++;
+        });
+    NS_ABORT_MSG_UNLESS (offload.GetNThreads () == 4, "Wrong number of encoding threads");
+    std::vector<KpmIndicationMessage::KpmIndicationMessageValues> returned;
+    offload.CollectEmitted (returned);
+
+    for (uint32_t i = 0; i < jobs; i++)
+      {
+        const uint8_t header[] = {(uint8_t) i};
+        KpmIndicationMessage::KpmIndicationMessageValues values = CreateCuCpValues (i);
+        offload.Submit (Seconds (i), i, header, sizeof (header), std::move (values));
+        NS_ABORT_MSG_UNLESS (!values.m_pmContainerValues && values.m_ueIndications.empty (),
+                             "The values keep references after Submit");
+      }
+    offload.Flush ();
+
+    offload.CollectEmitted (returned);
+    NS_ABORT_MSG_UNLESS (returned.size () == jobs,
+                         "Got back " << returned.size () << " values out of " << jobs);
+    for (const auto &values : returned)
+      {
+        for (const auto &ueItems : values.m_ueIndications)
+          {
+            NS_ABORT_MSG_UNLESS (ueItems->GetReferenceCount () == 1,
+                                 "The values came back still referenced");
+          }
+      }
+  }
+
+  std::lock_guard<std::mutex> lock (mutex);
+  NS_ABORT_MSG_UNLESS (emitted == jobs, "Emitted " << emitted << " messages out of " << jobs);
+  NS_ABORT_MSG_UNLESS (ordered, "Messages emitted out of order");
+  NS_ABORT_MSG_UNLESS (matching, "Messages differ from the synchronous encoding");
+  NS_LOG_UNCOND ("KpmEncodeOffload: OK");
+}
+
+/**
+* Check that the headers patched from the cache decode to the expected
+* node and timestamp, and are byte for byte a fresh asn1c encoding of the
+* decoded header, for several node types, node IDs and timestamps
+*/
+static void
+CheckHeaderCache ()
+{
+  struct NodeKey
+  {
+    KpmIndicationHeader::GlobalE2nodeType m_nodeType;
+    std::string m_gnbId;
+    std::string m_plmId;
+    uint16_t m_nrCellId;
+  };
+  const std::vector<NodeKey> nodes = {{KpmIndicationHeader::gNB, "1", "111", 5},
+                                      {KpmIndicationHeader::gNB, "77", "222", 1},
+                                      {KpmIndicationHeader::eNB, "3", "111", 2},
+                                      {KpmIndicationHeader::ng_eNB, "12", "333", 9},
+                                      {KpmIndicationHeader::en_gNB, "5", "444", 7}};
+  const std::vector<uint64_t> timestamps = {0, 1, 1630068655325, 0x0123456789abcdef,
+                                            0xfedcba9876543210, UINT64_MAX};
+  const GlobalE2node_ID_PR expectedPresent[] = {
+      GlobalE2node_ID_PR_gNB, GlobalE2node_ID_PR_eNB, GlobalE2node_ID_PR_ng_eNB,
+      GlobalE2node_ID_PR_en_gNB};
+
+  KpmIndicationHeader::ClearCache ();
+  // the second round takes every header from the cache filled by the first
+  for (int round = 0; round < 2; round++)
+    {
+      for (const NodeKey &node : nodes)
+        {
+          for (uint64_t timestamp : timestamps)
+            {
+              KpmIndicationHeader::KpmRicIndicationHeaderValues values;
+              values.m_gnbId = node.m_gnbId;
+              values.m_plmId = node.m_plmId;
+              values.m_nrCellId = node.m_nrCellId;
+              values.m_timestamp = timestamp;
+              Ptr<KpmIndicationHeader> header =
+                  Create<KpmIndicationHeader> (node.m_nodeType, values);
+
+              E2SM_KPM_IndicationHeader_t *decoded = nullptr;
+              asn_dec_rval_t rval =
+                  aper_decode_complete (nullptr, &asn_DEF_E2SM_KPM_IndicationHeader,
+                                        (void **) &decoded, header->m_buffer, header->m_size);
+              NS_ABORT_MSG_UNLESS (rval.code == RC_OK,
+                                   "Unable to decode the header of GNB " << node.m_gnbId
+                                                                         << ", timestamp "
+                                                                         << timestamp);
+
+              const E2SM_KPM_IndicationHeader_Format1_t *format1 =
+                  decoded->choice.indicationHeader_Format1;
+              NS_ABORT_MSG_UNLESS (format1->id_GlobalE2node_ID.present
+                                       == expectedPresent[node.m_nodeType],
+                                   "Wrong node type in the header of GNB " << node.m_gnbId);
+              uint64_t bigEndianTimestamp = htobe64 (timestamp);
+              NS_ABORT_MSG_UNLESS (format1->collectionStartTime.size == sizeof (uint64_t)
+                                       && memcmp (format1->collectionStartTime.buf,
+                                                  &bigEndianTimestamp, sizeof (uint64_t)) == 0,
+                                   "Wrong timestamp in the header of GNB "
+                                       << node.m_gnbId << ", timestamp " << timestamp);
+
+              asn_encode_to_new_buffer_result_t fresh =
+                  asn_encode_to_new_buffer (nullptr, ATS_ALIGNED_BASIC_PER,
+                                            &asn_DEF_E2SM_KPM_IndicationHeader, decoded);
+              NS_ABORT_MSG_UNLESS (fresh.result.encoded >= 0, "Unable to encode the header");
+              NS_ABORT_MSG_UNLESS ((size_t) fresh.result.encoded == header->m_size
+                                       && memcmp (fresh.buffer, header->m_buffer,
+                                                  header->m_size) == 0,
+                                   "The patched header of GNB "
+                                       << node.m_gnbId << ", timestamp " << timestamp
+                                       << " differs from a fresh encoding");
+              free (fresh.buffer);
+              ASN_STRUCT_FREE (asn_DEF_E2SM_KPM_IndicationHeader, decoded);
+            }
+        }
+    }
+  KpmIndicationHeader::ClearCache ();
+  NS_LOG_UNCOND ("KpmIndicationHeader cache: OK");
+}
+
+/**
+* Create the measurements of a UE with three items, an integer, a real and
+* another integer
+*
+* \param ueId the ID of the UE
+* \param a the value of the first item
+* \param b the value of the second item
+* \param c the value of the third item
+* \return the measurements
+*/
+static Ptr<MeasurementItemList>
+CreateUeItems (const std::string &ueId, long a, double b, long c)
+{
+  Ptr<MeasurementItemList> items = Create<MeasurementItemList> (ueId);
+  items->AddItem<long> ("Check.A", a);
+  items->AddItem<double> ("Check.B", b);
+  items->AddItem<long> ("Check.C", c);
+  return items;
+}
+
+/**
+* Check that the delta filter removes the unchanged items and keeps the
+* others with their values, that only the committed reports are
+* remembered, that the released or idle UEs are forgotten, and that the
+* refreshes are complete
+*/
+static void
+CheckDeltaFilter ()
+{
+  Ptr<KpmDeltaFilter> filter = Create<KpmDeltaFilter> (0.5, 2);
+
+  // first report, complete
+  Ptr<MeasurementItemList> items = CreateUeItems ("111", 1, 2.0, 3);
+  NS_ABORT_MSG_UNLESS (filter->Filter ("111", items), "First report suppressed");
+  NS_ABORT_MSG_UNLESS (items->GetSize () == 3, "First report filtered");
+  filter->Commit ();
+
+  // the real item moved less than the threshold, the others are kept in
+  // their order and with their values
+  items = CreateUeItems ("111", 4, 2.2, 5);
+  NS_ABORT_MSG_UNLESS (filter->Filter ("111", items), "Changed report suppressed");
+  NS_ABORT_MSG_UNLESS (items->GetSize () == 2, "Expected 2 items, got " << items->GetSize ());
+  NS_ABORT_MSG_UNLESS (items->GetNameId (0) == KpiNameRegistry::Register ("Check.A")
+                           && items->GetValueType (0) == MeasurementValue_PR_valueInt
+                           && items->GetNumericValue (0) == 4,
+                       "First item not retained");
+  NS_ABORT_MSG_UNLESS (items->GetNameId (1) == KpiNameRegistry::Register ("Check.C")
+                           && items->GetValueType (1) == MeasurementValue_PR_valueInt
+                           && items->GetNumericValue (1) == 5,
+                       "Third item not retained");
+
+  // the report is not sent, so the next one compares with the first
+  filter->Discard ();
+  items = CreateUeItems ("111", 4, 2.0, 3);
+  NS_ABORT_MSG_UNLESS (filter->Filter ("111", items) && items->GetSize () == 1,
+                       "Discarded values remembered");
+  filter->Commit ();
+
+  // nothing changed, the UE is not reported
+  items = CreateUeItems ("111", 4, 2.0, 3);
+  NS_ABORT_MSG_IF (filter->Filter ("111", items), "Unchanged report not suppressed");
+  NS_ABORT_MSG_UNLESS (filter->GetSuppressedUes () == 1, "Suppressed UE not counted");
+  filter->Commit ();
+
+  // a released UE is reported completely again
+  filter->RemoveUe ("111");
+  items = CreateUeItems ("111", 4, 2.0, 3);
+  NS_ABORT_MSG_UNLESS (filter->Filter ("111", items) && items->GetSize () == 3,
+                       "Released UE remembered");
+  filter->Commit ();
+
+  // a UE absent from more than two reports is forgotten
+  for (int i = 0; i < 3; i++)
+    {
+      filter->Commit ();
+    }
+  NS_ABORT_MSG_UNLESS (filter->GetNUes () == 0, "Idle UE remembered");
+
+  // every third report after a sent refresh is complete; a refresh that
+  // is not sent is tried again at the next report
+  filter = Create<KpmDeltaFilter> (0, 0, 3);
+  for (int i = 0; i < 3; i++)
+    {
+      items = CreateUeItems ("222", 1, 2.0, 3);
+      NS_ABORT_MSG_UNLESS (filter->Filter ("222", items) == (i == 0),
+                           "Report " << i << " before the refresh not filtered");
+      filter->Commit ();
+    }
+  items = CreateUeItems ("222", 1, 2.0, 3);
+  NS_ABORT_MSG_UNLESS (filter->IsRefresh () && filter->Filter ("222", items)
+                           && items->GetSize () == 3,
+                       "Unchanged UE not refreshed");
+  filter->Discard ();
+  items = CreateUeItems ("222", 9, 2.0, 3);
+  NS_ABORT_MSG_UNLESS (filter->IsRefresh () && filter->Filter ("222", items)
+                           && items->GetSize () == 3,
+                       "Refresh not tried again");
+  filter->Commit ();
+  items = CreateUeItems ("222", 9, 2.0, 3);
+  NS_ABORT_MSG_IF (filter->IsRefresh () || filter->Filter ("222", items),
+                   "Report after the refresh not filtered");
+
+  NS_LOG_UNCOND ("KpmDeltaFilter: OK");
+}
+
+/**
+* Check that the records written by the trace writer, over several record
+* and dictionary blocks, are read back unchanged
+*
+* \param compression the compression of the blocks
+*/
+static void
+CheckTraceRoundTrip (KpmTraceWriter::Compression compression)
+{
+  std::string fileName = "oran-interface-checks.kpmt";
+  KpiNameRegistry::Id intKpi = KpiNameRegistry::Register ("Check.Trace.Int");
+  KpiNameRegistry::Id realKpi = KpiNameRegistry::Register ("Check.Trace.Real");
+  const uint32_t records = 50;
+  {
+    // three records per block, and a KPI first used halfway, so that the
+    // file interleaves dictionary and record blocks
+    KpmTraceWriter writer (fileName, compression, 3);
+    for (uint32_t i = 0; i < records; i++)
+      {
+        if (i % 2 == 0)
+          {
+            writer.Append (1000 + i, 7, i % 4, intKpi, (long) i * -3);
+          }
+        else if (i < records / 2)
+          {
+            writer.Append (1000 + i, 7, i % 4, intKpi, (long) i << 40);
+          }
+        else
+          {
+            writer.Append (1000 + i, 8, i % 4, realKpi, i / 7.0);
+          }
+      }
+    NS_ABORT_MSG_UNLESS (writer.GetNRecords () == records, "Records not counted");
+  }
+
+  KpmTraceReader reader (fileName);
+  NS_ABORT_MSG_UNLESS (reader.GetCompression () == compression, "Compression not read back");
+  KpmTraceReader::Record record;
+  uint32_t i = 0;
+  while (reader.Next (record))
+    {
+      NS_ABORT_MSG_UNLESS (record.m_timestamp == 1000 + i && record.m_ueId == i % 4,
+                           "Record " << i << " has the wrong key");
+      std::string name = reader.GetKpiName (record.m_kpi);
+      if (i % 2 == 0 || i < records / 2)
+        {
+          long value = i % 2 == 0 ? (long) i * -3 : (long) i << 40;
+          NS_ABORT_MSG_UNLESS (record.m_cellId == 7 && name == "Check.Trace.Int"
+                                   && record.m_type == MeasurementValue_PR_valueInt
+                                   && record.m_intValue == value,
+                               "Record " << i << " differs");
+        }
+      else
+        {
+          NS_ABORT_MSG_UNLESS (record.m_cellId == 8 && name == "Check.Trace.Real"
+                                   && record.m_type == MeasurementValue_PR_valueReal
+                                   && record.m_realValue == i / 7.0,
+                               "Record " << i << " differs");
+        }
+      i++;
+    }
+  NS_ABORT_MSG_UNLESS (i == records, "Read " << i << " records out of " << records);
+  std::remove (fileName.c_str ());
+  NS_LOG_UNCOND ("KpmTraceWriter, compression " << compression << ": OK");
+}
+
+/**
+* Create a RAN parameter of a given type
+*
+* \param id the RAN parameter ID
+* \param present the type of the RAN parameter
+* \return the RAN parameter, with an empty value
+*/
+static RANParameter_Item_t *
+NewRanParameter (long id, RANParameter_ValueType_PR present)
+{
+  auto item = (RANParameter_Item_t *) calloc (1, sizeof (RANParameter_Item_t));
+  item->ranParameterItem_ID = id;
+  item->ranParameterItem_valueType =
+      (RANParameter_ValueType_t *) calloc (1, sizeof (RANParameter_ValueType_t));
+  item->ranParameterItem_valueType->present = present;
+  switch (present)
+    {
+    case RANParameter_ValueType_PR_ranParameter_Element:
+      item->ranParameterItem_valueType->choice.ranParameter_Element =
+          (RANParameter_ELEMENT_t *) calloc (1, sizeof (RANParameter_ELEMENT_t));
+      break;
+    case RANParameter_ValueType_PR_ranParameter_Structure:
+      item->ranParameterItem_valueType->choice.ranParameter_Structure =
+          (RANParameter_STRUCTURE_t *) calloc (1, sizeof (RANParameter_STRUCTURE_t));
+      break;
+    case RANParameter_ValueType_PR_ranParameter_List:
+      item->ranParameterItem_valueType->choice.ranParameter_List =
+          (RANParameter_LIST_t *) calloc (1, sizeof (RANParameter_LIST_t));
+      break;
+    default:
+      break;
+    }
+  return item;
+}
+
+/**
+* Create a RAN parameter holding an integer
+*
+* \param id the RAN parameter ID
+* \param value the value
+* \return the RAN parameter
+*/
+static RANParameter_Item_t *
+NewIntRanParameter (long id, long value)
+{
+  RANParameter_Item_t *item = NewRanParameter (id, RANParameter_ValueType_PR_ranParameter_Element);
+  RANParameter_Value_t &ranParameterValue =
+      item->ranParameterItem_valueType->choice.ranParameter_Element->ranParameter_Value;
+  ranParameterValue.present = RANParameter_Value_PR_valueInt;
+  ranParameterValue.choice.valueInt = value;
+  return item;
+}
+
+/**
+* Append an entry to a RAN parameter list
+*
+* \param list the RAN parameter, of list type
+* \return the new entry
+*/
+static RANParameter_STRUCTURE_t *
+AddListEntry (RANParameter_Item_t *list)
+{
+  auto entry = (RANParameter_STRUCTURE_t *) calloc (1, sizeof (RANParameter_STRUCTURE_t));
+  ASN_SEQUENCE_ADD (
+      &list->ranParameterItem_valueType->choice.ranParameter_List->list_of_ranParameter.list,
+      entry);
+  return entry;
+}
+
+/**
+* Check that the RAN parameter walker visits every value of nested
+* structures and lists once, in order and with its path, skipping empty
+* structures, lists and list entries
+*/
+static void
+CheckRanParameterWalker ()
+{
+  // 1 = 10
+  // 2 { 3 = 30, 4 [ {5 = 50, 6 = "ab"}, {}, {7 []}, {5 = 51} ] }
+  // 8 []
+  // 9 {}
+  // 10 = 100
+  E2SM_RC_ControlMessage_Format1_t message;
+  memset (&message, 0, sizeof (message));
+  message.ranParameters_List =
+      (decltype (message.ranParameters_List)) calloc (1, sizeof (*message.ranParameters_List));
+  auto &parameters = message.ranParameters_List->list;
+
+  ASN_SEQUENCE_ADD (&parameters, NewIntRanParameter (1, 10));
+
+  RANParameter_Item_t *structure =
+      NewRanParameter (2, RANParameter_ValueType_PR_ranParameter_Structure);
+  auto &structureItems = structure->ranParameterItem_valueType->choice.ranParameter_Structure
+                             ->sequence_of_ranParameters.list;
+  ASN_SEQUENCE_ADD (&structureItems, NewIntRanParameter (3, 30));
+  RANParameter_Item_t *list = NewRanParameter (4, RANParameter_ValueType_PR_ranParameter_List);
+  RANParameter_STRUCTURE_t *entry = AddListEntry (list);
+  ASN_SEQUENCE_ADD (&entry->sequence_of_ranParameters.list, NewIntRanParameter (5, 50));
+  RANParameter_Item_t *octets = NewRanParameter (6, RANParameter_ValueType_PR_ranParameter_Element);
+  RANParameter_Value_t &octetsValue =
+      octets->ranParameterItem_valueType->choice.ranParameter_Element->ranParameter_Value;
+  octetsValue.present = RANParameter_Value_PR_valueOctS;
+  OCTET_STRING_fromBuf (&octetsValue.choice.valueOctS, "ab", 2);
+  ASN_SEQUENCE_ADD (&entry->sequence_of_ranParameters.list, octets);
+  AddListEntry (list);
+  entry = AddListEntry (list);
+  ASN_SEQUENCE_ADD (&entry->sequence_of_ranParameters.list,
+                    NewRanParameter (7, RANParameter_ValueType_PR_ranParameter_List));
+  entry = AddListEntry (list);
+  ASN_SEQUENCE_ADD (&entry->sequence_of_ranParameters.list, NewIntRanParameter (5, 51));
+  ASN_SEQUENCE_ADD (&structureItems, list);
+  ASN_SEQUENCE_ADD (&parameters, structure);
+
+  ASN_SEQUENCE_ADD (&parameters, NewRanParameter (8, RANParameter_ValueType_PR_ranParameter_List));
+  ASN_SEQUENCE_ADD (&parameters,
+                    NewRanParameter (9, RANParameter_ValueType_PR_ranParameter_Structure));
+  ASN_SEQUENCE_ADD (&parameters, NewIntRanParameter (10, 100));
+
+  // every value as path=value, with @ and the index for the list entries
+  std::ostringstream visited;
+  auto visitor = [&visited] (const std::vector<RanParameterPathElement> &path,
+                             const RanParameterView &value) {
+    for (const RanParameterPathElement &element : path)
+      {
+        visited << "/" << element.m_id;
+        if (element.m_listIndex >= 0)
+          {
+            visited << "@" << element.m_listIndex;
+          }
+      }
+    NS_ABORT_MSG_UNLESS (value.m_id == path.back ().m_id, "Value not at the end of its path");
+    if (value.m_valueType == RANParameterItem::ValueType::Int)
+      {
+        visited << "=" << value.m_valueInt << " ";
+      }
+    else if (value.m_valueType == RANParameterItem::ValueType::OctectString)
+      {
+        visited << "=" << std::string ((const char *) value.m_valueBuf, value.m_valueSize) << " ";
+      }
+  };
+  const std::string expected = "/1=10 /2/3=30 /2/4/5@0=50 /2/4/6@0=ab /2/4/5@3=51 /10=100 ";
+
+  // the walker keeps its stack across walks, so the second walk of the
+  // same message must not see anything left by the first one
+  RanParameterWalker walker;
+  for (int walk = 0; walk < 2; walk++)
+    {
+      visited.str ("");
+      walker.Walk (&message, visitor);
+      NS_ABORT_MSG_UNLESS (visited.str () == expected, "Walk " << walk << " visited "
+                                                               << visited.str () << "instead of "
+                                                               << expected);
+    }
+
+  visited.str ("");
+  walker.Walk (list, visitor);
+  NS_ABORT_MSG_UNLESS (visited.str () == "/4/5@0=50 /4/6@0=ab /4/5@3=51 ",
+                       "Walk of a list visited " << visited.str ());
+
+  // the empty list 8 and the empty structure 9
+  for (int i = 2; i < 4; i++)
+    {
+      visited.str ("");
+      walker.Walk (parameters.array[i], visitor);
+      NS_ABORT_MSG_UNLESS (visited.str ().empty (), "Walk of an empty parameter visited "
+                                                        << visited.str ());
+    }
+
+  ASN_STRUCT_FREE_CONTENTS_ONLY (asn_DEF_E2SM_RC_ControlMessage_Format1, &message);
+  NS_LOG_UNCOND ("RanParameterWalker: OK");
+}
+
+/**
+* Check that the RIC request inbox drops the requests it has no room for,
+* and that it neither delivers nor leaks the pending ones once closed or
+* destroyed
+*/
+static void
+CheckRicRequestInbox ()
+{
+  std::vector<long> delivered;
+  auto deliver = [&delivered] (const RicRequestInbox::Request &request) {
+    delivered.push_back (request.m_ranFunctionId);
+  };
+  auto newPdu = [] () { return (E2AP_PDU_t *) calloc (1, sizeof (E2AP_PDU_t)); };
+
+  // full inbox: the third request waits for the timeout and is dropped
+  auto inbox = std::make_shared<RicRequestInbox> (2, MilliSeconds (10), deliver);
+  NS_ABORT_MSG_UNLESS (inbox->Post (RicRequestInbox::CONTROL, 1, newPdu ()),
+                       "First request refused");
+  NS_ABORT_MSG_UNLESS (inbox->Post (RicRequestInbox::CONTROL, 2, newPdu ()),
+                       "Second request refused");
+  NS_ABORT_MSG_IF (inbox->Post (RicRequestInbox::CONTROL, 3, newPdu ()),
+                   "Request accepted by a full inbox");
+  NS_ABORT_MSG_UNLESS (inbox->GetDroppedRequests () == 1, "Dropped request not counted");
+  Simulator::Run ();
+  NS_ABORT_MSG_UNLESS (delivered == std::vector<long> ({1, 2}), "Requests not delivered in order");
+
+  // closed inbox: the pending requests are released, the new ones dropped
+  NS_ABORT_MSG_UNLESS (inbox->Post (RicRequestInbox::CONTROL, 4, newPdu ()),
+                       "Request refused by an empty inbox");
+  inbox->Close ();
+  NS_ABORT_MSG_IF (inbox->Post (RicRequestInbox::CONTROL, 5, newPdu ()),
+                   "Request accepted by a closed inbox");
+  Simulator::Run ();
+  NS_ABORT_MSG_UNLESS (delivered.size () == 2, "Request delivered by a closed inbox");
+  NS_ABORT_MSG_UNLESS (inbox->GetDroppedRequests () == 2, "Dropped request not counted");
+
+  // destroyed inbox: its pending drain event does nothing
+  inbox = std::make_shared<RicRequestInbox> (2, MilliSeconds (10), deliver);
+  inbox->Post (RicRequestInbox::SUBSCRIPTION, 6, newPdu ());
+  inbox.reset ();
+  Simulator::Run ();
+  NS_ABORT_MSG_UNLESS (delivered.size () == 2, "Request delivered by a destroyed inbox");
+
+  Simulator::Destroy ();
+  NS_LOG_UNCOND ("RicRequestInbox: OK");
+}
+
+/**
+* Create a RIC Subscription Request
+*
+* \param requestorId RIC Requestor ID
+* \param instanceId RIC Instance ID
+* \param ranFunctionId RAN Function ID
+* \param period the RT-Period-IE of the event trigger, or -1 for none
+* \param actions the ID and type of each action
+* \return the request, to be released with ASN_STRUCT_FREE
+*/
+static E2AP_PDU_t *
+CreateSubscriptionRequest (uint16_t requestorId, uint16_t instanceId, uint16_t ranFunctionId,
+                           long period, const std::vector<std::pair<long, long>> &actions)
+{
+  E2AP_PDU_t *pdu = (E2AP_PDU_t *) calloc (1, sizeof (E2AP_PDU_t));
+  pdu->present = E2AP_PDU_PR_initiatingMessage;
+  pdu->choice.initiatingMessage = (InitiatingMessage_t *) calloc (1, sizeof (InitiatingMessage_t));
+  pdu->choice.initiatingMessage->procedureCode = ProcedureCode_id_RICsubscription;
+  pdu->choice.initiatingMessage->criticality = Criticality_reject;
+  pdu->choice.initiatingMessage->value.present = InitiatingMessage__value_PR_RICsubscriptionRequest;
+  RICsubscriptionRequest_t *request =
+      &pdu->choice.initiatingMessage->value.choice.RICsubscriptionRequest;
+
+  RICsubscriptionRequest_IEs_t *requestIdIe =
+      (RICsubscriptionRequest_IEs_t *) calloc (1, sizeof (RICsubscriptionRequest_IEs_t));
+  requestIdIe->id = ProtocolIE_ID_id_RICrequestID;
+  requestIdIe->criticality = Criticality_reject;
+  requestIdIe->value.present = RICsubscriptionRequest_IEs__value_PR_RICrequestID;
+  requestIdIe->value.choice.RICrequestID.ricRequestorID = requestorId;
+  requestIdIe->value.choice.RICrequestID.ricInstanceID = instanceId;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, requestIdIe);
+
+  RICsubscriptionRequest_IEs_t *ranFunctionIdIe =
+      (RICsubscriptionRequest_IEs_t *) calloc (1, sizeof (RICsubscriptionRequest_IEs_t));
+  ranFunctionIdIe->id = ProtocolIE_ID_id_RANfunctionID;
+  ranFunctionIdIe->criticality = Criticality_reject;
+  ranFunctionIdIe->value.present = RICsubscriptionRequest_IEs__value_PR_RANfunctionID;
+  ranFunctionIdIe->value.choice.RANfunctionID = ranFunctionId;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, ranFunctionIdIe);
+
+  RICsubscriptionRequest_IEs_t *detailsIe =
+      (RICsubscriptionRequest_IEs_t *) calloc (1, sizeof (RICsubscriptionRequest_IEs_t));
+  detailsIe->id = ProtocolIE_ID_id_RICsubscriptionDetails;
+  detailsIe->criticality = Criticality_reject;
+  detailsIe->value.present = RICsubscriptionRequest_IEs__value_PR_RICsubscriptionDetails;
+  RICsubscriptionDetails_t *details = &detailsIe->value.choice.RICsubscriptionDetails;
+
+  // E2SM-KPM Event Trigger Definition with a single reporting period
+  E2SM_KPM_EventTriggerDefinition_t *trigger = (E2SM_KPM_EventTriggerDefinition_t *) calloc (
+      1, sizeof (E2SM_KPM_EventTriggerDefinition_t));
+  trigger->present = E2SM_KPM_EventTriggerDefinition_PR_eventDefinition_Format1;
+  trigger->choice.eventDefinition_Format1 = (E2SM_KPM_EventTriggerDefinition_Format1_t *) calloc (
+      1, sizeof (E2SM_KPM_EventTriggerDefinition_Format1_t));
+  if (period >= 0)
+    {
+      E2SM_KPM_EventTriggerDefinition_Format1_t *format1 = trigger->choice.eventDefinition_Format1;
+      format1->policyTest_List = (decltype (format1->policyTest_List)) calloc (
+          1, sizeof (*format1->policyTest_List));
+      Trigger_ConditionIE_Item_t *condition =
+          (Trigger_ConditionIE_Item_t *) calloc (1, sizeof (Trigger_ConditionIE_Item_t));
+      condition->report_Period_IE = period;
+      ASN_SEQUENCE_ADD (&format1->policyTest_List->list, condition);
+    }
+  Ptr<EncodeBuffer> buffer = Create<EncodeBuffer> ();
+  size_t size = buffer->Encode (&asn_DEF_E2SM_KPM_EventTriggerDefinition, trigger);
+  OCTET_STRING_fromBuf (&details->ricEventTriggerDefinition, (const char *) buffer->GetData (),
+                        size);
+  ASN_STRUCT_FREE (asn_DEF_E2SM_KPM_EventTriggerDefinition, trigger);
+
+  for (auto &action : actions)
+    {
+      RICaction_ToBeSetup_ItemIEs_t *actionIe =
+          (RICaction_ToBeSetup_ItemIEs_t *) calloc (1, sizeof (RICaction_ToBeSetup_ItemIEs_t));
+      actionIe->id = ProtocolIE_ID_id_RICaction_ToBeSetup_Item;
+      actionIe->criticality = Criticality_ignore;
+      actionIe->value.present = RICaction_ToBeSetup_ItemIEs__value_PR_RICaction_ToBeSetup_Item;
+      actionIe->value.choice.RICaction_ToBeSetup_Item.ricActionID = action.first;
+      actionIe->value.choice.RICaction_ToBeSetup_Item.ricActionType = action.second;
+      ASN_SEQUENCE_ADD (&details->ricAction_ToBeSetup_List.list, actionIe);
+    }
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, detailsIe);
+  return pdu;
+}
+
+/**
+* Create a RIC Subscription Delete Request
+*
+* \param requestorId RIC Requestor ID
+* \param instanceId RIC Instance ID
+* \param ranFunctionId RAN Function ID
+* \return the request, to be released with ASN_STRUCT_FREE
+*/
+static E2AP_PDU_t *
+CreateSubscriptionDeleteRequest (uint16_t requestorId, uint16_t instanceId,
+                                 uint16_t ranFunctionId)
+{
+  E2AP_PDU_t *pdu = (E2AP_PDU_t *) calloc (1, sizeof (E2AP_PDU_t));
+  pdu->present = E2AP_PDU_PR_initiatingMessage;
+  pdu->choice.initiatingMessage = (InitiatingMessage_t *) calloc (1, sizeof (InitiatingMessage_t));
+  pdu->choice.initiatingMessage->procedureCode = ProcedureCode_id_RICsubscriptionDelete;
+  pdu->choice.initiatingMessage->criticality = Criticality_reject;
+  pdu->choice.initiatingMessage->value.present =
+      InitiatingMessage__value_PR_RICsubscriptionDeleteRequest;
+  RICsubscriptionDeleteRequest_t *request =
+      &pdu->choice.initiatingMessage->value.choice.RICsubscriptionDeleteRequest;
+
+  RICsubscriptionDeleteRequest_IEs_t *requestIdIe =
+      (RICsubscriptionDeleteRequest_IEs_t *) calloc (1,
+                                                     sizeof (RICsubscriptionDeleteRequest_IEs_t));
+  requestIdIe->id = ProtocolIE_ID_id_RICrequestID;
+  requestIdIe->criticality = Criticality_reject;
+  requestIdIe->value.present = RICsubscriptionDeleteRequest_IEs__value_PR_RICrequestID;
+  requestIdIe->value.choice.RICrequestID.ricRequestorID = requestorId;
+  requestIdIe->value.choice.RICrequestID.ricInstanceID = instanceId;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, requestIdIe);
+
+  RICsubscriptionDeleteRequest_IEs_t *ranFunctionIdIe =
+      (RICsubscriptionDeleteRequest_IEs_t *) calloc (1,
+                                                     sizeof (RICsubscriptionDeleteRequest_IEs_t));
+  ranFunctionIdIe->id = ProtocolIE_ID_id_RANfunctionID;
+  ranFunctionIdIe->criticality = Criticality_reject;
+  ranFunctionIdIe->value.present = RICsubscriptionDeleteRequest_IEs__value_PR_RANfunctionID;
+  ranFunctionIdIe->value.choice.RANfunctionID = ranFunctionId;
+  ASN_SEQUENCE_ADD (&request->protocolIEs.list, ranFunctionIdIe);
+  return pdu;
+}
+
+/**
+* Read the RIC Indications of a file written by E2PduRecorder
+*
+* \param fileName the name of the file
+* \return each indication as requestor/instance/function:action#SN
+*/
+static std::vector<std::string>
+ReadRecordedIndications (const std::string &fileName)
+{
+  std::ifstream file (fileName, std::ios::binary);
+  std::vector<uint8_t> data ((std::istreambuf_iterator<char> (file)),
+                             std::istreambuf_iterator<char> ());
+  std::vector<std::string> indications;
+  size_t offset = E2PduRecorder::FILE_HEADER_SIZE;
+  while (offset + E2PduRecorder::RECORD_HEADER_SIZE <= data.size ())
+    {
+      // the length follows the timestamp, little-endian
+      const uint8_t *length = data.data () + offset + 8;
+      size_t size = length[0] | length[1] << 8 | length[2] << 16 | (size_t) length[3] << 24;
+      offset += E2PduRecorder::RECORD_HEADER_SIZE;
+      NS_ABORT_MSG_IF (offset + size > data.size (), "Truncated record");
+
+      E2AP_PDU_t *pdu = nullptr;
+      asn_dec_rval_t rval = asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU,
+                                        (void **) &pdu, data.data () + offset, size);
+      NS_ABORT_MSG_UNLESS (rval.code == RC_OK && pdu->present == E2AP_PDU_PR_initiatingMessage
+                               && pdu->choice.initiatingMessage->value.present
+                                      == InitiatingMessage__value_PR_RICindication,
+                           "Recorded PDU is not a RIC Indication");
+      RICindication_t *indication = &pdu->choice.initiatingMessage->value.choice.RICindication;
+      long requestorId = -1, instanceId = -1, ranFunctionId = -1, actionId = -1, sn = -1;
+      for (int i = 0; i < indication->protocolIEs.list.count; i++)
+        {
+          RICindication_IEs_t *ie = indication->protocolIEs.list.array[i];
+          switch (ie->value.present)
+            {
+            case RICindication_IEs__value_PR_RICrequestID:
+              requestorId = ie->value.choice.RICrequestID.ricRequestorID;
+              instanceId = ie->value.choice.RICrequestID.ricInstanceID;
+              break;
+            case RICindication_IEs__value_PR_RANfunctionID:
+              ranFunctionId = ie->value.choice.RANfunctionID;
+              break;
+            case RICindication_IEs__value_PR_RICactionID:
+              actionId = ie->value.choice.RICactionID;
+              break;
+            case RICindication_IEs__value_PR_RICindicationSN:
+              sn = ie->value.choice.RICindicationSN;
+              break;
+            default:
+              break;
+            }
+        }
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+
+      std::ostringstream oss;
+      oss << requestorId << "/" << instanceId << "/" << ranFunctionId << ":" << actionId << "#"
+          << sn;
+      indications.push_back (oss.str ());
+      offset += size;
+    }
+  return indications;
+}
+
+/**
+* Create an E2 termination that is never started, whose PDUs are only
+* recorded
+*
+* \param fileName the record file
+* \return the termination
+*/
+static Ptr<E2Termination>
+CreateOfflineTermination (const std::string &fileName)
+{
+  Ptr<E2Termination> termination =
+      CreateObject<E2Termination> ("127.0.0.1", 36422, 38472, "1", "111");
+  termination->SetAttribute ("TransportMode", EnumValue (E2Termination::REACTOR));
+  termination->EnablePduRecording (fileName);
+  return termination;
+}
+
+/**
+* Check the subscription table: several accepted actions, refused
+* subscriptions, replacement of a subscription with the same key, delete
+* of known and unknown subscriptions and wrap of the RIC Indication SN of
+* each action
+*/
+static void
+CheckRicSubscriptions ()
+{
+  std::string fileName = "oran-interface-checks.e2rc";
+  Ptr<E2Termination> termination = CreateOfflineTermination (fileName);
+  const uint8_t header[] = {1, 2, 3};
+  const uint8_t message[] = {4, 5, 6, 7};
+
+  // the POLICY action is not admitted
+  E2AP_PDU_t *pdu = CreateSubscriptionRequest (
+      1, 1, 200, -1,
+      {{1, RICactionType_report}, {2, RICactionType_policy}, {3, RICactionType_insert}});
+  E2Termination::RicSubscriptionRequest_rval_s params =
+      termination->ProcessRicSubscriptionRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  NS_ABORT_MSG_UNLESS (params.accepted && params.actionId == 1, "Subscription 1/1 refused");
+  std::shared_ptr<const E2Termination::RicSubscription> subscription =
+      termination->GetSubscription (1, 1, 200);
+  NS_ABORT_MSG_UNLESS (subscription && subscription->actions.size () == 2
+                           && subscription->actions[0].actionId == 1
+                           && subscription->actions[1].actionId == 3,
+                       "Accepted actions of subscription 1/1 not stored");
+
+  // no action admitted: a failure, told apart from an accepted action 0
+  pdu = CreateSubscriptionRequest (1, 2, 200, -1, {{0, RICactionType_policy}});
+  params = termination->ProcessRicSubscriptionRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  NS_ABORT_MSG_IF (params.accepted, "Subscription 1/2 without admitted actions accepted");
+  NS_ABORT_MSG_IF (termination->GetSubscription (1, 2, 200), "Refused subscription stored");
+
+  pdu = CreateSubscriptionRequest (2, 1, 200, -1, {{0, RICactionType_report}});
+  params = termination->ProcessRicSubscriptionRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  NS_ABORT_MSG_UNLESS (params.accepted && params.actionId == 0, "Subscription 2/1 refused");
+  NS_ABORT_MSG_UNLESS (termination->GetNSubscriptions () == 2, "Subscriptions not counted");
+
+  // same key: the subscription is replaced, and moves to the end
+  pdu = CreateSubscriptionRequest (1, 1, 200, -1, {{5, RICactionType_report}});
+  termination->ProcessRicSubscriptionRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  std::vector<std::shared_ptr<const E2Termination::RicSubscription>> subscriptions =
+      termination->GetSubscriptions (200);
+  NS_ABORT_MSG_UNLESS (termination->GetNSubscriptions () == 2 && subscriptions.size () == 2
+                           && subscriptions[0]->requestorId == 2
+                           && subscriptions[1]->requestorId == 1
+                           && subscriptions[1]->actions.size () == 1
+                           && subscriptions[1]->actions[0].actionId == 5,
+                       "Subscription 1/1 not replaced");
+
+  // the SN of each action wraps from 65535 to 0
+  subscriptions[0]->actions[0].indicationSn = 65534;
+  for (int i = 0; i < 3; i++)
+    {
+      NS_ABORT_MSG_UNLESS (termination->SendIndicationToSubscription (params, header,
+                                                                      sizeof (header), message,
+                                                                      sizeof (message)) == 1,
+                           "Indication to subscription 2/1 not sent");
+    }
+  NS_ABORT_MSG_UNLESS (termination->SendIndicationToSubscribers (200, header, sizeof (header),
+                                                                 message, sizeof (message)) == 2,
+                       "Indication to the subscribers not sent");
+
+  // deleting a known and an unknown subscription
+  pdu = CreateSubscriptionDeleteRequest (1, 1, 200);
+  termination->ProcessRicSubscriptionDeleteRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  NS_ABORT_MSG_UNLESS (termination->GetNSubscriptions () == 1
+                           && !termination->GetSubscription (1, 1, 200),
+                       "Subscription 1/1 not deleted");
+  pdu = CreateSubscriptionDeleteRequest (9, 9, 200);
+  termination->ProcessRicSubscriptionDeleteRequest (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+  NS_ABORT_MSG_UNLESS (termination->GetNSubscriptions () == 1, "Unknown subscription deleted");
+  NS_ABORT_MSG_UNLESS (termination->SendIndicationToSubscribers (200, header, sizeof (header),
+                                                                 message, sizeof (message)) == 1,
+                       "Indication sent to a deleted subscription");
+
+  termination->DisablePduRecording ();
+  std::vector<std::string> expected = {"2/1/200:0#65534", "2/1/200:0#65535", "2/1/200:0#0",
+                                       "2/1/200:0#1",     "1/1/200:5#0",     "2/1/200:0#2"};
+  NS_ABORT_MSG_UNLESS (ReadRecordedIndications (fileName) == expected,
+                       "Unexpected RIC Indications sent");
+  std::remove (fileName.c_str ());
+  NS_LOG_UNCOND ("RicSubscriptions: OK");
+}
+
+/**
+* Termination used by the report callback of CheckReportSchedule
+*/
+static Ptr<E2Termination> g_reportTermination;
+
+/**
+* Reports built by the report callback of CheckReportSchedule, as
+* requestor@time in ms
+*/
+static std::vector<std::string> g_reports;
+
+/**
+* Report callback of CheckReportSchedule, sending a RIC Indication to the
+* subscription only
+*
+* \param params the subscription
+*/
+static void
+SendCheckReport (E2Termination::RicSubscriptionRequest_rval_s params)
+{
+  const uint8_t header[] = {1};
+  const uint8_t message[] = {2};
+  NS_ABORT_MSG_UNLESS (g_reportTermination->SendIndicationToSubscription (
+                           params, header, sizeof (header), message, sizeof (message)) == 1,
+                       "Report of subscription " << params.requestorId << " not sent");
+  std::ostringstream oss;
+  oss << params.requestorId << "@" << Simulator::Now ().GetMilliSeconds ();
+  g_reports.push_back (oss.str ());
+}
+
+/**
+* Process a subscription request, or a delete request, and release it
+*
+* \param pdu the request
+*/
+static void
+ProcessCheckRequest (E2AP_PDU_t *pdu)
+{
+  if (pdu->choice.initiatingMessage->procedureCode == ProcedureCode_id_RICsubscription)
+    {
+      g_reportTermination->ProcessRicSubscriptionRequest (pdu);
+    }
+  else
+    {
+      g_reportTermination->ProcessRicSubscriptionDeleteRequest (pdu);
+    }
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+}
+
+/**
+* Check that the periodic reports follow the period of each subscription,
+* restart with the new period when a subscription is replaced, stop when
+* the subscription is deleted, and only reach their own subscription
+*/
+static void
+CheckReportSchedule ()
+{
+  std::string fileName = "oran-interface-checks.e2rc";
+  g_reportTermination = CreateOfflineTermination (fileName);
+  g_reportTermination->RegisterReportCallback (200, MakeCallback (&SendCheckReport));
+
+  // 1 every 10 ms, then every 40 ms from 35 ms; 2 every 20 ms until 90 ms;
+  // 3 has no reporting period
+  Simulator::Schedule (MilliSeconds (0), &ProcessCheckRequest,
+                       CreateSubscriptionRequest (1, 1, 200, RT_Period_IE_ms10,
+                                                  {{1, RICactionType_report}}));
+  Simulator::Schedule (MilliSeconds (0), &ProcessCheckRequest,
+                       CreateSubscriptionRequest (2, 1, 200, RT_Period_IE_ms20,
+                                                  {{1, RICactionType_report}}));
+  Simulator::Schedule (MilliSeconds (0), &ProcessCheckRequest,
+                       CreateSubscriptionRequest (3, 1, 200, -1, {{1, RICactionType_report}}));
+  Simulator::Schedule (MilliSeconds (35), &ProcessCheckRequest,
+                       CreateSubscriptionRequest (1, 1, 200, RT_Period_IE_ms40,
+                                                  {{1, RICactionType_report}}));
+  Simulator::Schedule (MilliSeconds (90), &ProcessCheckRequest,
+                       CreateSubscriptionDeleteRequest (2, 1, 200));
+  Simulator::Stop (MilliSeconds (130));
+  Simulator::Run ();
+
+  std::vector<std::string> expected = {"1@10", "1@20", "2@20", "1@30", "2@40",
+                                       "2@60", "1@75", "2@80", "1@115"};
+  std::sort (g_reports.begin (), g_reports.end (), [] (const std::string &a, const std::string &b) {
+    auto time = [] (const std::string &report) { return std::stoi (report.substr (2)); };
+    return time (a) < time (b) || (time (a) == time (b) && a < b);
+  });
+  NS_ABORT_MSG_UNLESS (g_reports == expected, "Unexpected reports");
+
+  // each report reached its own subscription only, with the SN of the
+  // replaced subscription starting over
+  g_reportTermination->DisablePduRecording ();
+  std::vector<std::string> indications = ReadRecordedIndications (fileName);
+  std::vector<std::string> expectedIndications;
+  std::map<std::string, uint32_t> sn;
+  for (const std::string &report : expected)
+    {
+      std::string requestor = report.substr (0, 1);
+      if (report == "1@75")
+        {
+          sn[requestor] = 0;
+        }
+      expectedIndications.push_back (requestor + "/1/200:1#" + std::to_string (sn[requestor]++));
+    }
+  std::sort (indications.begin (), indications.end ());
+  std::sort (expectedIndications.begin (), expectedIndications.end ());
+  NS_ABORT_MSG_UNLESS (indications == expectedIndications, "Reports sent to other subscriptions");
+  std::remove (fileName.c_str ());
+
+  Simulator::Destroy ();
+  g_reportTermination = nullptr;
+  g_reports.clear ();
+  NS_LOG_UNCOND ("ReportSchedule: OK");
+}
+
+int
+main (int argc, char *argv[])
+{
+  CommandLine cmd (__FILE__);
+  cmd.Parse (argc, argv);
+
+  CheckEncodeOffload ();
+  CheckHeaderCache ();
+  CheckDeltaFilter ();
+  CheckTraceRoundTrip (KpmTraceWriter::NONE);
+  if (KpmTraceWriter::IsZstdSupported ())
+    {
+      CheckTraceRoundTrip (KpmTraceWriter::ZSTD);
+    }
+  CheckRanParameterWalker ();
+  CheckRicRequestInbox ();
+  CheckRicSubscriptions ();
+  CheckReportSchedule ();
+
+  return 0;
+}
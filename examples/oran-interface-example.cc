@@ -48,7 +48,10 @@ static void BuildAndSendReportMessage (E2Termination::RicSubscriptionRequest_rva
   headerValues.m_gnbId = cellId;
   headerValues.m_nrCellId = cellId;
 
-  Ptr<KpmIndicationHeader> header = Create<KpmIndicationHeader> (KpmIndicationHeader::GlobalE2nodeType::gNB, headerValues);
+  // encode into the scratch buffers of the termination to avoid
+  // allocating a new buffer for every report
+  Ptr<KpmIndicationHeader> header = Create<KpmIndicationHeader> (KpmIndicationHeader::GlobalE2nodeType::gNB, headerValues,
+                                                                 e2Term->GetHeaderEncodeBuffer ());
   
   KpmIndicationMessage::KpmIndicationMessageValues msgValues;
   
@@ -76,9 +79,10 @@ static void BuildAndSendReportMessage (E2Termination::RicSubscriptionRequest_rva
   ue1DummyValues->AddItem<double> ("DRB.IPLateDl.UEID", 11.0);
   msgValues.m_ueIndications.insert (ue1DummyValues);
   
-  Ptr<KpmIndicationMessage> msg = Create<KpmIndicationMessage> (msgValues);
+  Ptr<KpmIndicationMessage> msg = Create<KpmIndicationMessage> (msgValues, e2Term->GetMessageEncodeBuffer ());
   
-  E2AP_PDU *pdu_cuup_ue = new E2AP_PDU;	
+  // the PDU is released by the termination once sent
+  E2AP_PDU *pdu_cuup_ue = (E2AP_PDU *) calloc (1, sizeof (E2AP_PDU));
   encoding::generate_e2apv1_indication_request_parameterized(pdu_cuup_ue, 
                                                              params.requestorId,
                                                              params.instanceId,
@@ -89,8 +93,7 @@ static void BuildAndSendReportMessage (E2Termination::RicSubscriptionRequest_rva
                                                              header->m_size, // size of the encoded header
                                                              (uint8_t*) msg->m_buffer, // buffer containing the encoded message
                                                              msg->m_size); // size of the encoded message  
-  e2Term->SendE2Message (pdu_cuup_ue);
-  delete pdu_cuup_ue;
+  e2Term->QueueE2Message (pdu_cuup_ue);
   
 }
 
@@ -106,6 +109,12 @@ static void KpmSubscriptionCallback (E2AP_PDU_t* sub_req_pdu)
   NS_LOG_UNCOND ("\n\nReceived RIC Subscription Request");
   
   E2Termination::RicSubscriptionRequest_rval_s params = e2Term->ProcessRicSubscriptionRequest (sub_req_pdu);
+  if (!params.accepted)
+    {
+      // no action was accepted, and a RIC Subscription Failure was sent
+      NS_LOG_UNCOND ("RIC Subscription Request refused");
+      return;
+    }
   NS_LOG_UNCOND ("requestorId " << +params.requestorId << 
                  ", instanceId " << +params.instanceId << 
                  ", ranFuncionId " << +params.ranFuncionId << 
@@ -151,6 +160,7 @@ main (int argc, char *argv[])
     params.instanceId = 1;
     params.ranFuncionId = 2;
     params.requestorId = 1;
+    params.accepted = true;
     BuildAndSendReportMessage (params);
   }
 
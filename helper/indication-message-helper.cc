@@ -28,31 +28,128 @@ namespace ns3 {
 
 IndicationMessageHelper::IndicationMessageHelper (IndicationMessageType type, bool isOffline,
                                                   bool reducedPmValues)
-    : m_type (type), m_offline (isOffline), m_reducedPmValues (reducedPmValues)
+    : m_type (type),
+      m_offline (isOffline),
+      m_reducedPmValues (reducedPmValues),
+      m_traceTimestamp (0),
+      m_traceCellId (0)
 {
+  InitContainerValues ();
+}
+
+void
+IndicationMessageHelper::InitContainerValues ()
+{
+  if (m_offline)
+    {
+      return;
+    }
 
-  if (!m_offline)
+  // the values moved out of the helper, or still referenced by someone
+  // else on this thread, are replaced; the values taken by the encoding
+  // threads are not referenced by the helper anymore, see TakeMessageValues
+  switch (m_type)
     {
-      switch (type)
+    case IndicationMessageType::CuUp:
+      if (!m_cuUpValues || m_cuUpValues->GetReferenceCount () > 1)
         {
-        case IndicationMessageType::CuUp:
           m_cuUpValues = Create<OCuUpContainerValues> ();
-          break;
+        }
+      break;
 
-        case IndicationMessageType::CuCp:
+    case IndicationMessageType::CuCp:
+      if (!m_cuCpValues || m_cuCpValues->GetReferenceCount () > 1)
+        {
           m_cuCpValues = Create<OCuCpContainerValues> ();
-          m_msgValues.m_cellObjectId = "NRCellCU";
-          break;
+        }
+      m_msgValues.m_cellObjectId = "NRCellCU";
+      break;
 
-        case IndicationMessageType::Du:
+    case IndicationMessageType::Du:
+      if (!m_duValues || m_duValues->GetReferenceCount () > 1)
+        {
           m_duValues = Create<ODuContainerValues> ();
-          break;
+        }
+      else
+        {
+          m_duValues->m_cellResourceReportItems.clear ();
+        }
+      break;
 
-        default:
+    default:
 
-          break;
-        }
+      break;
+    }
+}
+
+void
+IndicationMessageHelper::Reset ()
+{
+  for (const auto &ueVal : m_msgValues.m_ueIndications)
+    {
+      RecycleItemList (ueVal);
+    }
+  m_msgValues.m_ueIndications.clear ();
+  if (m_msgValues.m_cellMeasurementItems)
+    {
+      RecycleItemList (m_msgValues.m_cellMeasurementItems);
+      m_msgValues.m_cellMeasurementItems = nullptr;
+    }
+  m_msgValues.m_pmContainerValues = nullptr;
+  m_msgValues.m_cellObjectId.clear ();
+  InitContainerValues ();
+}
+
+Ptr<MeasurementItemList>
+IndicationMessageHelper::AllocateItemList (const std::string &ueImsiComplete)
+{
+  if (m_freeItemLists.empty ())
+    {
+      return Create<MeasurementItemList> (ueImsiComplete);
+    }
+  Ptr<MeasurementItemList> list = m_freeItemLists.back ();
+  m_freeItemLists.pop_back ();
+  list->Reset (ueImsiComplete);
+  return list;
+}
+
+Ptr<MeasurementItemList>
+IndicationMessageHelper::AllocateItemList ()
+{
+  if (m_freeItemLists.empty ())
+    {
+      return Create<MeasurementItemList> ();
     }
+  Ptr<MeasurementItemList> list = m_freeItemLists.back ();
+  m_freeItemLists.pop_back ();
+  list->Reset ();
+  return list;
+}
+
+void
+IndicationMessageHelper::RecycleItemList (const Ptr<MeasurementItemList> &list)
+{
+  if (list->GetReferenceCount () == 1)
+    {
+      m_freeItemLists.push_back (list);
+    }
+}
+
+void
+IndicationMessageHelper::RecycleMessageValues (KpmIndicationMessage::KpmIndicationMessageValues &values)
+{
+  for (const auto &ueVal : values.m_ueIndications)
+    {
+      RecycleItemList (ueVal);
+    }
+  values.m_ueIndications.clear ();
+  if (values.m_cellMeasurementItems)
+    {
+      RecycleItemList (values.m_cellMeasurementItems);
+      values.m_cellMeasurementItems = nullptr;
+    }
+  values.m_pmContainerValues = nullptr;
+  values.m_cellObjectId.clear ();
 }
 
 void
@@ -71,6 +168,60 @@ IndicationMessageHelper::FillBaseCuCpValues (uint16_t numActiveUes)
   m_msgValues.m_pmContainerValues = m_cuCpValues;
 }
 
+void
+IndicationMessageHelper::SetDeltaFilter (Ptr<KpmDeltaFilter> filter)
+{
+  m_deltaFilter = filter;
+}
+
+void
+IndicationMessageHelper::AddUeIndication (const std::string &ueImsiComplete,
+                                          const Ptr<MeasurementItemList> &ueVal)
+{
+  if (m_deltaFilter && !m_deltaFilter->Filter (ueImsiComplete, ueVal))
+    {
+      RecycleItemList (ueVal);
+      return;
+    }
+  if (m_traceWriter)
+    {
+      // the IMSI is logged as a number
+      uint64_t ueId = 0;
+      for (char digit : ueImsiComplete)
+        {
+          if (digit >= '0' && digit <= '9')
+            {
+              ueId = 10 * ueId + (digit - '0');
+            }
+        }
+      m_traceWriter->Append (m_traceTimestamp, m_traceCellId, ueId, *ueVal);
+      RecycleItemList (ueVal);
+      return;
+    }
+  m_msgValues.m_ueIndications.insert (ueVal);
+}
+
+void
+IndicationMessageHelper::SetCellMeasurementItems (const Ptr<MeasurementItemList> &cellVal)
+{
+  if (m_traceWriter)
+    {
+      m_traceWriter->Append (m_traceTimestamp, m_traceCellId, 0, *cellVal);
+      RecycleItemList (cellVal);
+      return;
+    }
+  m_msgValues.m_cellMeasurementItems = cellVal;
+}
+
+void
+IndicationMessageHelper::SetTraceWriter (Ptr<KpmTraceWriter> writer, uint64_t timestamp,
+                                         uint16_t cellId)
+{
+  m_traceWriter = writer;
+  m_traceTimestamp = timestamp;
+  m_traceCellId = cellId;
+}
+
 IndicationMessageHelper::~IndicationMessageHelper ()
 {
 }
@@ -81,4 +232,35 @@ IndicationMessageHelper::CreateIndicationMessage ()
   return Create<KpmIndicationMessage> (m_msgValues);
 }
 
+Ptr<KpmIndicationMessage>
+IndicationMessageHelper::CreateIndicationMessage (Ptr<EncodeBuffer> encodeBuffer)
+{
+  return Create<KpmIndicationMessage> (m_msgValues, encodeBuffer);
+}
+
+KpmIndicationMessage::KpmIndicationMessageValues
+IndicationMessageHelper::TakeMessageValues ()
+{
+  m_cuUpValues = nullptr;
+  m_cuCpValues = nullptr;
+  m_duValues = nullptr;
+  KpmIndicationMessage::KpmIndicationMessageValues values;
+  m_msgValues.MoveTo (values);
+  return values;
+}
+
+void
+IndicationMessageHelper::CreateIndicationMessages (
+    const std::vector<Ptr<IndicationMessageHelper>> &helpers, Ptr<KpmIndicationMessageBatch> batch,
+    Ptr<EncodeThreadPool> pool)
+{
+  std::vector<KpmIndicationMessage::KpmIndicationMessageValues> values;
+  values.reserve (helpers.size ());
+  for (const auto &helper : helpers)
+    {
+      values.push_back (helper->m_msgValues);
+    }
+  batch->Encode (values, pool);
+}
+
 } // namespace ns3
\ No newline at end of file
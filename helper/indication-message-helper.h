@@ -26,6 +26,9 @@
 #define INDICATION_MESSAGE_HELPER_H
 
 #include <ns3/kpm-indication.h>
+#include <ns3/kpm-indication-batch.h>
+#include <ns3/kpm-delta-filter.h>
+#include <ns3/kpm-trace-writer.h>
 
 namespace ns3 {
 
@@ -37,8 +40,89 @@ public:
 
   ~IndicationMessageHelper ();
 
+  /**
+   * Prepare the helper for the next reporting period, as if it was just
+   * created. The containers keep their capacity and the measurement lists
+   * not referenced anymore are recycled by the next calls to the Add
+   * methods. The values handed to the encoding threads with
+   * TakeMessageValues are not held by the helper, and only come back
+   * through RecycleMessageValues.
+   */
+  void Reset ();
+
   Ptr<KpmIndicationMessage> CreateIndicationMessage ();
 
+  /**
+   * Create the indication message encoding it into a caller-owned buffer,
+   * e.g., the one returned by E2Termination::GetMessageEncodeBuffer
+   *
+   * \param encodeBuffer the buffer the message is encoded into
+   * \return the indication message
+   */
+  Ptr<KpmIndicationMessage> CreateIndicationMessage (Ptr<EncodeBuffer> encodeBuffer);
+
+  /**
+   * Create the indication messages of several helpers, e.g., one per cell
+   * of a multi-cell node, encoding them together into a reusable batch
+   *
+   * \param helpers the helpers, whose values must not share any object
+   *        when a pool is given
+   * \param batch the batch the messages are encoded into
+   * \param pool the threads performing the encoding, or nullptr to encode
+   *        on the calling thread
+   */
+  static void CreateIndicationMessages (const std::vector<Ptr<IndicationMessageHelper>> &helpers,
+                                        Ptr<KpmIndicationMessageBatch> batch,
+                                        Ptr<EncodeThreadPool> pool = nullptr);
+
+  /**
+   * \return the values of the indication message
+   */
+  const KpmIndicationMessage::KpmIndicationMessageValues &
+  GetMessageValues () const
+  {
+    return m_msgValues;
+  }
+
+  /**
+   * Move the values of the indication message out of the helper, e.g., to
+   * pass them to E2Termination::EncodeAndSendIndication. The helper keeps
+   * no reference to them and cannot be used to create messages anymore.
+   *
+   * \return the values of the indication message
+   */
+  KpmIndicationMessage::KpmIndicationMessageValues TakeMessageValues ();
+
+  /**
+   * Reuse the measurement lists of values taken from a helper once nobody
+   * else holds them, i.e., after E2Termination::CollectSentIndicationValues
+   * returned them. The values are cleared.
+   *
+   * \param values the values of a sent message
+   */
+  void RecycleMessageValues (KpmIndicationMessage::KpmIndicationMessageValues &values);
+
+  /**
+   * Enable incremental reports: the UE measurements added afterwards are
+   * only included if they changed since the last report filtered by the
+   * same filter. KpmDeltaFilter::Commit or KpmDeltaFilter::Discard must be
+   * called once the message is sent or dropped.
+   *
+   * \param filter the filter, shared by the helpers of consecutive reports
+   */
+  void SetDeltaFilter (Ptr<KpmDeltaFilter> filter);
+
+  /**
+   * Log the measurements added afterwards to a binary trace instead of
+   * keeping them for an indication message, e.g., in offline runs, so that
+   * they are never encoded
+   *
+   * \param writer the trace writer, or nullptr to stop logging
+   * \param timestamp the collection timestamp of the records
+   * \param cellId the ID of the cell of the records
+   */
+  void SetTraceWriter (Ptr<KpmTraceWriter> writer, uint64_t timestamp, uint16_t cellId);
+
   bool const &
   IsOffline () const
   {
@@ -50,6 +134,34 @@ protected:
 
   void FillBaseCuCpValues (uint16_t numActiveUes);
 
+  /**
+   * Add the measurements of a UE to the message, unless the delta filter
+   * removes all of them
+   *
+   * \param ueImsiComplete the IMSI of the UE
+   * \param ueVal the measurements of the UE
+   */
+  void AddUeIndication (const std::string &ueImsiComplete, const Ptr<MeasurementItemList> &ueVal);
+
+  /**
+   * \param ueImsiComplete the IMSI of the UE
+   * \return an empty measurement list for a UE, recycled if possible
+   */
+  Ptr<MeasurementItemList> AllocateItemList (const std::string &ueImsiComplete);
+
+  /**
+   * \return an empty measurement list for the cell, recycled if possible
+   */
+  Ptr<MeasurementItemList> AllocateItemList ();
+
+  /**
+   * Set the cell-level measurements of the message, or log them if a
+   * trace writer is set
+   *
+   * \param cellVal the measurements of the cell
+   */
+  void SetCellMeasurementItems (const Ptr<MeasurementItemList> &cellVal);
+
   IndicationMessageType m_type;
   bool m_offline;
   bool m_reducedPmValues;
@@ -57,6 +169,29 @@ protected:
   Ptr<OCuUpContainerValues> m_cuUpValues;
   Ptr<OCuCpContainerValues> m_cuCpValues;
   Ptr<ODuContainerValues> m_duValues;
+  Ptr<KpmDeltaFilter> m_deltaFilter;
+  Ptr<KpmTraceWriter> m_traceWriter;
+  uint64_t m_traceTimestamp;
+  uint16_t m_traceCellId;
+
+private:
+  /**
+   * Create the PM container values of the type of the helper, or clear
+   * them if they are not referenced by anyone else
+   */
+  void InitContainerValues ();
+
+  /**
+   * Add a measurement list to the free list, if the helper holds the
+   * last reference to it. Only called on lists that no encoding thread
+   * holds, so the reference count is not read while another thread may
+   * change it.
+   *
+   * \param list the list
+   */
+  void RecycleItemList (const Ptr<MeasurementItemList> &list);
+
+  std::vector<Ptr<MeasurementItemList>> m_freeItemLists; //!< lists ready to be reused
 };
 
 } // namespace ns3
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPI_SCHEMA_H
+#define KPI_SCHEMA_H
+
+#include <ns3/kpm-indication.h>
+#include <array>
+#include <tuple>
+#include <utility>
+
+namespace ns3 {
+
+/**
+* A KPI of a schema: the field of the record holding its value, the name
+* it is reported with and whether it belongs to the reduced set of KPIs
+*/
+template<class Record, class T>
+struct KpiField
+{
+  T Record::*m_member; //!< the field holding the value
+  const char *m_name; //!< the name of the measurement
+  bool m_reduced; //!< true if reported also with reduced PM values
+};
+
+/**
+* \param member the field holding the value
+* \param name the name of the measurement
+* \param reduced true if reported also with reduced PM values
+* \return the KPI
+*/
+template<class Record, class T>
+constexpr KpiField<Record, T>
+MakeKpiField (T Record::*member, const char *name, bool reduced)
+{
+  return KpiField<Record, T>{member, name, reduced};
+}
+
+/**
+* Adds the KPIs of a record to a list of Measurement Information Items,
+* following a schema known at compile time.
+*
+* A schema is a class defining the Record type and a static constexpr
+* tuple of KpiField, Fields, in the order the items are reported. The
+* names are registered in the KpiNameRegistry on first use, and the
+* complete and reduced sets are separate instantiations, so adding the
+* items does not branch on the set or look up any name.
+*/
+template<class Schema>
+class KpiSchemaWriter
+{
+public:
+  typedef typename Schema::Record Record;
+
+  /**
+  * Number of KPIs of the schema
+  */
+  static constexpr size_t N = std::tuple_size<decltype (Schema::Fields)>::value;
+
+  /**
+  * Add the KPIs of a record to a list
+  *
+  * \tparam Reduced true to only add the reduced set of KPIs
+  * \param list the list
+  * \param record the record
+  */
+  template<bool Reduced>
+  static void
+  AddItems (Ptr<MeasurementItemList> list, const Record &record)
+  {
+    AddItems<Reduced> (list, record, std::make_index_sequence<N> ());
+  }
+
+  /**
+  * Add the KPIs of a record to a list
+  *
+  * \param list the list
+  * \param record the record
+  * \param reduced true to only add the reduced set of KPIs
+  */
+  static void
+  AddItems (Ptr<MeasurementItemList> list, const Record &record, bool reduced)
+  {
+    if (reduced)
+      {
+        AddItems<true> (list, record);
+      }
+    else
+      {
+        AddItems<false> (list, record);
+      }
+  }
+
+private:
+  template<bool Reduced, size_t... I>
+  static void
+  AddItems (Ptr<MeasurementItemList> list, const Record &record, std::index_sequence<I...>)
+  {
+    const std::array<KpiNameRegistry::Id, N> &nameIds = GetNameIds ();
+    (AddItem<Reduced, I> (list, record, nameIds[I]), ...);
+  }
+
+  template<bool Reduced, size_t I>
+  static void
+  AddItem (Ptr<MeasurementItemList> list, const Record &record, KpiNameRegistry::Id nameId)
+  {
+    constexpr auto field = std::get<I> (Schema::Fields);
+    if constexpr (!Reduced || field.m_reduced)
+      {
+        list->AddItem (nameId, record.*field.m_member);
+      }
+  }
+
+  static const std::array<KpiNameRegistry::Id, N> &
+  GetNameIds ()
+  {
+    static const std::array<KpiNameRegistry::Id, N> nameIds =
+        RegisterNames (std::make_index_sequence<N> ());
+    return nameIds;
+  }
+
+  template<size_t... I>
+  static std::array<KpiNameRegistry::Id, N>
+  RegisterNames (std::index_sequence<I...>)
+  {
+    return {{KpiNameRegistry::Register (std::get<I> (Schema::Fields).m_name)...}};
+  }
+};
+
+} // namespace ns3
+
+#endif /* KPI_SCHEMA_H */
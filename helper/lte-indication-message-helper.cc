@@ -27,6 +27,23 @@
 
 namespace ns3 {
 
+/**
+* PDCP volume, rate and delay and DRB setup and release KPIs of the LTE
+* CU-UP and CU-CP reports
+*/
+static const struct LteKpiNames
+{
+  KpiNameRegistry::Id drbPdcpSduVolumeDlFilterUeid =
+      KpiNameRegistry::Register ("DRB.PdcpSduVolumeDl_Filter.UEID");
+  KpiNameRegistry::Id totPdcpSduNbrDlUeid = KpiNameRegistry::Register ("Tot.PdcpSduNbrDl.UEID");
+  KpiNameRegistry::Id drbPdcpSduBitRateDlUeid =
+      KpiNameRegistry::Register ("DRB.PdcpSduBitRateDl.UEID");
+  KpiNameRegistry::Id drbPdcpSduDelayDlUeid = KpiNameRegistry::Register ("DRB.PdcpSduDelayDl.UEID");
+  KpiNameRegistry::Id drbPdcpSduDelayDl = KpiNameRegistry::Register ("DRB.PdcpSduDelayDl");
+  KpiNameRegistry::Id drbEstabSucc5QiUeid = KpiNameRegistry::Register ("DRB.EstabSucc.5QI.UEID");
+  KpiNameRegistry::Id drbRelActNbr5QiUeid = KpiNameRegistry::Register ("DRB.RelActNbr.5QI.UEID");
+} g_kpiNames;
+
 LteIndicationMessageHelper::LteIndicationMessageHelper (IndicationMessageType type, bool isOffline,
                                                         bool reducedPmValues)
     : IndicationMessageHelper (type, isOffline, reducedPmValues)
@@ -40,24 +57,24 @@ LteIndicationMessageHelper::AddCuUpUePmItem (std::string ueImsiComplete, long tx
                                              long txDlPackets, double pdcpThroughput,
                                              double pdcpLatency)
 {
-  Ptr<MeasurementItemList> ueVal = Create<MeasurementItemList> (ueImsiComplete);
+  Ptr<MeasurementItemList> ueVal = AllocateItemList (ueImsiComplete);
 
   if (!m_reducedPmValues)
     {
       // UE-specific PDCP SDU volume from LTE eNB. Unit is Mbits
-      ueVal->AddItem<long> ("DRB.PdcpSduVolumeDl_Filter.UEID", txBytes);
+      ueVal->AddItem<long> (g_kpiNames.drbPdcpSduVolumeDlFilterUeid, txBytes);
 
       // UE-specific number of PDCP SDUs from LTE eNB
-      ueVal->AddItem<long> ("Tot.PdcpSduNbrDl.UEID", txDlPackets);
+      ueVal->AddItem<long> (g_kpiNames.totPdcpSduNbrDlUeid, txDlPackets);
 
       // UE-specific Downlink IP combined EN-DC throughput from LTE eNB. Unit is kbps
-      ueVal->AddItem<double> ("DRB.PdcpSduBitRateDl.UEID", pdcpThroughput);
+      ueVal->AddItem<double> (g_kpiNames.drbPdcpSduBitRateDlUeid, pdcpThroughput);
 
       //UE-specific Downlink IP combined EN-DC throughput from LTE eNB
-      ueVal->AddItem<double> ("DRB.PdcpSduDelayDl.UEID", pdcpLatency);
+      ueVal->AddItem<double> (g_kpiNames.drbPdcpSduDelayDlUeid, pdcpLatency);
     }
 
-  m_msgValues.m_ueIndications.insert (ueVal);
+  AddUeIndication (ueImsiComplete, ueVal);
 }
 
 void
@@ -65,9 +82,9 @@ LteIndicationMessageHelper::AddCuUpCellPmItem (double cellAverageLatency)
 {
   if (!m_reducedPmValues)
     {
-      Ptr<MeasurementItemList> cellVal = Create<MeasurementItemList> ();
-      cellVal->AddItem<double> ("DRB.PdcpSduDelayDl", cellAverageLatency);
-      m_msgValues.m_cellMeasurementItems = cellVal;
+      Ptr<MeasurementItemList> cellVal = AllocateItemList ();
+      cellVal->AddItem<double> (g_kpiNames.drbPdcpSduDelayDl, cellAverageLatency);
+      SetCellMeasurementItems (cellVal);
     }
 }
 
@@ -90,13 +107,13 @@ LteIndicationMessageHelper::AddCuCpUePmItem (std::string ueImsiComplete, long nu
                                              long drbRelAct)
 {
 
-  Ptr<MeasurementItemList> ueVal = Create<MeasurementItemList> (ueImsiComplete);
+  Ptr<MeasurementItemList> ueVal = AllocateItemList (ueImsiComplete);
   if (!m_reducedPmValues)
     {
-      ueVal->AddItem<long> ("DRB.EstabSucc.5QI.UEID", numDrb);
-      ueVal->AddItem<long> ("DRB.RelActNbr.5QI.UEID", drbRelAct); // not modeled in the simulator
+      ueVal->AddItem<long> (g_kpiNames.drbEstabSucc5QiUeid, numDrb);
+      ueVal->AddItem<long> (g_kpiNames.drbRelActNbr5QiUeid, drbRelAct); // not modeled in the simulator
     }
-  m_msgValues.m_ueIndications.insert (ueVal);
+  AddUeIndication (ueImsiComplete, ueVal);
 }
 
 LteIndicationMessageHelper::~LteIndicationMessageHelper ()
@@ -23,9 +23,97 @@
  */
 
 #include <ns3/mmwave-indication-message-helper.h>
+#include <ns3/kpi-schema.h>
 
 namespace ns3 {
 
+/**
+* KPIs of the NR CU-UP and CU-CP reports that are not part of a schema:
+* the QoS flow PDCP volume, the DRB setup and release and the handover
+* cell qualities
+*/
+static const struct MmWaveKpiNames
+{
+  KpiNameRegistry::Id qosFlowPdcpPduVolumeDlFilterUeid =
+      KpiNameRegistry::Register ("QosFlow.PdcpPduVolumeDL_Filter.UEID");
+  KpiNameRegistry::Id drbPdcpPduNbrDlQosUeid =
+      KpiNameRegistry::Register ("DRB.PdcpPduNbrDl.Qos.UEID");
+  KpiNameRegistry::Id drbEstabSucc5QiUeid = KpiNameRegistry::Register ("DRB.EstabSucc.5QI.UEID");
+  KpiNameRegistry::Id drbRelActNbr5QiUeid = KpiNameRegistry::Register ("DRB.RelActNbr.5QI.UEID");
+  KpiNameRegistry::Id hoSrcCellQualRsSinrUeid =
+      KpiNameRegistry::Register ("HO.SrcCellQual.RS-SINR.UEID");
+  KpiNameRegistry::Id hoTrgtCellQualRsSinrUeid =
+      KpiNameRegistry::Register ("HO.TrgtCellQual.RS-SINR.UEID");
+} g_kpiNames;
+
+/**
+* KPIs of a UE reported by the DU, in the order of the report. Only the
+* throughput is part of the reduced set.
+*/
+struct DuUeKpiSchema
+{
+  typedef MmWaveIndicationMessageHelper::DuUeKpis Record;
+  static constexpr auto Fields = std::make_tuple (
+      MakeKpiField (&Record::tbTotNbrDl1, "TB.TotNbrDl.1.UEID", false),
+      MakeKpiField (&Record::tbTotNbrDlInitial, "TB.TotNbrDlInitial.UEID", false),
+      MakeKpiField (&Record::tbTotNbrDlInitialQpsk, "TB.TotNbrDlInitial.Qpsk.UEID", false),
+      MakeKpiField (&Record::tbTotNbrDlInitial16Qam, "TB.TotNbrDlInitial.16Qam.UEID", false),
+      MakeKpiField (&Record::tbTotNbrDlInitial64Qam, "TB.TotNbrDlInitial.64Qam.UEID", false),
+      MakeKpiField (&Record::tbErrTotalNbrDl1, "TB.ErrTotalNbrDl.1.UEID", false),
+      MakeKpiField (&Record::qosFlowPdcpPduVolumeDlFilter, "QosFlow.PdcpPduVolumeDL_Filter.UEID",
+                    false),
+      MakeKpiField (&Record::rruPrbUsedDl, "RRU.PrbUsedDl.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin1, "CARR.PDSCHMCSDist.Bin1.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin2, "CARR.PDSCHMCSDist.Bin2.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin3, "CARR.PDSCHMCSDist.Bin3.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin4, "CARR.PDSCHMCSDist.Bin4.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin5, "CARR.PDSCHMCSDist.Bin5.UEID", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin6, "CARR.PDSCHMCSDist.Bin6.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin34, "L1M.RS-SINR.Bin34.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin46, "L1M.RS-SINR.Bin46.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin58, "L1M.RS-SINR.Bin58.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin70, "L1M.RS-SINR.Bin70.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin82, "L1M.RS-SINR.Bin82.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin94, "L1M.RS-SINR.Bin94.UEID", false),
+      MakeKpiField (&Record::l1MRsSinrBin127, "L1M.RS-SINR.Bin127.UEID", false),
+      MakeKpiField (&Record::drbBufferSizeQos, "DRB.BufferSize.Qos.UEID", false),
+      // DRB.UEThpDlPdcpBased.UEID is not requested anymore, so it is neither registered nor sent
+      MakeKpiField (&Record::drbUeThpDl, "DRB.UEThpDl.UEID", true));
+};
+
+/**
+* KPIs of a cell reported by the DU, in the order of the report
+*/
+struct DuCellKpiSchema
+{
+  typedef MmWaveIndicationMessageHelper::DuCellKpis Record;
+  static constexpr auto Fields = std::make_tuple (
+      MakeKpiField (&Record::tbTotNbrDl1, "TB.TotNbrDl.1", false),
+      MakeKpiField (&Record::tbTotNbrDlInitial, "TB.TotNbrDlInitial", false),
+      MakeKpiField (&Record::tbTotNbrDlInitialQpsk, "TB.TotNbrDlInitial.Qpsk", true),
+      MakeKpiField (&Record::tbTotNbrDlInitial16Qam, "TB.TotNbrDlInitial.16Qam", true),
+      MakeKpiField (&Record::tbTotNbrDlInitial64Qam, "TB.TotNbrDlInitial.64Qam", true),
+      MakeKpiField (&Record::rruPrbUsedDl, "RRU.PrbUsedDl", true),
+      MakeKpiField (&Record::tbErrTotalNbrDl1, "TB.ErrTotalNbrDl.1", false),
+      MakeKpiField (&Record::qosFlowPdcpPduVolumeDlFilter, "QosFlow.PdcpPduVolumeDL_Filter",
+                    false),
+      MakeKpiField (&Record::carrPdschmcsDistBin1, "CARR.PDSCHMCSDist.Bin1", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin2, "CARR.PDSCHMCSDist.Bin2", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin3, "CARR.PDSCHMCSDist.Bin3", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin4, "CARR.PDSCHMCSDist.Bin4", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin5, "CARR.PDSCHMCSDist.Bin5", false),
+      MakeKpiField (&Record::carrPdschmcsDistBin6, "CARR.PDSCHMCSDist.Bin6", false),
+      MakeKpiField (&Record::l1MRsSinrBin34, "L1M.RS-SINR.Bin34", false),
+      MakeKpiField (&Record::l1MRsSinrBin46, "L1M.RS-SINR.Bin46", false),
+      MakeKpiField (&Record::l1MRsSinrBin58, "L1M.RS-SINR.Bin58", false),
+      MakeKpiField (&Record::l1MRsSinrBin70, "L1M.RS-SINR.Bin70", false),
+      MakeKpiField (&Record::l1MRsSinrBin82, "L1M.RS-SINR.Bin82", false),
+      MakeKpiField (&Record::l1MRsSinrBin94, "L1M.RS-SINR.Bin94", false),
+      MakeKpiField (&Record::l1MRsSinrBin127, "L1M.RS-SINR.Bin127", false),
+      MakeKpiField (&Record::drbBufferSizeQos, "DRB.BufferSize.Qos", false),
+      MakeKpiField (&Record::drbMeanActiveUeDl, "DRB.MeanActiveUeDl", true));
+};
+
 MmWaveIndicationMessageHelper::MmWaveIndicationMessageHelper (IndicationMessageType type,
                                                               bool isOffline, bool reducedPmValues)
     : IndicationMessageHelper (type, isOffline, reducedPmValues)
@@ -36,17 +124,17 @@ void
 MmWaveIndicationMessageHelper::AddCuUpUePmItem (std::string ueImsiComplete,
                                                 long txPdcpPduBytesNrRlc, long txPdcpPduNrRlc)
 {
-  Ptr<MeasurementItemList> ueVal = Create<MeasurementItemList> (ueImsiComplete);
+  Ptr<MeasurementItemList> ueVal = AllocateItemList (ueImsiComplete);
   if (!m_reducedPmValues)
     {
       // UE-specific PDCP PDU volume transmitted to NR gNB (Unit is Kbits)
-      ueVal->AddItem<long> ("QosFlow.PdcpPduVolumeDL_Filter.UEID", txPdcpPduBytesNrRlc);
+      ueVal->AddItem<long> (g_kpiNames.qosFlowPdcpPduVolumeDlFilterUeid, txPdcpPduBytesNrRlc);
 
       // UE-specific number of PDCP PDUs split with NR gNB
-      ueVal->AddItem<long> ("DRB.PdcpPduNbrDl.Qos.UEID", txPdcpPduNrRlc);
+      ueVal->AddItem<long> (g_kpiNames.drbPdcpPduNbrDlQosUeid, txPdcpPduNrRlc);
     }
 
-  m_msgValues.m_ueIndications.insert (ueVal);
+  AddUeIndication (ueImsiComplete, ueVal);
 }
 
 void
@@ -68,6 +156,22 @@ MmWaveIndicationMessageHelper::FillDuValues (std::string cellObjectId)
   m_msgValues.m_pmContainerValues = m_duValues;
 }
 
+void
+MmWaveIndicationMessageHelper::AddDuUePmItem (std::string ueImsiComplete, const DuUeKpis &kpis)
+{
+  Ptr<MeasurementItemList> ueVal = AllocateItemList (ueImsiComplete);
+  KpiSchemaWriter<DuUeKpiSchema>::AddItems (ueVal, kpis, m_reducedPmValues);
+  AddUeIndication (ueImsiComplete, ueVal);
+}
+
+void
+MmWaveIndicationMessageHelper::AddDuCellPmItem (const DuCellKpis &kpis)
+{
+  Ptr<MeasurementItemList> cellVal = AllocateItemList ();
+  KpiSchemaWriter<DuCellKpiSchema>::AddItems (cellVal, kpis, m_reducedPmValues);
+  SetCellMeasurementItems (cellVal);
+}
+
 void
 MmWaveIndicationMessageHelper::AddDuUePmItem (
     std::string ueImsiComplete, long macPduUe, long macPduInitialUe, long macQpsk, long mac16Qam,
@@ -76,40 +180,31 @@ MmWaveIndicationMessageHelper::AddDuUePmItem (
     long macSinrBin2, long macSinrBin3, long macSinrBin4, long macSinrBin5, long macSinrBin6,
     long macSinrBin7, long rlcBufferOccup, double drbThrDlUeid)
 {
-
-  Ptr<MeasurementItemList> ueVal = Create<MeasurementItemList> (ueImsiComplete);
-  if (!m_reducedPmValues)
-    {
-      ueVal->AddItem<long> ("TB.TotNbrDl.1.UEID", macPduUe);
-      ueVal->AddItem<long> ("TB.TotNbrDlInitial.UEID", macPduInitialUe);
-      ueVal->AddItem<long> ("TB.TotNbrDlInitial.Qpsk.UEID", macQpsk);
-      ueVal->AddItem<long> ("TB.TotNbrDlInitial.16Qam.UEID", mac16Qam);
-      ueVal->AddItem<long> ("TB.TotNbrDlInitial.64Qam.UEID", mac64Qam);
-      ueVal->AddItem<long> ("TB.ErrTotalNbrDl.1.UEID", macRetx);
-      ueVal->AddItem<long> ("QosFlow.PdcpPduVolumeDL_Filter.UEID", macVolume);
-      ueVal->AddItem<long> ("RRU.PrbUsedDl.UEID", (long) std::ceil (macPrb));
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin1.UEID", macMac04);
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin2.UEID", macMac59);
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin3.UEID", macMac1014);
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin4.UEID", macMac1519);
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin5.UEID", macMac2024);
-      ueVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin6.UEID", macMac2529);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin34.UEID", macSinrBin1);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin46.UEID", macSinrBin2);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin58.UEID", macSinrBin3);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin70.UEID", macSinrBin4);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin82.UEID", macSinrBin5);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin94.UEID", macSinrBin6);
-      ueVal->AddItem<long> ("L1M.RS-SINR.Bin127.UEID", macSinrBin7);
-      ueVal->AddItem<long> ("DRB.BufferSize.Qos.UEID", rlcBufferOccup);
-    }
-
-  // This value is not requested anymore, so it has been removed from the delivery, but it will be still logged;
-  // ueVal->AddItem<double> ("DRB.UEThpDlPdcpBased.UEID", drbThrDlPdcpBasedUeid);
-  
-  ueVal->AddItem<double> ("DRB.UEThpDl.UEID", drbThrDlUeid);
-
-  m_msgValues.m_ueIndications.insert (ueVal);
+  DuUeKpis kpis;
+  kpis.tbTotNbrDl1 = macPduUe;
+  kpis.tbTotNbrDlInitial = macPduInitialUe;
+  kpis.tbTotNbrDlInitialQpsk = macQpsk;
+  kpis.tbTotNbrDlInitial16Qam = mac16Qam;
+  kpis.tbTotNbrDlInitial64Qam = mac64Qam;
+  kpis.tbErrTotalNbrDl1 = macRetx;
+  kpis.qosFlowPdcpPduVolumeDlFilter = macVolume;
+  kpis.rruPrbUsedDl = macPrb;
+  kpis.carrPdschmcsDistBin1 = macMac04;
+  kpis.carrPdschmcsDistBin2 = macMac59;
+  kpis.carrPdschmcsDistBin3 = macMac1014;
+  kpis.carrPdschmcsDistBin4 = macMac1519;
+  kpis.carrPdschmcsDistBin5 = macMac2024;
+  kpis.carrPdschmcsDistBin6 = macMac2529;
+  kpis.l1MRsSinrBin34 = macSinrBin1;
+  kpis.l1MRsSinrBin46 = macSinrBin2;
+  kpis.l1MRsSinrBin58 = macSinrBin3;
+  kpis.l1MRsSinrBin70 = macSinrBin4;
+  kpis.l1MRsSinrBin82 = macSinrBin5;
+  kpis.l1MRsSinrBin94 = macSinrBin6;
+  kpis.l1MRsSinrBin127 = macSinrBin7;
+  kpis.drbBufferSizeQos = rlcBufferOccup;
+  kpis.drbUeThpDl = drbThrDlUeid;
+  AddDuUePmItem (ueImsiComplete, kpis);
 }
 
 void
@@ -123,42 +218,31 @@ MmWaveIndicationMessageHelper::AddDuCellPmItem (
     long macSinrBin5CellSpecific, long macSinrBin6CellSpecific, long macSinrBin7CellSpecific,
     long rlcBufferOccupCellSpecific, long activeUeDl)
 {
-  Ptr<MeasurementItemList> cellVal = Create<MeasurementItemList> ();
-
-  if (!m_reducedPmValues)
-    {
-      cellVal->AddItem<long> ("TB.TotNbrDl.1", macPduCellSpecific);
-      cellVal->AddItem<long> ("TB.TotNbrDlInitial", macPduInitialCellSpecific);
-    }
-
-  cellVal->AddItem<long> ("TB.TotNbrDlInitial.Qpsk", macQpskCellSpecific);
-  cellVal->AddItem<long> ("TB.TotNbrDlInitial.16Qam", mac16QamCellSpecific);
-  cellVal->AddItem<long> ("TB.TotNbrDlInitial.64Qam", mac64QamCellSpecific);
-  cellVal->AddItem<long> ("RRU.PrbUsedDl", (long) std::ceil (prbUtilizationDl));
-
-  if (!m_reducedPmValues)
-    {
-      cellVal->AddItem<long> ("TB.ErrTotalNbrDl.1", macRetxCellSpecific);
-      cellVal->AddItem<long> ("QosFlow.PdcpPduVolumeDL_Filter", macVolumeCellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin1", macMac04CellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin2", macMac59CellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin3", macMac1014CellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin4", macMac1519CellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin5", macMac2024CellSpecific);
-      cellVal->AddItem<long> ("CARR.PDSCHMCSDist.Bin6", macMac2529CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin34", macSinrBin1CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin46", macSinrBin2CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin58", macSinrBin3CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin70", macSinrBin4CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin82", macSinrBin5CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin94", macSinrBin6CellSpecific);
-      cellVal->AddItem<long> ("L1M.RS-SINR.Bin127", macSinrBin7CellSpecific);
-      cellVal->AddItem<long> ("DRB.BufferSize.Qos", rlcBufferOccupCellSpecific);
-    }
-
-  cellVal->AddItem<long> ("DRB.MeanActiveUeDl",activeUeDl);
-
-  m_msgValues.m_cellMeasurementItems = cellVal;
+  DuCellKpis kpis;
+  kpis.tbTotNbrDl1 = macPduCellSpecific;
+  kpis.tbTotNbrDlInitial = macPduInitialCellSpecific;
+  kpis.tbTotNbrDlInitialQpsk = macQpskCellSpecific;
+  kpis.tbTotNbrDlInitial16Qam = mac16QamCellSpecific;
+  kpis.tbTotNbrDlInitial64Qam = mac64QamCellSpecific;
+  kpis.rruPrbUsedDl = (long) std::ceil (prbUtilizationDl);
+  kpis.tbErrTotalNbrDl1 = macRetxCellSpecific;
+  kpis.qosFlowPdcpPduVolumeDlFilter = macVolumeCellSpecific;
+  kpis.carrPdschmcsDistBin1 = macMac04CellSpecific;
+  kpis.carrPdschmcsDistBin2 = macMac59CellSpecific;
+  kpis.carrPdschmcsDistBin3 = macMac1014CellSpecific;
+  kpis.carrPdschmcsDistBin4 = macMac1519CellSpecific;
+  kpis.carrPdschmcsDistBin5 = macMac2024CellSpecific;
+  kpis.carrPdschmcsDistBin6 = macMac2529CellSpecific;
+  kpis.l1MRsSinrBin34 = macSinrBin1CellSpecific;
+  kpis.l1MRsSinrBin46 = macSinrBin2CellSpecific;
+  kpis.l1MRsSinrBin58 = macSinrBin3CellSpecific;
+  kpis.l1MRsSinrBin70 = macSinrBin4CellSpecific;
+  kpis.l1MRsSinrBin82 = macSinrBin5CellSpecific;
+  kpis.l1MRsSinrBin94 = macSinrBin6CellSpecific;
+  kpis.l1MRsSinrBin127 = macSinrBin7CellSpecific;
+  kpis.drbBufferSizeQos = rlcBufferOccupCellSpecific;
+  kpis.drbMeanActiveUeDl = activeUeDl;
+  AddDuCellPmItem (kpis);
 }
 
 void
@@ -174,17 +258,17 @@ MmWaveIndicationMessageHelper::AddCuCpUePmItem (std::string ueImsiComplete, long
                                                 Ptr<L3RrcMeasurements> l3RrcMeasurementNeigh)
 {
 
-  Ptr<MeasurementItemList> ueVal = Create<MeasurementItemList> (ueImsiComplete);
+  Ptr<MeasurementItemList> ueVal = AllocateItemList (ueImsiComplete);
   if (!m_reducedPmValues)
     {
-      ueVal->AddItem<long> ("DRB.EstabSucc.5QI.UEID", numDrb);
-      ueVal->AddItem<long> ("DRB.RelActNbr.5QI.UEID", drbRelAct); // not modeled in the simulator
+      ueVal->AddItem<long> (g_kpiNames.drbEstabSucc5QiUeid, numDrb);
+      ueVal->AddItem<long> (g_kpiNames.drbRelActNbr5QiUeid, drbRelAct); // not modeled in the simulator
     }
 
-  ueVal->AddItem<Ptr<L3RrcMeasurements>> ("HO.SrcCellQual.RS-SINR.UEID", l3RrcMeasurementServing);
-  ueVal->AddItem<Ptr<L3RrcMeasurements>> ("HO.TrgtCellQual.RS-SINR.UEID", l3RrcMeasurementNeigh);
+  ueVal->AddItem<Ptr<L3RrcMeasurements>> (g_kpiNames.hoSrcCellQualRsSinrUeid, l3RrcMeasurementServing);
+  ueVal->AddItem<Ptr<L3RrcMeasurements>> (g_kpiNames.hoTrgtCellQualRsSinrUeid, l3RrcMeasurementNeigh);
 
-  m_msgValues.m_ueIndications.insert (ueVal);
+  AddUeIndication (ueImsiComplete, ueVal);
 }
 
 MmWaveIndicationMessageHelper::~MmWaveIndicationMessageHelper ()
@@ -32,6 +32,66 @@ namespace ns3 {
 class MmWaveIndicationMessageHelper : public IndicationMessageHelper
 {
 public:
+  /**
+   * KPIs of a UE reported by the DU
+   */
+  struct DuUeKpis
+  {
+    long tbTotNbrDl1 = 0; //!< TB.TotNbrDl.1.UEID, MAC PDUs
+    long tbTotNbrDlInitial = 0; //!< TB.TotNbrDlInitial.UEID, initial MAC PDUs
+    long tbTotNbrDlInitialQpsk = 0; //!< TB.TotNbrDlInitial.Qpsk.UEID
+    long tbTotNbrDlInitial16Qam = 0; //!< TB.TotNbrDlInitial.16Qam.UEID
+    long tbTotNbrDlInitial64Qam = 0; //!< TB.TotNbrDlInitial.64Qam.UEID
+    long tbErrTotalNbrDl1 = 0; //!< TB.ErrTotalNbrDl.1.UEID, MAC retransmissions
+    long qosFlowPdcpPduVolumeDlFilter = 0; //!< QosFlow.PdcpPduVolumeDL_Filter.UEID, MAC volume
+    long rruPrbUsedDl = 0; //!< RRU.PrbUsedDl.UEID, PRBs
+    long carrPdschmcsDistBin1 = 0; //!< CARR.PDSCHMCSDist.Bin1.UEID, MCS 0 to 4
+    long carrPdschmcsDistBin2 = 0; //!< CARR.PDSCHMCSDist.Bin2.UEID, MCS 5 to 9
+    long carrPdschmcsDistBin3 = 0; //!< CARR.PDSCHMCSDist.Bin3.UEID, MCS 10 to 14
+    long carrPdschmcsDistBin4 = 0; //!< CARR.PDSCHMCSDist.Bin4.UEID, MCS 15 to 19
+    long carrPdschmcsDistBin5 = 0; //!< CARR.PDSCHMCSDist.Bin5.UEID, MCS 20 to 24
+    long carrPdschmcsDistBin6 = 0; //!< CARR.PDSCHMCSDist.Bin6.UEID, MCS 25 to 29
+    long l1MRsSinrBin34 = 0; //!< L1M.RS-SINR.Bin34.UEID
+    long l1MRsSinrBin46 = 0; //!< L1M.RS-SINR.Bin46.UEID
+    long l1MRsSinrBin58 = 0; //!< L1M.RS-SINR.Bin58.UEID
+    long l1MRsSinrBin70 = 0; //!< L1M.RS-SINR.Bin70.UEID
+    long l1MRsSinrBin82 = 0; //!< L1M.RS-SINR.Bin82.UEID
+    long l1MRsSinrBin94 = 0; //!< L1M.RS-SINR.Bin94.UEID
+    long l1MRsSinrBin127 = 0; //!< L1M.RS-SINR.Bin127.UEID
+    long drbBufferSizeQos = 0; //!< DRB.BufferSize.Qos.UEID, RLC buffer occupancy
+    double drbUeThpDl = 0; //!< DRB.UEThpDl.UEID, throughput
+  };
+
+  /**
+   * KPIs of a cell reported by the DU
+   */
+  struct DuCellKpis
+  {
+    long tbTotNbrDl1 = 0; //!< TB.TotNbrDl.1, MAC PDUs
+    long tbTotNbrDlInitial = 0; //!< TB.TotNbrDlInitial, initial MAC PDUs
+    long tbTotNbrDlInitialQpsk = 0; //!< TB.TotNbrDlInitial.Qpsk
+    long tbTotNbrDlInitial16Qam = 0; //!< TB.TotNbrDlInitial.16Qam
+    long tbTotNbrDlInitial64Qam = 0; //!< TB.TotNbrDlInitial.64Qam
+    long rruPrbUsedDl = 0; //!< RRU.PrbUsedDl, PRB utilization rounded up
+    long tbErrTotalNbrDl1 = 0; //!< TB.ErrTotalNbrDl.1, MAC retransmissions
+    long qosFlowPdcpPduVolumeDlFilter = 0; //!< QosFlow.PdcpPduVolumeDL_Filter, MAC volume
+    long carrPdschmcsDistBin1 = 0; //!< CARR.PDSCHMCSDist.Bin1, MCS 0 to 4
+    long carrPdschmcsDistBin2 = 0; //!< CARR.PDSCHMCSDist.Bin2, MCS 5 to 9
+    long carrPdschmcsDistBin3 = 0; //!< CARR.PDSCHMCSDist.Bin3, MCS 10 to 14
+    long carrPdschmcsDistBin4 = 0; //!< CARR.PDSCHMCSDist.Bin4, MCS 15 to 19
+    long carrPdschmcsDistBin5 = 0; //!< CARR.PDSCHMCSDist.Bin5, MCS 20 to 24
+    long carrPdschmcsDistBin6 = 0; //!< CARR.PDSCHMCSDist.Bin6, MCS 25 to 29
+    long l1MRsSinrBin34 = 0; //!< L1M.RS-SINR.Bin34
+    long l1MRsSinrBin46 = 0; //!< L1M.RS-SINR.Bin46
+    long l1MRsSinrBin58 = 0; //!< L1M.RS-SINR.Bin58
+    long l1MRsSinrBin70 = 0; //!< L1M.RS-SINR.Bin70
+    long l1MRsSinrBin82 = 0; //!< L1M.RS-SINR.Bin82
+    long l1MRsSinrBin94 = 0; //!< L1M.RS-SINR.Bin94
+    long l1MRsSinrBin127 = 0; //!< L1M.RS-SINR.Bin127
+    long drbBufferSizeQos = 0; //!< DRB.BufferSize.Qos, RLC buffer occupancy
+    long drbMeanActiveUeDl = 0; //!< DRB.MeanActiveUeDl, active UEs
+  };
+
   MmWaveIndicationMessageHelper (IndicationMessageType type, bool isOffline, bool reducedPmValues);
 
   ~MmWaveIndicationMessageHelper ();
@@ -44,6 +104,21 @@ public:
   
   void FillDuValues (std::string cellObjectId);
 
+  /**
+   * Add the DU KPIs of a UE
+   *
+   * \param ueImsiComplete the IMSI of the UE
+   * \param kpis the KPIs
+   */
+  void AddDuUePmItem (std::string ueImsiComplete, const DuUeKpis &kpis);
+
+  /**
+   * Add the DU KPIs of the cell
+   *
+   * \param kpis the KPIs
+   */
+  void AddDuCellPmItem (const DuCellKpis &kpis);
+
   void AddDuUePmItem (std::string ueImsiComplete, long macPduUe, long macPduInitialUe, long macQpsk,
                       long mac16Qam, long mac64Qam, long macRetx, long macVolume, long macPrb,
                       long macMac04, long macMac59, long macMac1014, long macMac1519,
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/asn1c-arena.h>
+#include <ns3/log.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Asn1cArena");
+
+static const size_t ARENA_ALIGNMENT = alignof (std::max_align_t);
+
+Asn1cArena::Asn1cArena (size_t blockSize)
+  : m_currentBlock (0),
+    m_offset (0),
+    m_blockSize (blockSize),
+    m_usedBytes (0)
+{
+  AddBlock (m_blockSize);
+}
+
+Asn1cArena::~Asn1cArena ()
+{
+  for (auto &block : m_blocks)
+    {
+      free (block.m_data);
+    }
+  m_blocks.clear ();
+}
+
+void
+Asn1cArena::AddBlock (size_t size)
+{
+  Block block;
+  block.m_size = std::max (size, m_blockSize);
+  block.m_data = (uint8_t *) malloc (block.m_size);
+  if (block.m_data == nullptr)
+    {
+      NS_FATAL_ERROR ("Unable to allocate a block of " << block.m_size << " bytes for the arena");
+    }
+  NS_LOG_LOGIC ("Arena " << this << " added a block of " << block.m_size << " bytes");
+  m_blocks.push_back (block);
+}
+
+void*
+Asn1cArena::Allocate (size_t size)
+{
+  size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+  if (size == 0)
+    {
+      size = ARENA_ALIGNMENT;
+    }
+
+  while (m_offset + size > m_blocks[m_currentBlock].m_size)
+    {
+      // move to the next block, creating it if this is the last one
+      if (m_currentBlock + 1 == m_blocks.size ())
+        {
+          AddBlock (size);
+        }
+      m_currentBlock++;
+      m_offset = 0;
+    }
+
+  uint8_t *ptr = m_blocks[m_currentBlock].m_data + m_offset;
+  m_offset += size;
+  m_usedBytes += size;
+  memset (ptr, 0, size);
+  return ptr;
+}
+
+uint8_t*
+Asn1cArena::Copy (const void* data, size_t size)
+{
+  uint8_t *ptr = (uint8_t *) Allocate (size);
+  memcpy (ptr, data, size);
+  return ptr;
+}
+
+void
+Asn1cArena::Reset ()
+{
+  if (m_blocks.size () > 1)
+    {
+      // coalesce the blocks, so that the next tree of the same size
+      // fits in a single block
+      size_t total = 0;
+      for (auto &block : m_blocks)
+        {
+          total += block.m_size;
+          free (block.m_data);
+        }
+      m_blocks.clear ();
+      AddBlock (total);
+    }
+  m_currentBlock = 0;
+  m_offset = 0;
+  m_usedBytes = 0;
+}
+
+size_t
+Asn1cArena::GetUsedBytes () const
+{
+  return m_usedBytes;
+}
+
+}
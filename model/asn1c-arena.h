@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef ASN1C_ARENA_H
+#define ASN1C_ARENA_H
+
+#include "ns3/object.h"
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Bump allocator for the asn1c structure trees built before an encoding.
+  *
+  * All the nodes of a tree are carved out of a few large blocks and are
+  * released together by Reset, instead of being freed one by one with
+  * ASN_STRUCT_FREE. A tree allocated from the arena must therefore never
+  * be passed to ASN_STRUCT_FREE, and lists inside it must not be grown
+  * with ASN_SEQUENCE_ADD, since asn1c would realloc the arena memory:
+  * use AllocateList and AddToList instead.
+  *
+  * The blocks are kept across Reset, so once the arena has grown to
+  * the size of the largest tree no further allocation is performed.
+  */
+  class Asn1cArena
+  {
+  public:
+    /**
+    * \param blockSize size of the blocks requested to the system, in bytes
+    */
+    Asn1cArena (size_t blockSize = 16384);
+    ~Asn1cArena ();
+
+    /**
+    * Allocate zero-initialized memory, suitably aligned for any type
+    *
+    * \param size the number of bytes
+    * \return pointer to the memory
+    */
+    void* Allocate (size_t size);
+
+    /**
+    * Allocate a zero-initialized asn1c structure
+    *
+    * \return pointer to the structure
+    */
+    template<class T>
+    T* Allocate ()
+    {
+      return static_cast<T*> (Allocate (sizeof (T)));
+    }
+
+    /**
+    * Copy a buffer into the arena
+    *
+    * \param data the buffer to copy
+    * \param size the number of bytes to copy
+    * \return pointer to the copy
+    */
+    uint8_t* Copy (const void* data, size_t size);
+
+    /**
+    * Prepare an asn1c A_SEQUENCE_OF / A_SET_OF list to hold exactly
+    * capacity elements, with the element array taken from the arena
+    *
+    * \param list the list to prepare
+    * \param capacity the number of elements
+    */
+    template<class L>
+    void AllocateList (L* list, size_t capacity)
+    {
+      list->array = static_cast<decltype (list->array)> (
+          Allocate (capacity * sizeof (*list->array)));
+      list->count = 0;
+      list->size = capacity;
+    }
+
+    /**
+    * Append an element to a list prepared with AllocateList
+    *
+    * \param list the list
+    * \param item the element to append
+    */
+    template<class L, class T>
+    static void AddToList (L* list, T* item)
+    {
+      NS_ASSERT_MSG (list->count < list->size, "Arena list capacity exceeded");
+      list->array[list->count++] = item;
+    }
+
+    /**
+    * Release all the memory allocated so far.
+    * If the arena needed more than one block, they are replaced by a
+    * single block large enough to hold all of them.
+    */
+    void Reset ();
+
+    /**
+    * \return the number of bytes currently allocated from the arena
+    */
+    size_t GetUsedBytes () const;
+
+  private:
+    Asn1cArena (const Asn1cArena &) = delete;
+    Asn1cArena &operator= (const Asn1cArena &) = delete;
+
+    /**
+    * Add a new block able to hold at least size bytes
+    *
+    * \param size the requested size
+    */
+    void AddBlock (size_t size);
+
+    struct Block
+    {
+      uint8_t* m_data; //!< memory of the block
+      size_t m_size; //!< size of the block
+    };
+
+    std::vector<Block> m_blocks; //!< blocks owned by the arena
+    size_t m_currentBlock; //!< index of the block in use
+    size_t m_offset; //!< first free byte in the block in use
+    size_t m_blockSize; //!< default size of a new block
+    size_t m_usedBytes; //!< bytes allocated since the last Reset
+  };
+
+}
+
+#endif /* ASN1C_ARENA_H */
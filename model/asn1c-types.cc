@@ -23,6 +23,7 @@
  */
 
 #include <ns3/asn1c-types.h>
+#include <ns3/ran-parameter-walker.h>
 #include <ns3/log.h>
 
 NS_LOG_COMPONENT_DEFINE ("Asn1Types");
@@ -669,11 +670,12 @@ L3RrcMeasurements::L3RrcMeasurements (L3_RRC_Measurements_t *l3RrcMeasurements)
 
 L3RrcMeasurements::~L3RrcMeasurements ()
 {
-  // Memory deallocation is handled by RIC Indication Message 
-  // if (m_l3RrcMeasurements != NULL)
-  //   {
-  //     ASN_STRUCT_FREE (asn_DEF_L3_RRC_Measurements, m_l3RrcMeasurements);
-  //   }
+  // the items and lists carrying these measurements only reference the
+  // tree, which may be shared by several of them, so it is released here
+  if (m_l3RrcMeasurements != NULL)
+    {
+      ASN_STRUCT_FREE (asn_DEF_L3_RRC_Measurements, m_l3RrcMeasurements);
+    }
 }
 
 L3_RRC_Measurements *
@@ -800,16 +802,12 @@ MeasurementItem::MeasurementItem (std::string name)
 {
 
   m_measurementItem = (PM_Info_Item_t *) calloc (1, sizeof (PM_Info_Item_t));
-  m_pmType = (MeasurementType_t *) calloc (1, sizeof (MeasurementType_t));
-  m_measurementItem->pmType = *m_pmType;
 
-  m_measName =
-      (MeasurementTypeName_t *) calloc (1, sizeof (MeasurementTypeName_t));
-  m_measName->buf = (uint8_t *) calloc (1, sizeof (OCTET_STRING));
-  m_measName->size = name.length ();
-  memcpy (m_measName->buf, name.c_str (), m_measName->size);
+  MeasurementTypeName_t *measName = &m_measurementItem->pmType.choice.measName;
+  measName->buf = (uint8_t *) calloc (1, name.length ());
+  measName->size = name.length ();
+  memcpy (measName->buf, name.c_str (), measName->size);
 
-  m_measurementItem->pmType.choice.measName = *m_measName;
   m_measurementItem->pmType.present = MeasurementType_PR_measName;
 }
 
@@ -833,31 +831,26 @@ MeasurementItem::MeasurementItem (std::string name, Ptr<L3RrcMeasurements>value)
   NS_LOG_FUNCTION (this << name << "L3 RRC" << value);
   this->CreateMeasurementValue (MeasurementValue_PR_valueRRC);
   m_measurementItem->pmVal.choice.valueRRC = value->GetPointer ();
+  m_rrcValue = value;
 }
 
 void
 MeasurementItem::CreateMeasurementValue (MeasurementValue_PR measurementValue_PR)
 {
-  m_pmVal = ((MeasurementValue_t *) calloc (1, sizeof (MeasurementValue_t)));
-  m_measurementItem->pmVal = *m_pmVal;
   m_measurementItem->pmVal.present = measurementValue_PR;
 }
 
 MeasurementItem::~MeasurementItem ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_pmVal != NULL)
-    ASN_STRUCT_FREE (asn_DEF_MeasurementValue, m_pmVal);
-
-  if (m_measName != NULL)
+  // The item is only referenced by the RIC Indication Messages it is added
+  // to, so it is released here together with its name; the L3 RRC
+  // measurements tree, if any, is released by its L3RrcMeasurements
+  if (m_rrcValue != NULL)
     {
-      free (m_measName);
+      m_measurementItem->pmVal.choice.valueRRC = NULL;
     }
-
-  if (m_pmType != NULL)
-    ASN_STRUCT_FREE (asn_DEF_MeasurementType, m_pmType);
-
-  // TODO clear m_measurementItem
+  ASN_STRUCT_FREE (asn_DEF_PM_Info_Item, m_measurementItem);
 }
 
 PM_Info_Item_t *
@@ -885,78 +878,27 @@ std::vector<RANParameterItem>
 RANParameterItem::ExtractRANParametersFromRANParameter (RANParameter_Item_t *ranParameterItem)
 {
   std::vector<RANParameterItem> ranParameterList;
+  RanParameterWalker walker;
+  walker.Walk (ranParameterItem, [&ranParameterList] (const std::vector<RanParameterPathElement> &,
+                                                      const RanParameterView &value) {
+    ranParameterList.push_back (FromView (value));
+  });
+  return ranParameterList;
+}
 
-  // NS_LOG_DEBUG ("RAN Parameter examined:");
-  // xer_fprint (stderr, &asn_DEF_RANParameter_Item, ranParameterItem);
-  // NS_LOG_DEBUG ("----");
-  // NS_LOG_DEBUG (" ID " << ranParameterItem->ranParameterItem_ID);
-
-  switch (ranParameterItem->ranParameterItem_valueType->present)
+RANParameterItem
+RANParameterItem::FromView (const RanParameterView &view)
+{
+  RANParameterItem item (const_cast<RANParameter_Item_t *> (view.m_item));
+  item.m_keyFlag =
+      &view.m_item->ranParameterItem_valueType->choice.ranParameter_Element->keyFlag;
+  item.m_valueType = view.m_valueType;
+  item.m_valueInt = view.m_valueInt;
+  if (view.m_valueType == ValueType::OctectString)
     {
-      case RANParameter_ValueType_PR_NOTHING: {
-        NS_LOG_DEBUG ("[E2SM] RANParameter_ValueType_PR_NOTHING");
-        break;
-      }
-      case RANParameter_ValueType_PR_ranParameter_Element: {
-        RANParameterItem newItem =
-            RANParameterItem (ranParameterItem);
-        NS_LOG_DEBUG ("[E2SM] RANParameter_ValueType_PR_ranParameter_Element");
-        RANParameter_ELEMENT_t *ranParameterElement =
-            ranParameterItem->ranParameterItem_valueType->choice.ranParameter_Element;
-        newItem.m_keyFlag = &ranParameterElement->keyFlag;
-        switch (ranParameterElement->ranParameter_Value.present)
-          {
-            case RANParameter_Value_PR_NOTHING: {
-              NS_LOG_DEBUG ("[E2SM] RANParameter_Value_PR_NOTHING");
-              newItem.m_valueType = ValueType::Nothing;
-              break;
-            }
-            case RANParameter_Value_PR_valueInt: {
-              NS_LOG_DEBUG ("[E2SM] RANParameter_Value_PR_valueInt");
-              newItem.m_valueInt = ranParameterElement->ranParameter_Value.choice.valueInt;
-              newItem.m_valueType = ValueType::Int;
-              NS_LOG_DEBUG ("[E2SM] Value: " << newItem.m_valueInt);
-              break;
-            }
-            case RANParameter_Value_PR_valueOctS: {
-              NS_LOG_DEBUG ("[E2SM] RANParameter_Value_PR_valueOctS");
-              newItem.m_valueStr = Create<OctetString> (
-                  (void *) ranParameterElement->ranParameter_Value.choice.valueOctS.buf,
-                  ranParameterElement->ranParameter_Value.choice.valueOctS.size);
-              newItem.m_valueType = ValueType::OctectString;
-              NS_LOG_DEBUG ("[E2SM] Value: OctectString");
-              break;
-            }
-          }
-        ranParameterList.push_back (newItem);
-        break;
-      }
-      case RANParameter_ValueType_PR_ranParameter_Structure: {
-        NS_LOG_DEBUG ("[E2SM] RANParameter_ValueType_PR_ranParameter_Structure");
-        RANParameter_STRUCTURE_t *ranParameterStructure =
-            ranParameterItem->ranParameterItem_valueType->choice.ranParameter_Structure;
-        int count = ranParameterStructure->sequence_of_ranParameters.list.count;
-        for (int i = 0; i < count; i++)
-          {
-            RANParameter_Item_t *childRanItem =
-                ranParameterStructure->sequence_of_ranParameters.list.array[i];
-
-            for (RANParameterItem extractedParameter : ExtractRANParametersFromRANParameter (childRanItem))
-              {
-                ranParameterList.push_back (extractedParameter);
-              }
-          }
-        break;
-      }
-      case RANParameter_ValueType_PR_ranParameter_List: {
-        NS_LOG_DEBUG ("[E2SM] RANParameter_ValueType_PR_ranParameter_List");
-        // No list passed for the moment from RIC, thus no parsed as case
-        // ranParameterItem->ranParameterItem_valueType->choice.ranParameter_List;
-        break;
-      }
+      item.m_valueStr = Create<OctetString> ((void *) view.m_valueBuf, view.m_valueSize);
     }
-
-  return ranParameterList;
+  return item;
 }
 
 
@@ -267,6 +267,11 @@ class L3RrcMeasurements : public SimpleRefCount<L3RrcMeasurements>
 public:
   int MAX_MEAS_RESULTS_ITEMS = 8; // Maximum 8 per UE (standard)
   L3RrcMeasurements (RRCEvent_t rrcEvent);
+  /**
+  * Wrap an existing tree, which is then owned and released by this object
+  *
+  * \param l3RrcMeasurements the tree
+  */
   L3RrcMeasurements (L3_RRC_Measurements_t *l3RrcMeasurements);
   ~L3RrcMeasurements ();
   L3_RRC_Measurements_t *GetPointer ();
@@ -319,15 +324,13 @@ public:
 private:
   MeasurementItem (std::string name);
   void CreateMeasurementValue (MeasurementValue_PR measurementValue_PR);
-  // Main struct to be compiled
+  // Main struct to be compiled, owned by this object
   PM_Info_Item_t *m_measurementItem;
-
-  // Accessory structs that we must track to release memory after use
-  MeasurementTypeName_t *m_measName;
-  MeasurementValue_t *m_pmVal;
-  MeasurementType_t *m_pmType;
+  Ptr<L3RrcMeasurements> m_rrcValue; //!< owner of the L3 RRC measurements tree, if any
 };
 
+struct RanParameterView;
+
 /**
 * Wrapper for class for RANParameter_Item_t 
 */
@@ -347,6 +350,14 @@ public:
   static std::vector<RANParameterItem>
   ExtractRANParametersFromRANParameter (RANParameter_Item_t *ranParameterItem);
 
+  /**
+  * Wrap a value visited by RanParameterWalker
+  *
+  * \param view the value
+  * \return the wrapper of the value
+  */
+  static RANParameterItem FromView (const RanParameterView &view);
+
 private:
   // Main struct
   RANParameter_Item_t *m_ranParameterItem;
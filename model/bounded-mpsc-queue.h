@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef BOUNDED_MPSC_QUEUE_H
+#define BOUNDED_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ns3 {
+
+  /**
+  * Bounded lock-free queue with multiple producers and a single consumer.
+  *
+  * The implementation is the classic ring of cells tagged with a
+  * sequence number (D. Vyukov, "Bounded MPMC queue"), restricted to a
+  * single consumer. Producers only contend on the tail index with a CAS,
+  * and neither side ever takes a lock or allocates memory after the
+  * construction.
+  */
+  template<class T>
+  class BoundedMpscQueue
+  {
+  public:
+    /**
+    * \param capacity the maximum number of elements, rounded up to the
+    *        next power of two
+    */
+    BoundedMpscQueue (size_t capacity)
+    {
+      size_t size = 1;
+      while (size < capacity)
+        {
+          size <<= 1;
+        }
+      m_mask = size - 1;
+      m_cells.reset (new Cell[size]);
+      for (size_t i = 0; i < size; i++)
+        {
+          m_cells[i].m_sequence.store (i, std::memory_order_relaxed);
+        }
+      m_tail.store (0, std::memory_order_relaxed);
+      m_head.store (0, std::memory_order_relaxed);
+    }
+
+    /**
+    * Append an element, may be called by any thread
+    *
+    * \param value the element
+    * \return false if the queue is full
+    */
+    bool TryPush (T value)
+    {
+      Cell *cell;
+      size_t pos = m_tail.load (std::memory_order_relaxed);
+      for (;;)
+        {
+          cell = &m_cells[pos & m_mask];
+          size_t seq = cell->m_sequence.load (std::memory_order_acquire);
+          intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+          if (diff == 0)
+            {
+              if (m_tail.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+                {
+                  break;
+                }
+            }
+          else if (diff < 0)
+            {
+              return false;
+            }
+          else
+            {
+              pos = m_tail.load (std::memory_order_relaxed);
+            }
+        }
+      cell->m_value = std::move (value);
+      cell->m_sequence.store (pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * Remove the oldest element, must only be called by the consumer thread
+    *
+    * \param value filled with the element
+    * \return false if the queue is empty
+    */
+    bool TryPop (T &value)
+    {
+      size_t pos = m_head.load (std::memory_order_relaxed);
+      Cell *cell = &m_cells[pos & m_mask];
+      size_t seq = cell->m_sequence.load (std::memory_order_acquire);
+      if ((intptr_t) seq - (intptr_t) (pos + 1) < 0)
+        {
+          return false;
+        }
+      value = std::move (cell->m_value);
+      cell->m_sequence.store (pos + m_mask + 1, std::memory_order_release);
+      m_head.store (pos + 1, std::memory_order_release);
+      return true;
+    }
+
+    /**
+    * \return the number of elements in the queue; the value is only
+    *         approximate while producers or the consumer are active
+    */
+    size_t GetSize () const
+    {
+      size_t head = m_head.load (std::memory_order_acquire);
+      size_t tail = m_tail.load (std::memory_order_acquire);
+      return tail > head ? tail - head : 0;
+    }
+
+    /**
+    * \return the maximum number of elements
+    */
+    size_t GetCapacity () const
+    {
+      return m_mask + 1;
+    }
+
+  private:
+    BoundedMpscQueue (const BoundedMpscQueue &) = delete;
+    BoundedMpscQueue &operator= (const BoundedMpscQueue &) = delete;
+
+    struct Cell
+    {
+      std::atomic<size_t> m_sequence; //!< position the cell is ready for
+      T m_value; //!< stored element
+    };
+
+    std::unique_ptr<Cell[]> m_cells; //!< ring of cells
+    size_t m_mask; //!< capacity - 1
+    alignas (64) std::atomic<size_t> m_tail; //!< next position to write
+    alignas (64) std::atomic<size_t> m_head; //!< next position to read
+  };
+
+}
+
+#endif /* BOUNDED_MPSC_QUEUE_H */
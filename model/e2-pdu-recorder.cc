@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/e2-pdu-recorder.h>
+#include <ns3/log.h>
+#include <ns3/abort.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("E2PduRecorder");
+
+/**
+* Write the least significant bytes of a value, little-endian
+*
+* \param out the destination
+* \param value the value
+* \param bytes the number of bytes
+*/
+static void
+PutLittleEndian (uint8_t *out, uint64_t value, size_t bytes)
+{
+  for (size_t i = 0; i < bytes; i++)
+    {
+      out[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+E2PduRecorder::E2PduRecorder (const std::string &fileName)
+  : m_nPdus (0)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_file.open (fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!m_file.is_open (), "Unable to open the E2 record file " << fileName);
+
+  uint8_t header[FILE_HEADER_SIZE] = {'E', '2', 'R', 'C'};
+  PutLittleEndian (header + 4, 1, 2);
+  PutLittleEndian (header + 6, 0, 2);
+  m_file.write ((const char *) header, sizeof (header));
+}
+
+E2PduRecorder::~E2PduRecorder ()
+{
+  NS_LOG_FUNCTION (this);
+  m_file.close ();
+}
+
+void
+E2PduRecorder::Record (Time timestamp, const uint8_t *buffer, size_t size)
+{
+  uint8_t header[RECORD_HEADER_SIZE];
+  PutLittleEndian (header, timestamp.GetNanoSeconds (), 8);
+  PutLittleEndian (header + 8, size, 4);
+
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_file.write ((const char *) header, sizeof (header));
+  m_file.write ((const char *) buffer, size);
+  NS_ABORT_MSG_IF (!m_file, "Error while writing the E2 record file");
+  m_nPdus++;
+}
+
+uint64_t
+E2PduRecorder::GetNPdus () const
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  return m_nPdus;
+}
+
+} // namespace ns3
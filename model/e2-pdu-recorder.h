@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef E2_PDU_RECORDER_H
+#define E2_PDU_RECORDER_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace ns3 {
+
+  /**
+  * Records encoded E2AP PDUs to a file, e.g., to replay the outbound
+  * stream of an E2 termination with E2PduReplayer.
+  *
+  * File layout, all integers little-endian: magic "E2RC", uint16 version
+  * (1), 2 reserved bytes, then one record per PDU made of an int64
+  * timestamp in nanoseconds, a uint32 length and the APER encoding of the
+  * PDU. Records can be written by several threads.
+  */
+  class E2PduRecorder
+  {
+  public:
+    /**
+    * Open a record file, replacing any existing file
+    *
+    * \param fileName the name of the file
+    */
+    E2PduRecorder (const std::string &fileName);
+    ~E2PduRecorder ();
+
+    /**
+    * Append a PDU
+    *
+    * \param timestamp the simulation time the PDU was sent at
+    * \param buffer the encoded PDU
+    * \param size the size of the PDU
+    */
+    void Record (Time timestamp, const uint8_t *buffer, size_t size);
+
+    /**
+    * \return the number of PDUs recorded
+    */
+    uint64_t GetNPdus () const;
+
+    /**
+    * Size of the file header
+    */
+    static const size_t FILE_HEADER_SIZE = 8;
+
+    /**
+    * Size of the header of a record
+    */
+    static const size_t RECORD_HEADER_SIZE = 12;
+
+  private:
+    mutable std::mutex m_mutex; //!< serializes the records
+    std::ofstream m_file; //!< the record file
+    uint64_t m_nPdus; //!< PDUs recorded
+  };
+
+} // namespace ns3
+
+#endif /* E2_PDU_RECORDER_H */
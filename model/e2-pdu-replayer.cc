@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/e2-pdu-replayer.h>
+#include <ns3/e2-pdu-recorder.h>
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("E2PduReplayer");
+
+/**
+* Read a little-endian value
+*
+* \param in the source
+* \param bytes the number of bytes
+* \return the value
+*/
+static uint64_t
+GetLittleEndian (const uint8_t *in, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; i++)
+    {
+      value |= (uint64_t) in[i] << (8 * i);
+    }
+  return value;
+}
+
+E2PduReplayer::E2PduReplayer (const std::string &fileName)
+  : m_data (nullptr),
+    m_size (0),
+    m_nPdus (0),
+    m_stop (false),
+    m_sentPdus (0)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  int fd = open (fileName.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Unable to open the E2 record file " << fileName
+                                                                 << ": " << strerror (errno));
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0, "Unable to stat the E2 record file " << fileName);
+  m_size = st.st_size;
+  NS_ABORT_MSG_IF (m_size < E2PduRecorder::FILE_HEADER_SIZE,
+                   "The E2 record file " << fileName << " is truncated");
+
+  void *data = mmap (nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  NS_ABORT_MSG_IF (data == MAP_FAILED, "Unable to map the E2 record file " << fileName
+                                                                          << ": " << strerror (errno));
+  m_data = (const uint8_t *) data;
+  madvise (data, m_size, MADV_SEQUENTIAL);
+
+  NS_ABORT_MSG_IF (memcmp (m_data, "E2RC", 4) != 0 || GetLittleEndian (m_data + 4, 2) != 1,
+                   fileName << " is not an E2 record file");
+
+  size_t offset = E2PduRecorder::FILE_HEADER_SIZE;
+  while (offset < m_size)
+    {
+      NS_ABORT_MSG_IF (m_size - offset < E2PduRecorder::RECORD_HEADER_SIZE,
+                       "The E2 record file " << fileName << " is truncated");
+      size_t length = GetLittleEndian (m_data + offset + 8, 4);
+      offset += E2PduRecorder::RECORD_HEADER_SIZE;
+      NS_ABORT_MSG_IF (m_size - offset < length,
+                       "The E2 record file " << fileName << " is truncated");
+      offset += length;
+      m_nPdus++;
+    }
+  NS_LOG_INFO ("Mapped " << m_nPdus << " PDUs from " << fileName);
+}
+
+E2PduReplayer::~E2PduReplayer ()
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  munmap ((void *) m_data, m_size);
+}
+
+void
+E2PduReplayer::Start (Ptr<E2Termination> termination, double speed, uint32_t loops)
+{
+  NS_LOG_FUNCTION (this << speed << loops);
+  NS_ABORT_MSG_IF (m_thread.joinable (), "The replay is already running");
+  NS_ABORT_MSG_IF (speed < 0, "The replay speed cannot be negative");
+
+  // the thread only sees a raw pointer, since the reference count of Ptr
+  // is not thread safe
+  m_termination = termination;
+  m_stop = false;
+  m_sentPdus = 0;
+  m_thread = std::thread (&E2PduReplayer::DoReplay, this, PeekPointer (termination), speed, loops);
+}
+
+void
+E2PduReplayer::Stop ()
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_stopMutex);
+    m_stop = true;
+  }
+  m_stopCondition.notify_all ();
+  Wait ();
+}
+
+void
+E2PduReplayer::Wait ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_thread.joinable ())
+    {
+      m_thread.join ();
+    }
+  m_termination = nullptr;
+}
+
+uint64_t
+E2PduReplayer::GetNPdus () const
+{
+  return m_nPdus;
+}
+
+uint64_t
+E2PduReplayer::GetSentPdus () const
+{
+  return m_sentPdus;
+}
+
+void
+E2PduReplayer::DoReplay (E2Termination* termination, double speed, uint32_t loops)
+{
+  if (m_nPdus == 0)
+    {
+      return;
+    }
+  for (uint32_t loop = 0; loop < loops && !m_stop; loop++)
+    {
+      auto start = std::chrono::steady_clock::now ();
+      int64_t firstTimestamp = GetLittleEndian (m_data + E2PduRecorder::FILE_HEADER_SIZE, 8);
+      size_t offset = E2PduRecorder::FILE_HEADER_SIZE;
+      while (offset < m_size && !m_stop)
+        {
+          int64_t timestamp = GetLittleEndian (m_data + offset, 8);
+          size_t length = GetLittleEndian (m_data + offset + 8, 4);
+          const uint8_t *pdu = m_data + offset + E2PduRecorder::RECORD_HEADER_SIZE;
+          offset += E2PduRecorder::RECORD_HEADER_SIZE + length;
+
+          if (speed > 0)
+            {
+              std::chrono::nanoseconds gap ((int64_t) ((timestamp - firstTimestamp) / speed));
+              std::unique_lock<std::mutex> lock (m_stopMutex);
+              if (m_stopCondition.wait_until (lock, start + gap, [this] { return m_stop.load (); }))
+                {
+                  break;
+                }
+            }
+
+          termination->SendEncoded (pdu, length);
+          m_sentPdus++;
+        }
+    }
+  NS_LOG_INFO ("Replayed " << m_sentPdus << " PDUs");
+}
+
+} // namespace ns3
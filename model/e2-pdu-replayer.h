@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef E2_PDU_REPLAYER_H
+#define E2_PDU_REPLAYER_H
+
+#include "ns3/object.h"
+#include "ns3/oran-interface.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ns3 {
+
+  /**
+  * Replays a file written by E2PduRecorder through an E2 termination,
+  * e.g., to load a near-RT RIC with a recorded E2 stream without running
+  * the simulation again.
+  *
+  * The file is memory-mapped and, with the REACTOR transport, each PDU is
+  * written to the socket directly from the mapping, byte for byte and
+  * without allocating per message. With the E2SIM transport e2sim does not
+  * take encoded PDUs, so each PDU is decoded and encoded again by e2sim,
+  * which allocates per message and may not reproduce the exact bytes
+  * recorded. A dedicated thread
+  * paces the PDUs on the wall clock, keeping the recorded gaps scaled by a
+  * speed factor, or sending them back to back.
+  */
+  class E2PduReplayer : public SimpleRefCount<E2PduReplayer>
+  {
+  public:
+    /**
+    * Map a record file and check its records
+    *
+    * \param fileName the name of the file
+    */
+    E2PduReplayer (const std::string &fileName);
+    ~E2PduReplayer ();
+
+    /**
+    * Start replaying the file on a dedicated thread. The termination must
+    * outlive the replay, see Wait and Stop.
+    *
+    * \param termination the E2 termination sending the PDUs
+    * \param speed the scaling of the recorded gaps, e.g., 2 replays twice
+    *        as fast, while 0 sends the PDUs back to back
+    * \param loops the number of times the file is replayed
+    */
+    void Start (Ptr<E2Termination> termination, double speed = 1.0, uint32_t loops = 1);
+
+    /**
+    * Interrupt the replay and wait for the thread to exit
+    */
+    void Stop ();
+
+    /**
+    * Wait until the replay ends
+    */
+    void Wait ();
+
+    /**
+    * \return the number of PDUs in the file
+    */
+    uint64_t GetNPdus () const;
+
+    /**
+    * \return the number of PDUs sent since the last Start
+    */
+    uint64_t GetSentPdus () const;
+
+  private:
+    /**
+    * Body of the replay thread
+    *
+    * \param termination the E2 termination sending the PDUs
+    * \param speed the scaling of the recorded gaps
+    * \param loops the number of times the file is replayed
+    */
+    void DoReplay (E2Termination* termination, double speed, uint32_t loops);
+
+    const uint8_t* m_data; //!< the mapped file
+    size_t m_size; //!< the size of the mapped file
+    uint64_t m_nPdus; //!< PDUs in the file
+    std::thread m_thread; //!< the replay thread
+    std::atomic<bool> m_stop; //!< asks the replay thread to exit
+    std::mutex m_stopMutex; //!< protects the wait on m_stopCondition
+    std::condition_variable m_stopCondition; //!< wakes up the replay thread on Stop
+    std::atomic<uint64_t> m_sentPdus; //!< PDUs sent since the last Start
+    Ptr<E2Termination> m_termination; //!< keeps the termination alive during the replay
+  };
+
+} // namespace ns3
+
+#endif /* E2_PDU_REPLAYER_H */
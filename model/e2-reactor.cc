@@ -0,0 +1,220 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/e2-reactor.h>
+#include <ns3/log.h>
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+#include <algorithm>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("E2Reactor");
+
+static GlobalValue g_e2ReactorThreads =
+    GlobalValue ("E2ReactorThreads",
+                 "Number of threads of the event loop shared by the E2 terminations "
+                 "using the Reactor transport",
+                 UintegerValue (1), MakeUintegerChecker<uint32_t> (1));
+
+static const int MAX_EVENTS = 64;
+
+E2Reactor::E2Reactor (uint32_t numThreads)
+  : m_nextLoop (0),
+    m_running (true)
+{
+  NS_LOG_FUNCTION (this << numThreads);
+  for (uint32_t i = 0; i < numThreads; i++)
+    {
+      Loop *loop = new Loop;
+      loop->m_epollFd = epoll_create1 (EPOLL_CLOEXEC);
+      loop->m_wakeFd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+      if (loop->m_epollFd < 0 || loop->m_wakeFd < 0)
+        {
+          NS_FATAL_ERROR ("Unable to create the reactor event loop, errno: " << strerror (errno));
+        }
+
+      // the wake up descriptor is identified by a null registration
+      struct epoll_event ev;
+      ev.events = EPOLLIN;
+      ev.data.ptr = nullptr;
+      epoll_ctl (loop->m_epollFd, EPOLL_CTL_ADD, loop->m_wakeFd, &ev);
+
+      loop->m_thread = std::thread (&E2Reactor::Run, this, loop);
+      m_loops.push_back (loop);
+    }
+}
+
+E2Reactor::~E2Reactor ()
+{
+  NS_LOG_FUNCTION (this);
+  m_running = false;
+  for (auto loop : m_loops)
+    {
+      uint64_t one = 1;
+      if (write (loop->m_wakeFd, &one, sizeof (one)) < 0)
+        {
+          NS_LOG_ERROR ("Unable to wake up the reactor loop, errno: " << strerror (errno));
+        }
+      loop->m_thread.join ();
+      for (auto registration : loop->m_registrations)
+        {
+          delete registration;
+        }
+      for (auto registration : loop->m_retired)
+        {
+          delete registration;
+        }
+      close (loop->m_wakeFd);
+      close (loop->m_epollFd);
+      delete loop;
+    }
+  m_loops.clear ();
+}
+
+Ptr<E2Reactor>
+E2Reactor::GetInstance ()
+{
+  // the number of threads is read when the reactor is first used
+  static Ptr<E2Reactor> instance = [] () {
+    UintegerValue numThreads;
+    g_e2ReactorThreads.GetValue (numThreads);
+    return Create<E2Reactor> (numThreads.Get ());
+  }();
+  return instance;
+}
+
+void
+E2Reactor::Register (int fd, Handler handler)
+{
+  NS_LOG_FUNCTION (this << fd);
+
+  Loop *loop;
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    loop = m_loops[m_nextLoop];
+    m_nextLoop = (m_nextLoop + 1) % m_loops.size ();
+  }
+
+  Registration *registration = new Registration;
+  registration->m_fd = fd;
+  registration->m_handler = handler;
+  registration->m_active = true;
+
+  {
+    std::lock_guard<std::recursive_mutex> lock (loop->m_mutex);
+    loop->m_registrations.push_back (registration);
+  }
+
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLRDHUP;
+  ev.data.ptr = registration;
+  if (epoll_ctl (loop->m_epollFd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+      NS_FATAL_ERROR ("Unable to add socket " << fd << " to the reactor, errno: "
+                                              << strerror (errno));
+    }
+}
+
+void
+E2Reactor::Unregister (int fd)
+{
+  NS_LOG_FUNCTION (this << fd);
+
+  for (auto loop : m_loops)
+    {
+      std::lock_guard<std::recursive_mutex> lock (loop->m_mutex);
+      auto it = std::find_if (loop->m_registrations.begin (), loop->m_registrations.end (),
+                              [fd] (Registration *r) { return r->m_fd == fd; });
+      if (it == loop->m_registrations.end ())
+        {
+          continue;
+        }
+
+      epoll_ctl (loop->m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+      (*it)->m_active = false;
+      // an event for this socket may already have been returned to the
+      // loop, so the registration is released by the loop itself before
+      // waiting for the next events
+      loop->m_retired.push_back (*it);
+      loop->m_registrations.erase (it);
+      return;
+    }
+}
+
+void
+E2Reactor::Run (Loop* loop)
+{
+  NS_LOG_FUNCTION (this << loop);
+
+  struct epoll_event events[MAX_EVENTS];
+  std::vector<Registration*> retired;
+  while (m_running)
+    {
+      {
+        std::lock_guard<std::recursive_mutex> lock (loop->m_mutex);
+        retired.swap (loop->m_retired);
+      }
+      for (auto registration : retired)
+        {
+          delete registration;
+        }
+      retired.clear ();
+
+      int n = epoll_wait (loop->m_epollFd, events, MAX_EVENTS, -1);
+      if (n < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          NS_FATAL_ERROR ("Error in the reactor event loop, errno: " << strerror (errno));
+        }
+
+      for (int i = 0; i < n; i++)
+        {
+          Registration *registration = static_cast<Registration *> (events[i].data.ptr);
+          if (registration == nullptr)
+            {
+              // wake up request, m_running is checked by the loop
+              continue;
+            }
+
+          // the lock is held while the handler runs, so that Unregister
+          // waits for it to complete
+          std::lock_guard<std::recursive_mutex> lock (loop->m_mutex);
+          if (registration->m_active)
+            {
+              registration->m_handler (events[i].events);
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef E2_REACTOR_H
+#define E2_REACTOR_H
+
+#include "ns3/object.h"
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Event loop multiplexing the sockets of many E2 terminations.
+  *
+  * The reactor runs a fixed number of threads, set with the global value
+  * E2ReactorThreads, each owning an epoll instance. Sockets are spread
+  * across the threads in round robin, and the handler registered for a
+  * socket is always invoked by the same thread, so that the handlers of
+  * a termination never run concurrently with each other.
+  * A single reactor is shared by all the terminations of the process.
+  */
+  class E2Reactor : public SimpleRefCount<E2Reactor>
+  {
+  public:
+    /**
+    * Handler invoked when a socket is readable or has an error.
+    * The argument is the epoll event mask.
+    */
+    typedef std::function<void (uint32_t)> Handler;
+
+    /**
+    * \param numThreads the number of event loop threads
+    */
+    E2Reactor (uint32_t numThreads);
+    ~E2Reactor ();
+
+    /**
+    * Get the reactor shared by the process, creating it on first use
+    *
+    * \return the reactor
+    */
+    static Ptr<E2Reactor> GetInstance ();
+
+    /**
+    * Start monitoring a socket
+    *
+    * \param fd the socket
+    * \param handler the handler invoked on the reactor thread
+    */
+    void Register (int fd, Handler handler);
+
+    /**
+    * Stop monitoring a socket. When the call returns the handler is not
+    * running, unless the call is made from the handler itself, and it is
+    * not invoked anymore.
+    *
+    * \param fd the socket
+    */
+    void Unregister (int fd);
+
+  private:
+    E2Reactor (const E2Reactor &) = delete;
+    E2Reactor &operator= (const E2Reactor &) = delete;
+
+    /**
+    * A socket monitored by a loop
+    */
+    struct Registration
+    {
+      int m_fd; //!< the socket
+      Handler m_handler; //!< the handler
+      bool m_active; //!< false once unregistered
+    };
+
+    /**
+    * An event loop thread with its epoll instance
+    */
+    struct Loop
+    {
+      int m_epollFd; //!< epoll instance
+      int m_wakeFd; //!< eventfd used to stop the loop
+      std::thread m_thread; //!< thread running the loop
+      std::recursive_mutex m_mutex; //!< protects the registrations, held while a handler runs
+      std::vector<Registration*> m_registrations; //!< sockets monitored by the loop
+      std::vector<Registration*> m_retired; //!< unregistered sockets, released by the loop
+    };
+
+    /**
+    * Body of a loop thread
+    *
+    * \param loop the loop
+    */
+    void Run (Loop* loop);
+
+    std::vector<Loop*> m_loops; //!< event loops
+    std::mutex m_mutex; //!< protects m_nextLoop
+    uint32_t m_nextLoop; //!< loop that gets the next registration
+    std::atomic<bool> m_running; //!< false when the loops must exit
+  };
+
+}
+
+#endif /* E2_REACTOR_H */
@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/e2ap-indication-envelope.h>
+#include <ns3/log.h>
+#include <atomic>
+
+extern "C" {
+  #include "InitiatingMessage.h"
+  #include "ProtocolIE-Field.h"
+  #include "RICindication.h"
+}
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("E2apIndicationEnvelope");
+
+// lengths from this value on are fragmented by APER (X.691 11.9.3.8)
+static const size_t APER_FRAGMENT_SIZE = 16384;
+
+// position of the IEs in the RIC Indication
+static const int SN_IE_INDEX = 3;
+static const int HEADER_IE_INDEX = 5;
+static const int MESSAGE_IE_INDEX = 6;
+static const int N_IES = 7;
+
+// set once an encoding of asn1c did not match the layout of the envelope,
+// in which case no further envelope is created
+static std::atomic<bool> g_layoutMismatch (false);
+
+/**
+* \param length a length smaller than APER_FRAGMENT_SIZE
+* \return the size of its APER length determinant
+*/
+static size_t
+GetAperLengthSize (size_t length)
+{
+  return length < 128 ? 1 : 2;
+}
+
+/**
+* Write an APER unconstrained length determinant
+*
+* \param out the destination
+* \param length a length smaller than APER_FRAGMENT_SIZE
+* \return the first byte after the length determinant
+*/
+static uint8_t *
+WriteAperLength (uint8_t *out, size_t length)
+{
+  if (length < 128)
+    {
+      *out++ = (uint8_t) length;
+    }
+  else
+    {
+      *out++ = (uint8_t) (0x80 | (length >> 8));
+      *out++ = (uint8_t) (length & 0xFF);
+    }
+  return out;
+}
+
+/**
+* Encode a structure in APER
+*
+* \param type the asn1c descriptor of the structure
+* \param structure the structure
+* \return the encoding
+*/
+static std::vector<uint8_t>
+EncodeToVector (const asn_TYPE_descriptor_t *type, const void *structure)
+{
+  EncodeBuffer buffer;
+  size_t size = buffer.Encode (type, structure);
+  return std::vector<uint8_t> (buffer.GetData (), buffer.GetData () + size);
+}
+
+/**
+* \param bytes the bytes
+* \param suffix the suffix
+* \return true if bytes ends with suffix
+*/
+static bool
+EndsWith (const std::vector<uint8_t> &bytes, const std::vector<uint8_t> &suffix)
+{
+  return bytes.size () >= suffix.size ()
+         && std::equal (suffix.begin (), suffix.end (), bytes.end () - suffix.size ());
+}
+
+/**
+* Split the encoding of an IE carrying an OCTET STRING into the bytes
+* preceding the length of the IE value and the value, checking that the
+* value is the encoding of the OCTET STRING
+*
+* \param ie the encoding of the IE
+* \param octetString the OCTET STRING
+* \param prefix filled with the bytes preceding the length of the IE value
+* \return true if the encoding has the expected layout
+*/
+static bool
+SplitOctetStringIe (const std::vector<uint8_t> &ie, const OCTET_STRING_t &octetString,
+                    std::vector<uint8_t> &prefix)
+{
+  size_t valueSize = GetAperLengthSize (octetString.size) + octetString.size;
+  std::vector<uint8_t> suffix (GetAperLengthSize (valueSize) + valueSize);
+  uint8_t *out = WriteAperLength (suffix.data (), valueSize);
+  out = WriteAperLength (out, octetString.size);
+  memcpy (out, octetString.buf, octetString.size);
+
+  if (!EndsWith (ie, suffix))
+    {
+      return false;
+    }
+  prefix.assign (ie.begin (), ie.end () - suffix.size ());
+  return true;
+}
+
+E2apIndicationEnvelope::E2apIndicationEnvelope ()
+  : m_snOffset (0)
+{
+}
+
+std::unique_ptr<E2apIndicationEnvelope>
+E2apIndicationEnvelope::Create (E2AP_PDU* pdu)
+{
+  if (g_layoutMismatch)
+    {
+      return nullptr;
+    }
+
+  RICindication_t *indication = &pdu->choice.initiatingMessage->value.choice.RICindication;
+  NS_ABORT_MSG_IF (indication->protocolIEs.list.count != N_IES,
+                   "Unexpected number of IEs in the RIC Indication");
+  RICindication_IEs_t **ies = indication->protocolIEs.list.array;
+  const OCTET_STRING_t &header = ies[HEADER_IE_INDEX]->value.choice.RICindicationHeader;
+  const OCTET_STRING_t &message = ies[MESSAGE_IE_INDEX]->value.choice.RICindicationMessage;
+
+  // the layout is only checked for lengths that are not fragmented
+  if (header.size + 4 >= APER_FRAGMENT_SIZE || message.size + 4 >= APER_FRAGMENT_SIZE)
+    {
+      return nullptr;
+    }
+
+  std::unique_ptr<E2apIndicationEnvelope> envelope (new E2apIndicationEnvelope ());
+
+  // the IEs are octet-aligned open types, so their standalone encodings
+  // are the same as the ones inside the RIC Indication
+  std::vector<uint8_t> ieEncodings[N_IES];
+  for (int i = 0; i < N_IES; i++)
+    {
+      ieEncodings[i] = EncodeToVector (&asn_DEF_RICindication_IEs, ies[i]);
+    }
+
+  // find the RIC Indication SN by encoding two values that differ in
+  // every bit
+  RICindicationSN_t sn = ies[SN_IE_INDEX]->value.choice.RICindicationSN;
+  ies[SN_IE_INDEX]->value.choice.RICindicationSN = 0x0102;
+  std::vector<uint8_t> snEncoding = EncodeToVector (&asn_DEF_RICindication_IEs, ies[SN_IE_INDEX]);
+  ies[SN_IE_INDEX]->value.choice.RICindicationSN = 0xFEFD;
+  std::vector<uint8_t> complementEncoding =
+      EncodeToVector (&asn_DEF_RICindication_IEs, ies[SN_IE_INDEX]);
+  ies[SN_IE_INDEX]->value.choice.RICindicationSN = sn;
+
+  bool layoutMatches = snEncoding.size () == complementEncoding.size ();
+  size_t snOffset = 0;
+  size_t differences = 0;
+  for (size_t i = 0; layoutMatches && i < snEncoding.size (); i++)
+    {
+      if (snEncoding[i] != complementEncoding[i])
+        {
+          if (differences == 0)
+            {
+              snOffset = i;
+            }
+          differences++;
+        }
+    }
+  layoutMatches = layoutMatches && differences == 2 && snEncoding[snOffset] == 0x01
+                  && snEncoding[snOffset + 1] == 0x02;
+
+  // header and message IEs
+  layoutMatches =
+      layoutMatches
+      && SplitOctetStringIe (ieEncodings[HEADER_IE_INDEX], header, envelope->m_headerIePrefix)
+      && SplitOctetStringIe (ieEncodings[MESSAGE_IE_INDEX], message, envelope->m_messageIePrefix);
+
+  // RIC Indication: list prefix followed by the IEs
+  std::vector<uint8_t> ieList;
+  for (int i = 0; i < N_IES; i++)
+    {
+      ieList.insert (ieList.end (), ieEncodings[i].begin (), ieEncodings[i].end ());
+    }
+  std::vector<uint8_t> indicationEncoding = EncodeToVector (&asn_DEF_RICindication, indication);
+  layoutMatches = layoutMatches && indicationEncoding.size () < APER_FRAGMENT_SIZE
+                  && EndsWith (indicationEncoding, ieList);
+
+  // E2AP PDU: prefix followed by the RIC Indication as an open type
+  std::vector<uint8_t> pduEncoding = EncodeToVector (&asn_DEF_E2AP_PDU, pdu);
+  std::vector<uint8_t> openType (GetAperLengthSize (indicationEncoding.size ()));
+  WriteAperLength (openType.data (), indicationEncoding.size ());
+  openType.insert (openType.end (), indicationEncoding.begin (), indicationEncoding.end ());
+  layoutMatches = layoutMatches && EndsWith (pduEncoding, openType);
+
+  if (layoutMatches)
+    {
+      envelope->m_pduPrefix.assign (pduEncoding.begin (), pduEncoding.end () - openType.size ());
+      envelope->m_listPrefix.assign (indicationEncoding.begin (),
+                                     indicationEncoding.end () - ieList.size ());
+      for (int i = 0; i < HEADER_IE_INDEX; i++)
+        {
+          if (i == SN_IE_INDEX)
+            {
+              envelope->m_snOffset = envelope->m_fixedIes.size () + snOffset;
+            }
+          envelope->m_fixedIes.insert (envelope->m_fixedIes.end (), ieEncodings[i].begin (),
+                                       ieEncodings[i].end ());
+        }
+
+      // finally, the envelope must reproduce the encoding of asn1c
+      Ptr<EncodeBuffer> check = ns3::Create<EncodeBuffer> ();
+      layoutMatches = envelope->Encode (check, sn, header.buf, header.size, message.buf,
+                                        message.size)
+                      && check->GetSize () == pduEncoding.size ()
+                      && std::equal (pduEncoding.begin (), pduEncoding.end (), check->GetData ());
+    }
+
+  if (!layoutMatches)
+    {
+      NS_LOG_WARN ("The APER encoding of the RIC Indication does not match the layout of the "
+                   "envelope, the indications will be encoded by asn1c");
+      g_layoutMismatch = true;
+      return nullptr;
+    }
+
+  NS_LOG_LOGIC ("Created RIC Indication envelope, " << envelope->m_pduPrefix.size () << " + "
+                                                    << envelope->m_listPrefix.size () << " + "
+                                                    << envelope->m_fixedIes.size ()
+                                                    << " bytes");
+  return envelope;
+}
+
+bool
+E2apIndicationEnvelope::Encode (Ptr<EncodeBuffer> buffer, uint16_t sn, const uint8_t* header,
+                                size_t headerSize, const uint8_t* message,
+                                size_t messageSize) const
+{
+  size_t headerValueSize = GetAperLengthSize (headerSize) + headerSize;
+  size_t messageValueSize = GetAperLengthSize (messageSize) + messageSize;
+  if (headerValueSize >= APER_FRAGMENT_SIZE || messageValueSize >= APER_FRAGMENT_SIZE)
+    {
+      return false;
+    }
+
+  size_t indicationSize = m_listPrefix.size () + m_fixedIes.size () + m_headerIePrefix.size ()
+                          + GetAperLengthSize (headerValueSize) + headerValueSize
+                          + m_messageIePrefix.size () + GetAperLengthSize (messageValueSize)
+                          + messageValueSize;
+  if (indicationSize >= APER_FRAGMENT_SIZE)
+    {
+      return false;
+    }
+
+  size_t size = m_pduPrefix.size () + GetAperLengthSize (indicationSize) + indicationSize;
+  uint8_t *out = buffer->Prepare (size);
+
+  memcpy (out, m_pduPrefix.data (), m_pduPrefix.size ());
+  out = WriteAperLength (out + m_pduPrefix.size (), indicationSize);
+  memcpy (out, m_listPrefix.data (), m_listPrefix.size ());
+  out += m_listPrefix.size ();
+
+  memcpy (out, m_fixedIes.data (), m_fixedIes.size ());
+  out[m_snOffset] = (uint8_t) (sn >> 8);
+  out[m_snOffset + 1] = (uint8_t) (sn & 0xFF);
+  out += m_fixedIes.size ();
+
+  memcpy (out, m_headerIePrefix.data (), m_headerIePrefix.size ());
+  out = WriteAperLength (out + m_headerIePrefix.size (), headerValueSize);
+  out = WriteAperLength (out, headerSize);
+  memcpy (out, header, headerSize);
+  out += headerSize;
+
+  memcpy (out, m_messageIePrefix.data (), m_messageIePrefix.size ());
+  out = WriteAperLength (out + m_messageIePrefix.size (), messageValueSize);
+  out = WriteAperLength (out, messageSize);
+  memcpy (out, message, messageSize);
+  out += messageSize;
+
+  NS_ASSERT ((size_t) (out - buffer->GetData ()) == size);
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef E2AP_INDICATION_ENVELOPE_H
+#define E2AP_INDICATION_ENVELOPE_H
+
+#include "ns3/object.h"
+#include <ns3/encode-buffer.h>
+#include <memory>
+#include <vector>
+
+extern "C" {
+  #include "E2AP-PDU.h"
+}
+
+namespace ns3 {
+
+  /**
+  * Pre-encoded APER envelope of the E2AP RIC Indications of a subscription
+  * action.
+  *
+  * The E2AP fields of the indications of an action only differ in the
+  * RIC Indication SN, so the envelope keeps the APER encoding of the
+  * fixed IEs and builds each indication by writing the length determinants
+  * and splicing the E2SM header and message around them, without building
+  * and encoding the E2AP_PDU tree.
+  *
+  * The layout is derived from, and checked against, an encoding performed
+  * by asn1c. Payloads that need fragmented length determinants, i.e., of
+  * 16 kB or more, are not handled and must be encoded by asn1c.
+  */
+  class E2apIndicationEnvelope
+  {
+  public:
+    /**
+    * Create the envelope of the indications of an action
+    *
+    * \param pdu a RIC Indication of the action, with the IEs in the order
+    *        of generate_e2apv1_indication_request_parameterized; it is
+    *        modified during the call but restored before returning
+    * \return the envelope, or nullptr if the payload of pdu is too large
+    *         or the asn1c encoding does not match the expected layout
+    */
+    static std::unique_ptr<E2apIndicationEnvelope> Create (E2AP_PDU* pdu);
+
+    /**
+    * Encode a RIC Indication of the action
+    *
+    * \param buffer the destination buffer
+    * \param sn the RIC Indication SN
+    * \param header the encoded E2SM Indication Header
+    * \param headerSize the size of the header
+    * \param message the encoded E2SM Indication Message
+    * \param messageSize the size of the message
+    * \return false if the payload is too large for the envelope, in which
+    *         case buffer is left untouched
+    */
+    bool Encode (Ptr<EncodeBuffer> buffer, uint16_t sn, const uint8_t* header, size_t headerSize,
+                 const uint8_t* message, size_t messageSize) const;
+
+  private:
+    E2apIndicationEnvelope ();
+
+    std::vector<uint8_t> m_pduPrefix; //!< bytes preceding the length of the RICindication
+    std::vector<uint8_t> m_listPrefix; //!< bytes preceding the IEs in the RICindication
+    std::vector<uint8_t> m_fixedIes; //!< IEs preceding the E2SM header
+    size_t m_snOffset; //!< offset of the RIC Indication SN in m_fixedIes
+    std::vector<uint8_t> m_headerIePrefix; //!< bytes preceding the length of the header IE value
+    std::vector<uint8_t> m_messageIePrefix; //!< bytes preceding the length of the message IE value
+  };
+
+} // namespace ns3
+
+#endif /* E2AP_INDICATION_ENVELOPE_H */
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/encode-buffer.h>
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EncodeBuffer");
+
+EncodeBuffer::EncodeBuffer (size_t initialCapacity)
+  : m_data (nullptr),
+    m_size (0),
+    m_capacity (0)
+{
+  Reserve (initialCapacity);
+}
+
+EncodeBuffer::~EncodeBuffer ()
+{
+  free (m_data);
+  m_size = 0;
+  m_capacity = 0;
+}
+
+void
+EncodeBuffer::Reserve (size_t capacity)
+{
+  if (capacity <= m_capacity)
+    {
+      return;
+    }
+
+  NS_LOG_LOGIC ("Growing encode buffer from " << m_capacity << " to " << capacity << " bytes");
+  // the previous content is not preserved, the buffer is always
+  // written from scratch by Encode
+  free (m_data);
+  m_data = (uint8_t *) malloc (capacity);
+  if (m_data == nullptr)
+    {
+      NS_FATAL_ERROR ("Unable to allocate " << capacity << " bytes for the encode buffer");
+    }
+  m_capacity = capacity;
+  m_size = 0;
+}
+
+size_t
+EncodeBuffer::Encode (const asn_TYPE_descriptor_t *type, const void *structure)
+{
+  asn_codec_ctx_t *opt_cod = 0; // disable stack bounds checking
+  asn_enc_rval_t er = asn_encode_to_buffer (opt_cod, ATS_ALIGNED_BASIC_PER, type, structure,
+                                            m_data, m_capacity);
+
+  if (er.encoded >= 0 && (size_t) er.encoded > m_capacity)
+    {
+      // asn_encode_to_buffer reports the size it would have needed, so
+      // a single retry with the exact size is enough
+      Reserve (std::max ((size_t) er.encoded, 2 * m_capacity));
+      er = asn_encode_to_buffer (opt_cod, ATS_ALIGNED_BASIC_PER, type, structure, m_data,
+                                 m_capacity);
+    }
+
+  if (er.encoded < 0)
+    {
+      NS_FATAL_ERROR ("Error during the encoding of " << type->name
+                                                      << ", errno: " << strerror (errno)
+                                                      << ", failed_type " << er.failed_type->name
+                                                      << ", structure_ptr " << er.structure_ptr);
+    }
+
+  m_size = er.encoded;
+  return m_size;
+}
+
+void
+EncodeBuffer::Assign (const uint8_t* data, size_t size)
+{
+  Reserve (size);
+  memcpy (m_data, data, size);
+  m_size = size;
+}
+
+uint8_t*
+EncodeBuffer::Prepare (size_t size)
+{
+  Reserve (size);
+  m_size = size;
+  return m_data;
+}
+
+uint8_t*
+EncodeBuffer::GetData () const
+{
+  return m_data;
+}
+
+size_t
+EncodeBuffer::GetSize () const
+{
+  return m_size;
+}
+
+size_t
+EncodeBuffer::GetCapacity () const
+{
+  return m_capacity;
+}
+
+}
@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef ENCODE_BUFFER_H
+#define ENCODE_BUFFER_H
+
+#include "ns3/object.h"
+
+extern "C" {
+  #include "asn_application.h"
+}
+
+namespace ns3 {
+
+  /**
+  * Growable scratch buffer used as the destination of APER encodings.
+  *
+  * The buffer is meant to be owned by the caller and reused across
+  * several encodings (e.g., one per E2 termination), so that the
+  * steady state does not need any allocation: the storage only grows
+  * when an encoding does not fit in the current capacity.
+  * Each call to Encode overwrites the content of the previous one.
+  */
+  class EncodeBuffer : public SimpleRefCount<EncodeBuffer>
+  {
+  public:
+    /**
+    * \param initialCapacity initial size of the storage, in bytes
+    */
+    EncodeBuffer (size_t initialCapacity = 1024);
+    ~EncodeBuffer ();
+
+    /**
+    * Encode a structure in APER into the buffer, growing it if needed.
+    *
+    * \param type the asn1c descriptor of the structure
+    * \param structure pointer to the structure to encode
+    * \return the number of bytes written
+    */
+    size_t Encode (const asn_TYPE_descriptor_t *type, const void *structure);
+
+    /**
+    * Replace the content of the buffer with an already encoded message
+    *
+    * \param data the encoded bytes
+    * \param size the number of bytes
+    */
+    void Assign (const uint8_t* data, size_t size);
+
+    /**
+    * Discard the content of the buffer and make room for a message of
+    * the given size, which the caller writes directly into the storage
+    *
+    * \param size the size of the message, in bytes
+    * \return pointer to the storage
+    */
+    uint8_t* Prepare (size_t size);
+
+    /**
+    * Make sure the buffer can hold at least capacity bytes
+    *
+    * \param capacity the requested capacity, in bytes
+    */
+    void Reserve (size_t capacity);
+
+    /**
+    * \return pointer to the encoded bytes
+    */
+    uint8_t* GetData () const;
+
+    /**
+    * \return the size of the last encoding, in bytes
+    */
+    size_t GetSize () const;
+
+    /**
+    * \return the current capacity of the storage, in bytes
+    */
+    size_t GetCapacity () const;
+
+  private:
+    uint8_t* m_data; //!< storage
+    size_t m_size; //!< size of the last encoding
+    size_t m_capacity; //!< size of the storage
+  };
+
+}
+
+#endif /* ENCODE_BUFFER_H */
@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/encode-thread-pool.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("EncodeThreadPool");
+
+EncodeThreadPool::EncodeThreadPool (uint32_t numThreads)
+  : m_nTasks (0),
+    m_nextTask (0),
+    m_round (0),
+    m_busyWorkers (0),
+    m_running (true)
+{
+  NS_LOG_FUNCTION (this << numThreads);
+  NS_ABORT_MSG_IF (numThreads == 0, "The pool needs at least one thread");
+
+  for (uint32_t i = 1; i < numThreads; i++)
+    {
+      m_workers.push_back (std::thread (&EncodeThreadPool::DoWork, this));
+    }
+}
+
+EncodeThreadPool::~EncodeThreadPool ()
+{
+  NS_LOG_FUNCTION (this);
+
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_running = false;
+    m_workCv.notify_all ();
+  }
+  for (auto &worker : m_workers)
+    {
+      worker.join ();
+    }
+}
+
+uint32_t
+EncodeThreadPool::GetNThreads () const
+{
+  return m_workers.size () + 1;
+}
+
+void
+EncodeThreadPool::ParallelFor (size_t n, Task task)
+{
+  NS_LOG_FUNCTION (this << n);
+
+  if (m_workers.empty () || n < 2)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          task (i);
+        }
+      return;
+    }
+
+  std::lock_guard<std::mutex> callLock (m_callMutex);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_task = task;
+    m_nTasks = n;
+    m_nextTask.store (0, std::memory_order_relaxed);
+    m_busyWorkers = m_workers.size ();
+    m_round++;
+    m_workCv.notify_all ();
+  }
+
+  // the calling thread takes part in the round
+  RunTasks ();
+
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_doneCv.wait (lock, [this] { return m_busyWorkers == 0; });
+  m_task = nullptr;
+}
+
+void
+EncodeThreadPool::RunTasks ()
+{
+  size_t i;
+  while ((i = m_nextTask.fetch_add (1, std::memory_order_relaxed)) < m_nTasks)
+    {
+      m_task (i);
+    }
+}
+
+void
+EncodeThreadPool::DoWork ()
+{
+  uint64_t round = 0;
+  while (true)
+    {
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_workCv.wait (lock, [this, round] { return m_round != round || !m_running; });
+        if (!m_running)
+          {
+            return;
+          }
+        round = m_round;
+      }
+
+      RunTasks ();
+
+      std::lock_guard<std::mutex> lock (m_mutex);
+      if (--m_busyWorkers == 0)
+        {
+          m_doneCv.notify_one ();
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef ENCODE_THREAD_POOL_H
+#define ENCODE_THREAD_POOL_H
+
+#include "ns3/object.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Fixed pool of threads used to encode independent messages in parallel.
+  *
+  * ParallelFor splits a range of tasks among the workers and the calling
+  * thread, and returns when all of them are completed. The workers are
+  * created once and park on a condition variable between two calls.
+  * Concurrent calls are serialized.
+  */
+  class EncodeThreadPool : public SimpleRefCount<EncodeThreadPool>
+  {
+  public:
+    /**
+    * Function executing the task with the given index
+    */
+    typedef std::function<void (size_t)> Task;
+
+    /**
+    * \param numThreads the number of threads running the tasks, including
+    *        the calling thread, so numThreads - 1 workers are created
+    */
+    EncodeThreadPool (uint32_t numThreads);
+    ~EncodeThreadPool ();
+
+    /**
+    * Run task (i) for every i in [0, n), and wait for completion
+    *
+    * \param n the number of tasks
+    * \param task the task
+    */
+    void ParallelFor (size_t n, Task task);
+
+    /**
+    * \return the number of threads running the tasks, including the
+    *         calling thread
+    */
+    uint32_t GetNThreads () const;
+
+  private:
+    /**
+    * Main loop of the workers
+    */
+    void DoWork ();
+
+    /**
+    * Run the tasks of the current round until none is left
+    */
+    void RunTasks ();
+
+    std::vector<std::thread> m_workers; //!< the worker threads
+    std::mutex m_callMutex; //!< serializes the calls to ParallelFor
+    std::mutex m_mutex; //!< protects the state of the current round
+    std::condition_variable m_workCv; //!< signaled when a round starts or the pool stops
+    std::condition_variable m_doneCv; //!< signaled when a worker completes a round
+    Task m_task; //!< task of the current round
+    size_t m_nTasks; //!< number of tasks of the current round
+    std::atomic<size_t> m_nextTask; //!< index of the next task to run
+    uint64_t m_round; //!< number of rounds started
+    uint32_t m_busyWorkers; //!< workers that did not complete the current round
+    bool m_running; //!< false when the workers must exit
+  };
+
+} // namespace ns3
+
+#endif /* ENCODE_THREAD_POOL_H */
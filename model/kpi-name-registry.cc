@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpi-name-registry.h>
+#include <ns3/log.h>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+namespace ns3 {
+
+// The entries are stored in chunks that are never moved, so that a lookup
+// only needs to load the pointer to the chunk
+static const uint32_t CHUNK_SIZE = 256;
+static const uint32_t MAX_CHUNKS = 256;
+
+/**
+* Storage of the registry
+*/
+struct KpiNameTable
+{
+  std::mutex m_mutex; //!< serializes the registrations
+  std::unordered_map<std::string, KpiNameRegistry::Id> m_ids; //!< IDs, indexed by name
+  std::atomic<MeasurementTypeName_t *> m_chunks[MAX_CHUNKS]; //!< the entries, by chunk
+  std::atomic<uint32_t> m_size; //!< number of entries
+
+  KpiNameTable () : m_size (0)
+  {
+    for (uint32_t i = 0; i < MAX_CHUNKS; i++)
+      {
+        m_chunks[i].store (nullptr, std::memory_order_relaxed);
+      }
+  }
+};
+
+/**
+* \return the table, created on first use so that the registry can be used
+*         during the static initialization of other translation units
+*/
+static KpiNameTable &
+GetKpiNameTable ()
+{
+  // intentionally leaked, the entries may be referenced until the exit
+  static KpiNameTable *table = new KpiNameTable ();
+  return *table;
+}
+
+KpiNameRegistry::Id
+KpiNameRegistry::Register (const std::string &name)
+{
+  KpiNameTable &table = GetKpiNameTable ();
+  std::lock_guard<std::mutex> lock (table.m_mutex);
+
+  auto it = table.m_ids.find (name);
+  if (it != table.m_ids.end ())
+    {
+      return it->second;
+    }
+
+  Id id = table.m_size.load (std::memory_order_relaxed);
+  NS_ABORT_MSG_IF (id >= CHUNK_SIZE * MAX_CHUNKS, "Too many KPI names registered");
+
+  MeasurementTypeName_t *chunk = table.m_chunks[id / CHUNK_SIZE].load (std::memory_order_relaxed);
+  if (chunk == nullptr)
+    {
+      chunk = (MeasurementTypeName_t *) calloc (CHUNK_SIZE, sizeof (MeasurementTypeName_t));
+      table.m_chunks[id / CHUNK_SIZE].store (chunk, std::memory_order_release);
+    }
+
+  MeasurementTypeName_t *entry = &chunk[id % CHUNK_SIZE];
+  entry->buf = (uint8_t *) calloc (1, name.length ());
+  memcpy (entry->buf, name.c_str (), name.length ());
+  entry->size = name.length ();
+
+  table.m_ids.emplace (name, id);
+  // no logging here, since the names are also registered during the static
+  // initialization, possibly before the log components are constructed
+  table.m_size.store (id + 1, std::memory_order_release);
+  return id;
+}
+
+const MeasurementTypeName_t *
+KpiNameRegistry::GetMeasurementTypeName (Id id)
+{
+  KpiNameTable &table = GetKpiNameTable ();
+  NS_ASSERT_MSG (id < table.m_size.load (std::memory_order_acquire), "Unknown KPI name ID " << id);
+  return &table.m_chunks[id / CHUNK_SIZE].load (std::memory_order_acquire)[id % CHUNK_SIZE];
+}
+
+std::string
+KpiNameRegistry::GetName (Id id)
+{
+  const MeasurementTypeName_t *name = GetMeasurementTypeName (id);
+  return std::string ((const char *) name->buf, name->size);
+}
+
+uint32_t
+KpiNameRegistry::GetSize ()
+{
+  return GetKpiNameTable ().m_size.load (std::memory_order_acquire);
+}
+
+} // namespace ns3
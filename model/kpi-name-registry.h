@@ -0,0 +1,84 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPI_NAME_REGISTRY_H
+#define KPI_NAME_REGISTRY_H
+
+#include "ns3/object.h"
+#include <string>
+
+extern "C" {
+  #include "MeasurementTypeName.h"
+}
+
+namespace ns3 {
+
+  /**
+  * Global registry of the KPI names carried by the Measurement Information
+  * Items.
+  *
+  * Each name is registered once and identified by a small integer. The
+  * registry owns a pre-sized MeasurementTypeName_t for every name, which
+  * the encoded trees reference instead of copying the string. Entries are
+  * never removed, so the IDs and the buffers are valid until the end of
+  * the program.
+  *
+  * Registration is serialized by a mutex, while the lookups are lock-free
+  * and can be performed from any thread.
+  */
+  class KpiNameRegistry
+  {
+  public:
+    typedef uint32_t Id;
+
+    /**
+    * Register a KPI name. Registering the same name again returns the
+    * same ID.
+    *
+    * \param name the name
+    * \return the ID of the name
+    */
+    static Id Register (const std::string &name);
+
+    /**
+    * \param id the ID returned by Register
+    * \return the name, to be used only for reading
+    */
+    static const MeasurementTypeName_t *GetMeasurementTypeName (Id id);
+
+    /**
+    * \param id the ID returned by Register
+    * \return the name
+    */
+    static std::string GetName (Id id);
+
+    /**
+    * \return the number of registered names
+    */
+    static uint32_t GetSize ();
+  };
+
+} // namespace ns3
+
+#endif /* KPI_NAME_REGISTRY_H */
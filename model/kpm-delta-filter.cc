@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpm-delta-filter.h>
+#include <ns3/log.h>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KpmDeltaFilter");
+
+KpmDeltaFilter::KpmDeltaFilter (double threshold, uint32_t maxIdleReports,
+                                uint32_t refreshInterval)
+  : m_threshold (threshold),
+    m_maxIdleReports (maxIdleReports),
+    m_refreshInterval (refreshInterval),
+    m_reports (0),
+    m_lastRefresh (0),
+    m_suppressedItems (0),
+    m_suppressedUes (0)
+{
+  NS_ABORT_MSG_IF (threshold < 0, "The threshold must not be negative");
+}
+
+bool
+KpmDeltaFilter::Filter (const std::string &ueId, Ptr<MeasurementItemList> items)
+{
+  NS_LOG_FUNCTION (this << ueId << items->GetSize ());
+
+  UeValues &ue = m_reported[ueId];
+  const ReportedValues &reported = ue.m_reported;
+  ue.m_lastReport = m_reports;
+  bool staged = !ue.m_staged.empty ();
+  bool refresh = IsRefresh ();
+  size_t size = items->GetSize ();
+  size_t kept = 0;
+  m_keep.assign (size, true);
+  for (size_t i = 0; i < size; i++)
+    {
+      if (items->GetValueType (i) == MeasurementValue_PR_valueRRC)
+        {
+          kept++;
+          continue;
+        }
+
+      // the items of a UE are usually added in the same order at every
+      // report, so the position is checked before searching
+      KpiNameRegistry::Id nameId = items->GetNameId (i);
+      double value = items->GetNumericValue (i);
+      size_t j = i;
+      if (j >= reported.size () || reported[j].first != nameId)
+        {
+          for (j = 0; j < reported.size () && reported[j].first != nameId; j++)
+            {
+            }
+        }
+
+      if (j == reported.size ())
+        {
+          ue.m_staged.push_back ({nameId, NEW_ITEM, value});
+        }
+      else if (std::abs (value - reported[j].second) > m_threshold)
+        {
+          ue.m_staged.push_back ({nameId, j, value});
+        }
+      else if (!refresh)
+        {
+          m_keep[i] = false;
+          continue;
+        }
+      kept++;
+    }
+
+  if (!staged && !ue.m_staged.empty ())
+    {
+      m_stagedUes.push_back (ueId);
+    }
+
+  m_suppressedItems += size - kept;
+  if (kept == 0 && size > 0)
+    {
+      NS_LOG_LOGIC ("UE " << ueId << " unchanged, not reported");
+      m_suppressedUes++;
+      return false;
+    }
+  if (kept < size)
+    {
+      items->RetainItems (m_keep);
+    }
+  return true;
+}
+
+void
+KpmDeltaFilter::Commit ()
+{
+  NS_LOG_FUNCTION (this);
+  if (IsRefresh ())
+    {
+      m_lastRefresh = m_reports;
+    }
+  for (const std::string &ueId : m_stagedUes)
+    {
+      auto it = m_reported.find (ueId);
+      if (it == m_reported.end ())
+        {
+          continue;
+        }
+      UeValues &ue = it->second;
+      for (const StagedValue &staged : ue.m_staged)
+        {
+          if (staged.m_index == NEW_ITEM)
+            {
+              ue.m_reported.emplace_back (staged.m_nameId, staged.m_value);
+            }
+          else
+            {
+              ue.m_reported[staged.m_index].second = staged.m_value;
+            }
+        }
+      ue.m_staged.clear ();
+    }
+  m_stagedUes.clear ();
+  m_reports++;
+
+  if (m_maxIdleReports == 0)
+    {
+      return;
+    }
+  for (auto it = m_reported.begin (); it != m_reported.end ();)
+    {
+      if (m_reports - it->second.m_lastReport > m_maxIdleReports)
+        {
+          NS_LOG_LOGIC ("UE " << it->first << " idle, forgotten");
+          it = m_reported.erase (it);
+        }
+      else
+        {
+          ++it;
+        }
+    }
+}
+
+void
+KpmDeltaFilter::Discard ()
+{
+  NS_LOG_FUNCTION (this);
+  for (const std::string &ueId : m_stagedUes)
+    {
+      auto it = m_reported.find (ueId);
+      if (it == m_reported.end ())
+        {
+          continue;
+        }
+      // a UE seen for the first time is not remembered
+      it->second.m_staged.clear ();
+      if (it->second.m_reported.empty ())
+        {
+          m_reported.erase (it);
+        }
+    }
+  m_stagedUes.clear ();
+  m_reports++;
+}
+
+bool
+KpmDeltaFilter::IsRefresh () const
+{
+  return m_refreshInterval != 0 && m_reports - m_lastRefresh >= m_refreshInterval;
+}
+
+void
+KpmDeltaFilter::RemoveUe (const std::string &ueId)
+{
+  NS_LOG_FUNCTION (this << ueId);
+  m_reported.erase (ueId);
+}
+
+size_t
+KpmDeltaFilter::GetNUes () const
+{
+  return m_reported.size ();
+}
+
+void
+KpmDeltaFilter::Reset ()
+{
+  NS_LOG_FUNCTION (this);
+  m_reported.clear ();
+  m_stagedUes.clear ();
+  // the next report is complete anyway
+  m_lastRefresh = m_reports;
+}
+
+uint64_t
+KpmDeltaFilter::GetSuppressedItems () const
+{
+  return m_suppressedItems;
+}
+
+uint64_t
+KpmDeltaFilter::GetSuppressedUes () const
+{
+  return m_suppressedUes;
+}
+
+} // namespace ns3
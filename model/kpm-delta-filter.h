@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPM_DELTA_FILTER_H
+#define KPM_DELTA_FILTER_H
+
+#include "ns3/object.h"
+#include <ns3/kpm-indication.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Filter for incremental KPM reports, which only carry the UE
+  * measurements that changed since they were last reported.
+  *
+  * The filter remembers the last reported value of every item of every
+  * UE, and removes from a list the integer and real items whose value did
+  * not move by more than the threshold. UEs left without items are not
+  * reported at all. L3 RRC measurements are always reported, and so are
+  * the items of a UE reported for the first time.
+  *
+  * Every few reports the filter lets a complete report through, a
+  * refresh, so that the RIC keeps hearing from the UEs whose values do not
+  * change, can tell them apart from the UEs that left, and recovers from
+  * a lost indication.
+  *
+  * The values kept by Filter are only remembered as reported once the
+  * report is sent: after each report, Commit must be called if it was
+  * sent, e.g., if E2Termination::SendIndicationToSubscribers returned a
+  * non-zero count, and Discard otherwise. The UEs are forgotten when
+  * released, see RemoveUe, or when absent from several reports in a row.
+  *
+  * The filter outlives the IndicationMessageHelper of a single report:
+  * the same filter must be set on the helpers of consecutive reports of
+  * the same cell and message type.
+  */
+  class KpmDeltaFilter : public SimpleRefCount<KpmDeltaFilter>
+  {
+  public:
+    /**
+    * \param threshold the minimum absolute change of a value for it to be
+    *        reported again, with 0 reporting any change
+    * \param maxIdleReports the number of reports a UE can be absent from
+    *        before its values are forgotten, or 0 to keep them until the
+    *        UE is removed
+    * \param refreshInterval the number of reports after a sent refresh
+    *        at which the next report is complete, i.e., nothing is
+    *        removed, or 0 to never refresh
+    */
+    KpmDeltaFilter (double threshold = 0, uint32_t maxIdleReports = 10,
+                    uint32_t refreshInterval = 10);
+
+    /**
+    * Remove from a list the items that did not change since the last
+    * report sent, unless the report is a refresh, and stage the values of
+    * the others until the report is committed
+    *
+    * \param ueId the ID of the UE, e.g., its IMSI
+    * \param items the measurement items of the UE
+    * \return false if all the items were removed and the UE must not be
+    *         reported
+    */
+    bool Filter (const std::string &ueId, Ptr<MeasurementItemList> items);
+
+    /**
+    * End a report that was sent: the values staged since the last report
+    * are remembered as reported, and the UEs idle for too long are
+    * forgotten
+    */
+    void Commit ();
+
+    /**
+    * End a report that was not sent: the values staged since the last
+    * report are dropped, and a refresh is tried again at the next report
+    */
+    void Discard ();
+
+    /**
+    * \return true if the current report is a refresh, i.e., complete
+    */
+    bool IsRefresh () const;
+
+    /**
+    * Forget the values of a UE, e.g., when it is released or hands over
+    *
+    * \param ueId the ID of the UE
+    */
+    void RemoveUe (const std::string &ueId);
+
+    /**
+    * \return the number of UEs whose values are remembered
+    */
+    size_t GetNUes () const;
+
+    /**
+    * Forget the reported values, so that the next reports are complete,
+    * e.g., when a new subscription starts
+    */
+    void Reset ();
+
+    /**
+    * \return the number of items removed since the creation of the filter
+    */
+    uint64_t GetSuppressedItems () const;
+
+    /**
+    * \return the number of UE reports removed since the creation of the
+    *         filter
+    */
+    uint64_t GetSuppressedUes () const;
+
+  private:
+    /**
+    * Last reported value of each item of a UE, in the order the items
+    * were first reported
+    */
+    typedef std::vector<std::pair<KpiNameRegistry::Id, double>> ReportedValues;
+
+    /**
+    * Value kept by Filter, remembered once the report is committed
+    */
+    struct StagedValue
+    {
+      KpiNameRegistry::Id m_nameId; //!< the name of the item
+      size_t m_index; //!< the position of the item in the reported values, or NEW_ITEM
+      double m_value; //!< the value
+    };
+
+    /**
+    * Values of a UE
+    */
+    struct UeValues
+    {
+      ReportedValues m_reported; //!< the values reported
+      std::vector<StagedValue> m_staged; //!< the values of the current report
+      uint64_t m_lastReport; //!< the last report the UE was part of
+    };
+
+    static const size_t NEW_ITEM = SIZE_MAX; //!< staged value of an item never reported
+
+    double m_threshold; //!< minimum change of a value for it to be reported
+    uint32_t m_maxIdleReports; //!< reports a UE can be absent from before being forgotten
+    uint32_t m_refreshInterval; //!< reports between two refreshes
+    uint64_t m_reports; //!< reports ended since the creation of the filter
+    uint64_t m_lastRefresh; //!< the last refresh sent, or the last reset
+    std::unordered_map<std::string, UeValues> m_reported; //!< values per UE
+    std::vector<std::string> m_stagedUes; //!< UEs with staged values
+    std::vector<bool> m_keep; //!< scratch flags of the items to keep
+    uint64_t m_suppressedItems; //!< items removed
+    uint64_t m_suppressedUes; //!< UE reports removed
+  };
+
+} // namespace ns3
+
+#endif /* KPM_DELTA_FILTER_H */
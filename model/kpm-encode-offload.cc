@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpm-encode-offload.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KpmEncodeOffload");
+
+KpmEncodeOffload::KpmEncodeOffload (uint32_t numThreads, uint32_t queueDepth, EmitCallback emit)
+  : m_slots (queueDepth),
+    m_emit (emit),
+    m_nextSeq (0),
+    m_pending (0),
+    m_running (true),
+    m_nextEmit (0),
+    m_collectEmitted (false)
+{
+  NS_LOG_FUNCTION (this << numThreads << queueDepth);
+  NS_ABORT_MSG_IF (numThreads == 0, "At least one encoding thread is needed");
+  NS_ABORT_MSG_IF (queueDepth == 0, "The encoding queue must hold at least one job");
+
+  for (auto &slot : m_slots)
+    {
+      slot.m_buffer = Create<EncodeBuffer> ();
+      slot.m_ready = false;
+    }
+  for (uint32_t i = 0; i < numThreads; i++)
+    {
+      m_workers.emplace_back (&KpmEncodeOffload::DoWork, this);
+    }
+}
+
+KpmEncodeOffload::~KpmEncodeOffload ()
+{
+  NS_LOG_FUNCTION (this);
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_running = false;
+  }
+  m_workCv.notify_all ();
+  for (auto &worker : m_workers)
+    {
+      worker.join ();
+    }
+}
+
+void
+KpmEncodeOffload::Submit (Time timestamp, long ranFunctionId, const uint8_t *header,
+                          size_t headerSize,
+                          KpmIndicationMessage::KpmIndicationMessageValues &&values)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  if (m_pending == m_slots.size ())
+    {
+      NS_LOG_LOGIC ("Encoding queue full, waiting");
+      m_doneCv.wait (lock, [this] { return m_pending < m_slots.size (); });
+    }
+
+  // the slot was released by its previous job before m_pending decreased;
+  // the header is copied into the capacity left by the previous jobs, and
+  // the values are moved explicitly, so that the caller keeps no reference
+  // the workers could race with
+  uint64_t seq = m_nextSeq++;
+  Job &slotJob = m_slots[seq % m_slots.size ()].m_job;
+  slotJob.m_timestamp = timestamp;
+  slotJob.m_ranFunctionId = ranFunctionId;
+  slotJob.m_header.assign (header, header + headerSize);
+  values.MoveTo (slotJob.m_values);
+  m_pending++;
+  m_queue.push_back (seq);
+  lock.unlock ();
+  m_workCv.notify_one ();
+}
+
+void
+KpmEncodeOffload::Flush ()
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  m_doneCv.wait (lock, [this] { return m_pending == 0; });
+}
+
+void
+KpmEncodeOffload::CollectEmitted (std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values)
+{
+  std::lock_guard<std::mutex> lock (m_emitMutex);
+  m_collectEmitted = true;
+  for (auto &emitted : m_emitted)
+    {
+      values.emplace_back ();
+      emitted.MoveTo (values.back ());
+    }
+  m_emitted.clear ();
+}
+
+uint32_t
+KpmEncodeOffload::GetNThreads () const
+{
+  return m_workers.size ();
+}
+
+void
+KpmEncodeOffload::DoWork ()
+{
+  while (true)
+    {
+      uint64_t seq;
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        // the queue is drained before exiting
+        m_workCv.wait (lock, [this] { return !m_queue.empty () || !m_running; });
+        if (m_queue.empty ())
+          {
+            return;
+          }
+        seq = m_queue.front ();
+        m_queue.pop_front ();
+      }
+
+      // the slot belongs to this worker until the job is marked as ready
+      Slot &slot = m_slots[seq % m_slots.size ()];
+      slot.m_message = Create<KpmIndicationMessage> (slot.m_job.m_values, slot.m_buffer);
+      Complete (seq);
+    }
+}
+
+void
+KpmEncodeOffload::Complete (uint64_t seq)
+{
+  uint32_t emitted = 0;
+  {
+    std::lock_guard<std::mutex> lock (m_emitMutex);
+    m_slots[seq % m_slots.size ()].m_ready = true;
+
+    // whoever completes the next job in order emits it, together with the
+    // following ones that are already encoded
+    while (m_slots[m_nextEmit % m_slots.size ()].m_ready)
+      {
+        Slot &slot = m_slots[m_nextEmit % m_slots.size ()];
+        NS_LOG_LOGIC ("Emitting job " << m_nextEmit << " submitted at "
+                                      << slot.m_job.m_timestamp.GetSeconds () << " s");
+        m_emit (slot.m_job, slot.m_message);
+        if (m_collectEmitted)
+          {
+            m_emitted.emplace_back ();
+            slot.m_job.m_values.MoveTo (m_emitted.back ());
+          }
+        // the header keeps its capacity for the next job of the slot
+        slot.m_job.m_header.clear ();
+        slot.m_job.m_values = KpmIndicationMessage::KpmIndicationMessageValues ();
+        slot.m_message = nullptr;
+        slot.m_ready = false;
+        m_nextEmit++;
+        emitted++;
+      }
+  }
+
+  if (emitted > 0)
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_pending -= emitted;
+      m_doneCv.notify_all ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPM_ENCODE_OFFLOAD_H
+#define KPM_ENCODE_OFFLOAD_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <ns3/kpm-indication.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Pool of threads encoding RIC Indication Messages away from the
+  * simulator thread.
+  *
+  * The simulator thread submits jobs carrying the values of a message,
+  * the workers encode them in parallel and the encoded messages are passed
+  * to the emit callback in the order of submission, i.e., in timestamp
+  * order, one at a time. Each pending job owns a slot of a ring, with an
+  * encode buffer and a header buffer reused by the jobs taking the same
+  * slot, so that a pool in steady state does not allocate.
+  */
+  class KpmEncodeOffload
+  {
+  public:
+    /**
+    * A message to be encoded and sent
+    */
+    struct Job
+    {
+      Time m_timestamp; //!< simulation time of the submission
+      long m_ranFunctionId; //!< ID of the RAN Function
+      std::vector<uint8_t> m_header; //!< the encoded E2SM Indication Header
+      KpmIndicationMessage::KpmIndicationMessageValues m_values; //!< the values of the message
+    };
+
+    /**
+    * Called with a job and its encoded message, on the thread of a worker
+    */
+    typedef std::function<void (const Job &, Ptr<KpmIndicationMessage>)> EmitCallback;
+
+    /**
+    * \param numThreads the number of workers
+    * \param queueDepth the maximum number of jobs submitted and not yet
+    *        emitted
+    * \param emit the callback receiving the encoded messages
+    */
+    KpmEncodeOffload (uint32_t numThreads, uint32_t queueDepth, EmitCallback emit);
+
+    /**
+    * Encode and emit the pending jobs, then stop the workers
+    */
+    ~KpmEncodeOffload ();
+
+    /**
+    * Submit a job, blocking while queueDepth jobs are pending.
+    * The header is copied into the slot of the job. The values are moved
+    * to the workers, which release their objects: the caller must not
+    * keep references to the objects of the values, since Ptr reference
+    * counts are not thread-safe.
+    *
+    * \param timestamp simulation time of the submission
+    * \param ranFunctionId ID of the RAN Function
+    * \param header the encoded E2SM Indication Header
+    * \param headerSize the size of the header
+    * \param values the values of the message
+    */
+    void Submit (Time timestamp, long ranFunctionId, const uint8_t *header, size_t headerSize,
+                 KpmIndicationMessage::KpmIndicationMessageValues &&values);
+
+    /**
+    * Wait until every submitted job is emitted
+    */
+    void Flush ();
+
+    /**
+    * Move out the values of the jobs emitted since the previous call, e.g.,
+    * to recycle their measurement lists on the simulator thread. The
+    * workers release their references to the values before handing them
+    * back, under the emission lock, so the caller is their only owner.
+    * The pool keeps the values of the emitted jobs only once this method
+    * has been called, otherwise they are released by the workers.
+    *
+    * \param values filled with the values of the emitted jobs
+    */
+    void CollectEmitted (std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values);
+
+    /**
+    * \return the number of workers
+    */
+    uint32_t GetNThreads () const;
+
+  private:
+    /**
+    * A pending job and its encoded message
+    */
+    struct Slot
+    {
+      Job m_job; //!< the job
+      Ptr<EncodeBuffer> m_buffer; //!< buffer the message is encoded into
+      Ptr<KpmIndicationMessage> m_message; //!< the encoded message
+      bool m_ready; //!< true when the message is encoded
+    };
+
+    /**
+    * Main loop of the workers
+    */
+    void DoWork ();
+
+    /**
+    * Mark a job as encoded and emit, in order, the encoded jobs
+    *
+    * \param seq the sequence number of the job
+    */
+    void Complete (uint64_t seq);
+
+    std::vector<std::thread> m_workers; //!< the worker threads
+    std::vector<Slot> m_slots; //!< ring of the pending jobs, indexed by sequence number
+    EmitCallback m_emit; //!< the emit callback
+
+    std::mutex m_mutex; //!< protects the queue and the counters below
+    std::condition_variable m_workCv; //!< signaled when a job is queued or the pool stops
+    std::condition_variable m_doneCv; //!< signaled when jobs are emitted
+    std::deque<uint64_t> m_queue; //!< sequence numbers of the jobs to encode
+    uint64_t m_nextSeq; //!< sequence number of the next job submitted
+    uint32_t m_pending; //!< jobs submitted and not yet emitted
+    bool m_running; //!< false when the workers must exit
+
+    std::mutex m_emitMutex; //!< serializes the emission
+    uint64_t m_nextEmit; //!< sequence number of the next job to emit
+    bool m_collectEmitted; //!< keep the values of the emitted jobs for CollectEmitted
+    std::vector<KpmIndicationMessage::KpmIndicationMessageValues> m_emitted; //!< values of the emitted jobs
+  };
+
+} // namespace ns3
+
+#endif /* KPM_ENCODE_OFFLOAD_H */
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpm-indication-batch.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KpmIndicationMessageBatch");
+
+KpmIndicationMessageBatch::KpmIndicationMessageBatch ()
+{
+}
+
+void
+KpmIndicationMessageBatch::Encode (
+    const std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values,
+    Ptr<EncodeThreadPool> pool)
+{
+  NS_LOG_FUNCTION (this << values.size ());
+
+  // the buffers are created on this thread, the workers only use them
+  while (m_buffers.size () < values.size ())
+    {
+      m_buffers.push_back (Create<EncodeBuffer> ());
+    }
+  m_messages.clear ();
+  m_messages.resize (values.size ());
+
+  // each task only touches its own slot, buffer and values
+  auto task = [this, &values] (size_t i) {
+    m_messages[i] = Create<KpmIndicationMessage> (values[i], m_buffers[i]);
+  };
+
+  if (pool)
+    {
+      pool->ParallelFor (values.size (), task);
+    }
+  else
+    {
+      for (size_t i = 0; i < values.size (); i++)
+        {
+          task (i);
+        }
+    }
+}
+
+size_t
+KpmIndicationMessageBatch::GetN () const
+{
+  return m_messages.size ();
+}
+
+Ptr<KpmIndicationMessage>
+KpmIndicationMessageBatch::Get (size_t i) const
+{
+  NS_ABORT_MSG_IF (i >= m_messages.size (), "Message index " << i << " out of range");
+  return m_messages[i];
+}
+
+} // namespace ns3
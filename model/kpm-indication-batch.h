@@ -0,0 +1,83 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPM_INDICATION_BATCH_H
+#define KPM_INDICATION_BATCH_H
+
+#include "ns3/object.h"
+#include <ns3/kpm-indication.h>
+#include <ns3/encode-thread-pool.h>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * RIC Indication Messages of the cells of a multi-cell E2 node, encoded
+  * together.
+  *
+  * Each message is encoded into a buffer owned by the batch, and the
+  * buffers are kept across calls to Encode, so that a batch reused at
+  * every reporting period does not allocate once it has grown to the size
+  * of the largest report. The trees are built in the arena of the thread
+  * performing the encoding.
+  */
+  class KpmIndicationMessageBatch : public SimpleRefCount<KpmIndicationMessageBatch>
+  {
+  public:
+    KpmIndicationMessageBatch ();
+
+    /**
+    * Encode a message for each set of values, replacing the messages of
+    * the previous call.
+    * When a pool is given the messages are encoded in parallel, so the
+    * values of different messages must not share any object, e.g., the
+    * same MeasurementItemList or PmContainerValues.
+    *
+    * \param values the values of each message
+    * \param pool the threads performing the encoding, or nullptr to encode
+    *        on the calling thread
+    */
+    void Encode (const std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values,
+                 Ptr<EncodeThreadPool> pool = nullptr);
+
+    /**
+    * \return the number of messages
+    */
+    size_t GetN () const;
+
+    /**
+    * \param i the index of the message
+    * \return the message, whose m_buffer stays valid until the next call
+    *         to Encode
+    */
+    Ptr<KpmIndicationMessage> Get (size_t i) const;
+
+  private:
+    std::vector<Ptr<EncodeBuffer>> m_buffers; //!< encode buffers, one per message
+    std::vector<Ptr<KpmIndicationMessage>> m_messages; //!< the messages
+  };
+
+} // namespace ns3
+
+#endif /* KPM_INDICATION_BATCH_H */
@@ -24,7 +24,18 @@
 
 #include <ns3/kpm-indication.h>
 #include <ns3/asn1c-types.h>
+#include <ns3/asn1c-arena.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/global-value.h>
+#include <ns3/simulator.h>
+#include <ns3/hash.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
 
 extern "C" {
 #include "E2SM-KPM-IndicationHeader-Format1.h"
@@ -57,24 +68,293 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("KpmIndication");
 
+/**
+* Get the arena used to build the E2SM-KPM trees of the indication
+* messages. Each thread has its own arena, which is reset after every
+* encoding, so that the memory is recycled across messages.
+*
+* \return the arena of the calling thread
+*/
+static Asn1cArena &
+GetMessageArena ()
+{
+  static thread_local Asn1cArena arena;
+  return arena;
+}
+
+/**
+* Fill an OCTET STRING with a copy of value allocated from the arena
+*
+* \param arena the arena
+* \param octetString the OCTET STRING to fill
+* \param value the content
+* \param size the number of bytes to copy
+*/
+static void
+FillArenaOctetString (Asn1cArena &arena, OCTET_STRING_t *octetString, const std::string &value,
+                      size_t size)
+{
+  octetString->buf = (uint8_t *) arena.Allocate (size);
+  memcpy (octetString->buf, value.c_str (), std::min (size, value.length () + 1));
+  octetString->size = size;
+}
+
+/**
+* Fill an NR Cell Identity, see NrCellId, with memory allocated from the
+* arena
+*
+* \param arena the arena
+* \param bitString the BIT STRING to fill
+* \param nrCellId the cell ID
+*/
+static void
+FillArenaNrCellId (Asn1cArena &arena, BIT_STRING_t *bitString, uint16_t nrCellId)
+{
+  static const size_t nrCellIdSize = 5;
+  std::string shifted = std::to_string ((uint16_t) (nrCellId * 16));
+  bitString->buf = (uint8_t *) arena.Allocate (nrCellIdSize);
+  memcpy (bitString->buf, shifted.c_str (), std::min (nrCellIdSize, shifted.length () + 1));
+  bitString->size = nrCellIdSize;
+  bitString->bits_unused = 4;
+}
+
+/**
+* Fill an INTEGER with the minimal two's complement encoding of value,
+* as done by asn_long2INTEGER, with memory allocated from the arena
+*
+* \param arena the arena
+* \param integer the INTEGER to fill
+* \param value the value
+*/
+static void
+FillArenaInteger (Asn1cArena &arena, INTEGER_t *integer, long value)
+{
+  uint8_t bytes[sizeof (long)];
+  for (size_t i = 0; i < sizeof (long); i++)
+    {
+      bytes[i] = (uint8_t) ((unsigned long) value >> (8 * (sizeof (long) - 1 - i)));
+    }
+
+  // skip the leading bytes that only carry the sign
+  size_t start = 0;
+  while (start < sizeof (long) - 1
+         && ((bytes[start] == 0x00 && !(bytes[start + 1] & 0x80))
+             || (bytes[start] == 0xFF && (bytes[start + 1] & 0x80))))
+    {
+      start++;
+    }
+
+  integer->size = sizeof (long) - start;
+  integer->buf = arena.Copy (bytes + start, integer->size);
+}
+
+static GlobalValue g_kpmDeterministicEncoding =
+    GlobalValue ("KpmDeterministicEncoding",
+                 "If true, the collection timestamp of the RIC Indication Headers is "
+                 "KpmDeterministicEpoch plus the simulation time in milliseconds, so that "
+                 "the same simulation encodes the same bytes in every run",
+                 BooleanValue (false), MakeBooleanChecker ());
+
+static GlobalValue g_kpmDeterministicEpoch =
+    GlobalValue ("KpmDeterministicEpoch",
+                 "Collection timestamp, in milliseconds, of the start of the simulation "
+                 "when KpmDeterministicEncoding is enabled",
+                 UintegerValue (0), MakeUintegerChecker<uint64_t> ());
+
+bool
+KpmIndicationHeader::IsDeterministicEncoding ()
+{
+  BooleanValue deterministic;
+  g_kpmDeterministicEncoding.GetValue (deterministic);
+  return deterministic.Get ();
+}
+
 KpmIndicationHeader::KpmIndicationHeader (GlobalE2nodeType nodeType,KpmRicIndicationHeaderValues values)
+  : KpmIndicationHeader (nodeType, values, nullptr, true)
+{
+}
+
+KpmIndicationHeader::KpmIndicationHeader (GlobalE2nodeType nodeType,
+                                          KpmRicIndicationHeaderValues values,
+                                          Ptr<EncodeBuffer> encodeBuffer)
+  : KpmIndicationHeader (nodeType, values, encodeBuffer, true)
 {
-  m_nodeType = nodeType;
+  if (!m_encodeBuffer)
+    {
+      NS_FATAL_ERROR ("The encode buffer must not be null");
+    }
+}
+
+KpmIndicationHeader::KpmIndicationHeader (GlobalE2nodeType nodeType,
+                                          KpmRicIndicationHeaderValues values,
+                                          Ptr<EncodeBuffer> encodeBuffer, bool useCache)
+  : m_nodeType (nodeType),
+    m_encodeBuffer (encodeBuffer)
+{
+  if (IsDeterministicEncoding ())
+    {
+      UintegerValue epoch;
+      g_kpmDeterministicEpoch.GetValue (epoch);
+      values.m_timestamp = epoch.Get () + Simulator::Now ().GetMilliSeconds ();
+    }
+
+  if (useCache && EncodeFromCache (values))
+    {
+      return;
+    }
+
   E2SM_KPM_IndicationHeader_t *descriptor = new E2SM_KPM_IndicationHeader_t;
   FillAndEncodeKpmRicIndicationHeader (descriptor, values);
   delete descriptor;
 }
 
+/**
+* Pre-encoded RIC Indication Header of an E2 node
+*/
+struct CachedKpmIndicationHeader
+{
+  std::vector<uint8_t> m_bytes; //!< APER encoding of the header
+  size_t m_timestampOffset; //!< offset of the collection timestamp octets in m_bytes
+  bool m_patchable; //!< false if the timestamp could not be located
+};
+
+typedef std::tuple<KpmIndicationHeader::GlobalE2nodeType, std::string, std::string, uint16_t>
+    KpmIndicationHeaderCacheKey;
+
+static std::mutex g_headerCacheMutex;
+static std::map<KpmIndicationHeaderCacheKey, CachedKpmIndicationHeader> g_headerCache;
+
+void
+KpmIndicationHeader::ClearCache ()
+{
+  std::lock_guard<std::mutex> lock (g_headerCacheMutex);
+  g_headerCache.clear ();
+}
+
+uint64_t
+KpmIndicationHeader::GetContentHash () const
+{
+  return Hash64 ((const char *) m_buffer, m_size);
+}
+
+bool
+KpmIndicationHeader::EncodeFromCache (KpmRicIndicationHeaderValues values)
+{
+  KpmIndicationHeaderCacheKey key (m_nodeType, values.m_gnbId, values.m_plmId,
+                                   values.m_nrCellId);
+
+  std::lock_guard<std::mutex> lock (g_headerCacheMutex);
+  auto it = g_headerCache.find (key);
+  if (it == g_headerCache.end ())
+    {
+      it = g_headerCache.emplace (key, CreateCachedHeader (values)).first;
+    }
+
+  const CachedKpmIndicationHeader &cached = it->second;
+  if (!cached.m_patchable)
+    {
+      return false;
+    }
+
+  m_size = cached.m_bytes.size ();
+  if (m_encodeBuffer)
+    {
+      m_encodeBuffer->Assign (cached.m_bytes.data (), m_size);
+      m_buffer = m_encodeBuffer->GetData ();
+    }
+  else
+    {
+      m_buffer = malloc (m_size);
+      memcpy (m_buffer, cached.m_bytes.data (), m_size);
+    }
+
+  uint64_t bigEndianTimestamp = htobe64 (values.m_timestamp);
+  memcpy ((uint8_t *) m_buffer + cached.m_timestampOffset, &bigEndianTimestamp,
+          TIMESTAMP_LIMIT_SIZE);
+  NS_LOG_LOGIC ("RIC Indication Header taken from the cache, timestamp " << values.m_timestamp);
+  return true;
+}
+
+CachedKpmIndicationHeader
+KpmIndicationHeader::CreateCachedHeader (KpmRicIndicationHeaderValues values)
+{
+  // Encode the header with two timestamps that differ in every byte: the
+  // encodings must only differ in the eight timestamp octets, which are
+  // then patched for every report
+  const uint64_t firstTimestamp = 0x0123456789abcdef;
+  const uint64_t secondTimestamp = ~firstTimestamp;
+
+  values.m_timestamp = firstTimestamp;
+  KpmIndicationHeader first (m_nodeType, values, Create<EncodeBuffer> (), false);
+  values.m_timestamp = secondTimestamp;
+  KpmIndicationHeader second (m_nodeType, values, Create<EncodeBuffer> (), false);
+
+  CachedKpmIndicationHeader cached;
+  const uint8_t *firstBytes = (const uint8_t *) first.m_buffer;
+  const uint8_t *secondBytes = (const uint8_t *) second.m_buffer;
+  cached.m_bytes.assign (firstBytes, firstBytes + first.m_size);
+  cached.m_timestampOffset = 0;
+  cached.m_patchable = false;
+
+  if (first.m_size != second.m_size)
+    {
+      NS_LOG_WARN ("The RIC Indication Header size depends on the timestamp, caching disabled");
+      return cached;
+    }
+
+  size_t firstDiff = first.m_size;
+  size_t lastDiff = 0;
+  for (size_t i = 0; i < first.m_size; i++)
+    {
+      if (firstBytes[i] != secondBytes[i])
+        {
+          firstDiff = std::min (firstDiff, i);
+          lastDiff = i;
+        }
+    }
+
+  uint64_t firstBigEndian = htobe64 (firstTimestamp);
+  uint64_t secondBigEndian = htobe64 (secondTimestamp);
+  if (firstDiff + TIMESTAMP_LIMIT_SIZE <= first.m_size
+      && lastDiff < firstDiff + TIMESTAMP_LIMIT_SIZE
+      && memcmp (firstBytes + firstDiff, &firstBigEndian, TIMESTAMP_LIMIT_SIZE) == 0
+      && memcmp (secondBytes + firstDiff, &secondBigEndian, TIMESTAMP_LIMIT_SIZE) == 0)
+    {
+      cached.m_timestampOffset = firstDiff;
+      cached.m_patchable = true;
+    }
+  else
+    {
+      NS_LOG_WARN ("Unable to locate the timestamp in the RIC Indication Header, caching disabled");
+    }
+
+  NS_LOG_LOGIC ("Cached RIC Indication Header for gNB " << values.m_gnbId << " size "
+                                                        << cached.m_bytes.size ()
+                                                        << " timestamp offset "
+                                                        << cached.m_timestampOffset);
+  return cached;
+}
+
 KpmIndicationHeader::~KpmIndicationHeader ()
 {
   NS_LOG_FUNCTION (this);
-  free (m_buffer);
+  if (!m_encodeBuffer)
+    {
+      free (m_buffer);
+    }
   m_size = 0;
 }
 
 void
 KpmIndicationHeader::Encode (E2SM_KPM_IndicationHeader_t *descriptor)
 {
+  if (m_encodeBuffer)
+    {
+      m_size = m_encodeBuffer->Encode (&asn_DEF_E2SM_KPM_IndicationHeader, descriptor);
+      m_buffer = m_encodeBuffer->GetData ();
+      return;
+    }
+
   asn_codec_ctx_t *opt_cod = 0; // disable stack bounds checking
   asn_encode_to_new_buffer_result_s encodedHeader = asn_encode_to_new_buffer (
       opt_cod, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_IndicationHeader, descriptor);
@@ -202,8 +482,22 @@ KpmIndicationHeader::FillAndEncodeKpmRicIndicationHeader (E2SM_KPM_IndicationHea
     // TraceMessage (&asn_DEF_E2SM_KPM_IndicationHeader, header, "RIC Indication Header");
 }
 
-KpmIndicationMessage::KpmIndicationMessage (KpmIndicationMessageValues values)
+KpmIndicationMessage::KpmIndicationMessage (const KpmIndicationMessageValues &values)
+{
+  E2SM_KPM_IndicationMessage_t *descriptor = new E2SM_KPM_IndicationMessage_t ();
+  CheckConstraints (values);
+  FillAndEncodeKpmIndicationMessage (descriptor, values);
+  delete descriptor;
+}
+
+KpmIndicationMessage::KpmIndicationMessage (const KpmIndicationMessageValues &values,
+                                            Ptr<EncodeBuffer> encodeBuffer)
+  : m_encodeBuffer (encodeBuffer)
 {
+  if (!m_encodeBuffer)
+    {
+      NS_FATAL_ERROR ("The encode buffer must not be null");
+    }
   E2SM_KPM_IndicationMessage_t *descriptor = new E2SM_KPM_IndicationMessage_t ();
   CheckConstraints (values);
   FillAndEncodeKpmIndicationMessage (descriptor, values);
@@ -212,12 +506,21 @@ KpmIndicationMessage::KpmIndicationMessage (KpmIndicationMessageValues values)
 
 KpmIndicationMessage::~KpmIndicationMessage ()
 {
-  free (m_buffer);
+  if (!m_encodeBuffer)
+    {
+      free (m_buffer);
+    }
   m_size = 0;
 }
 
+uint64_t
+KpmIndicationMessage::GetContentHash () const
+{
+  return Hash64 ((const char *) m_buffer, m_size);
+}
+
 void
-KpmIndicationMessage::CheckConstraints (KpmIndicationMessageValues values)
+KpmIndicationMessage::CheckConstraints (const KpmIndicationMessageValues &values)
 {
   // TODO remove?
   // if (values.m_crnti.length () != 2)
@@ -238,6 +541,13 @@ KpmIndicationMessage::CheckConstraints (KpmIndicationMessageValues values)
 void
 KpmIndicationMessage::Encode (E2SM_KPM_IndicationMessage_t *descriptor)
 {
+  if (m_encodeBuffer)
+    {
+      m_size = m_encodeBuffer->Encode (&asn_DEF_E2SM_KPM_IndicationMessage, descriptor);
+      m_buffer = m_encodeBuffer->GetData ();
+      return;
+    }
+
   asn_codec_ctx_t *opt_cod = 0; // disable stack bounds checking
   asn_encode_to_new_buffer_result_s encodedMsg = asn_encode_to_new_buffer (
       opt_cod, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_IndicationMessage, descriptor);
@@ -282,47 +592,49 @@ void
 KpmIndicationMessage::FillOCuUpContainer (PF_Container_t *ranContainer,
                                           Ptr<OCuUpContainerValues> values)
 {
-  OCUUP_PF_Container_t* ocuup = (OCUUP_PF_Container_t*) calloc (1, sizeof (OCUUP_PF_Container_t));
-  PF_ContainerListItem_t* pcli = (PF_ContainerListItem_t*) calloc (1, sizeof (PF_ContainerListItem_t));
+  Asn1cArena &arena = GetMessageArena ();
+
+  OCUUP_PF_Container_t* ocuup = arena.Allocate<OCUUP_PF_Container_t> ();
+  PF_ContainerListItem_t* pcli = arena.Allocate<PF_ContainerListItem_t> ();
   pcli->interface_type = NI_Type_x2_u;
   
-  CUUPMeasurement_Container_t* cuuppmc = (CUUPMeasurement_Container_t*) calloc (1, sizeof (CUUPMeasurement_Container_t)); 
-  PlmnID_Item_t* plmnItem = (PlmnID_Item_t*) calloc (1, sizeof (PlmnID_Item_t)); 
-  Ptr<OctetString> plmnidstr = Create<OctetString> (values->m_plmId, 3);
-  plmnItem->pLMN_Identity = plmnidstr->GetValue ();
+  PlmnID_Item_t* plmnItem = arena.Allocate<PlmnID_Item_t> ();
+  FillArenaOctetString (arena, &plmnItem->pLMN_Identity, values->m_plmId, 3);
   
-  EPC_CUUP_PM_Format_t* cuuppmf = (EPC_CUUP_PM_Format_t*) calloc (1, sizeof (EPC_CUUP_PM_Format_t));
+  EPC_CUUP_PM_Format_t* cuuppmf = arena.Allocate<EPC_CUUP_PM_Format_t> ();
   plmnItem->cu_UP_PM_EPC = cuuppmf;
-  PerQCIReportListItemFormat_t* pqrli = (PerQCIReportListItemFormat_t*) calloc (1, sizeof (PerQCIReportListItemFormat_t));
+  PerQCIReportListItemFormat_t* pqrli = arena.Allocate<PerQCIReportListItemFormat_t> ();
   pqrli->drbqci = 0;
 
-  INTEGER_t *pDCPBytesDL = (INTEGER_t *) calloc (1, sizeof (INTEGER_t));
-  INTEGER_t *pDCPBytesUL = (INTEGER_t *) calloc (1, sizeof (INTEGER_t));
+  INTEGER_t *pDCPBytesDL = arena.Allocate<INTEGER_t> ();
+  INTEGER_t *pDCPBytesUL = arena.Allocate<INTEGER_t> ();
 
-  asn_long2INTEGER (pDCPBytesDL, values->m_pDCPBytesDL);
-  asn_long2INTEGER (pDCPBytesUL, values->m_pDCPBytesUL);
+  FillArenaInteger (arena, pDCPBytesDL, values->m_pDCPBytesDL);
+  FillArenaInteger (arena, pDCPBytesUL, values->m_pDCPBytesUL);
 
   pqrli->pDCPBytesDL = pDCPBytesDL;
   pqrli->pDCPBytesUL = pDCPBytesUL;
 
-  ASN_SEQUENCE_ADD (&cuuppmf->perQCIReportList_cuup.list, pqrli);
+  arena.AllocateList (&cuuppmf->perQCIReportList_cuup.list, 1);
+  Asn1cArena::AddToList (&cuuppmf->perQCIReportList_cuup.list, pqrli);
 
-  ASN_SEQUENCE_ADD (&cuuppmc->plmnList.list, plmnItem);
+  arena.AllocateList (&pcli->o_CU_UP_PM_Container.plmnList.list, 1);
+  Asn1cArena::AddToList (&pcli->o_CU_UP_PM_Container.plmnList.list, plmnItem);
 
-  pcli->o_CU_UP_PM_Container = *cuuppmc;
-  ASN_SEQUENCE_ADD (&ocuup->pf_ContainerList, pcli);
+  arena.AllocateList (&ocuup->pf_ContainerList.list, 1);
+  Asn1cArena::AddToList (&ocuup->pf_ContainerList.list, pcli);
   ranContainer->choice.oCU_UP = ocuup;
   ranContainer->present = PF_Container_PR_oCU_UP;
-
-  free (cuuppmc);
 }
 
 void
 KpmIndicationMessage::FillOCuCpContainer (PF_Container_t *ranContainer,
                                           Ptr<OCuCpContainerValues> values)
 {
-  OCUCP_PF_Container_t *ocucp = (OCUCP_PF_Container_t *) calloc (1, sizeof(OCUCP_PF_Container_t));
-  long *numActiveUes = (long *) calloc (1, sizeof (long));
+  Asn1cArena &arena = GetMessageArena ();
+
+  OCUCP_PF_Container_t *ocucp = arena.Allocate<OCUCP_PF_Container_t> ();
+  long *numActiveUes = arena.Allocate<long> ();
   *numActiveUes = long(values->m_numActiveUes);
   ocucp->cu_CP_Resource_Status.numberOfActive_UEs = numActiveUes;
   ranContainer->choice.oCU_CP = ocucp;
@@ -333,63 +645,64 @@ void
 KpmIndicationMessage::FillODuContainer (PF_Container_t *ranContainer,
                                         Ptr<ODuContainerValues> values)
 {
-  ODU_PF_Container_t *odu = (ODU_PF_Container_t *) calloc (1, sizeof (ODU_PF_Container_t));
+  Asn1cArena &arena = GetMessageArena ();
+
+  ODU_PF_Container_t *odu = arena.Allocate<ODU_PF_Container_t> ();
+  arena.AllocateList (&odu->cellResourceReportList.list,
+                      values->m_cellResourceReportItems.size ());
   
-  for (auto cellReport : values->m_cellResourceReportItems)
+  for (const auto &cellReport : values->m_cellResourceReportItems)
     {
       NS_LOG_LOGIC ("O-DU: Add Cell Resource Report Item");
-      CellResourceReportListItem_t *crrli =
-          (CellResourceReportListItem_t *) calloc (1, sizeof (CellResourceReportListItem_t));
+      CellResourceReportListItem_t *crrli = arena.Allocate<CellResourceReportListItem_t> ();
 
-      Ptr<OctetString> plmnid = Create<OctetString> (cellReport->m_plmId, 3);
-      Ptr<NrCellId> nrcellid = Create<NrCellId> (cellReport->m_nrCellId);
-      crrli->nRCGI.pLMN_Identity = plmnid->GetValue ();
-      crrli->nRCGI.nRCellIdentity = nrcellid->GetValue ();
+      FillArenaOctetString (arena, &crrli->nRCGI.pLMN_Identity, cellReport->m_plmId, 3);
+      FillArenaNrCellId (arena, &crrli->nRCGI.nRCellIdentity, cellReport->m_nrCellId);
 
-      long *dlAvailablePrbs = (long *) calloc (1, sizeof (long));
+      long *dlAvailablePrbs = arena.Allocate<long> ();
       *dlAvailablePrbs = cellReport->dlAvailablePrbs;
       crrli->dl_TotalofAvailablePRBs = dlAvailablePrbs;
       
-      long *ulAvailablePrbs = (long *) calloc (1, sizeof (long));
+      long *ulAvailablePrbs = arena.Allocate<long> ();
       *ulAvailablePrbs = cellReport->ulAvailablePrbs;
       crrli->ul_TotalofAvailablePRBs = ulAvailablePrbs;
-      ASN_SEQUENCE_ADD (&odu->cellResourceReportList.list, crrli);
+      Asn1cArena::AddToList (&odu->cellResourceReportList.list, crrli);
       
-      for (auto servedPlmnCell : cellReport->m_servedPlmnPerCellItems)
+      arena.AllocateList (&crrli->servedPlmnPerCellList.list,
+                          cellReport->m_servedPlmnPerCellItems.size ());
+      for (const auto &servedPlmnCell : cellReport->m_servedPlmnPerCellItems)
         {
           NS_LOG_LOGIC ("O-DU: Add Served Plmn Per Cell Item");
-          ServedPlmnPerCellListItem_t *sppcl =
-              (ServedPlmnPerCellListItem_t *) calloc (1, sizeof (ServedPlmnPerCellListItem_t));
-          Ptr<OctetString> servedPlmnId = Create<OctetString> (servedPlmnCell->m_plmId, 3);
-          sppcl->pLMN_Identity = servedPlmnId->GetValue ();
+          ServedPlmnPerCellListItem_t *sppcl = arena.Allocate<ServedPlmnPerCellListItem_t> ();
+          FillArenaOctetString (arena, &sppcl->pLMN_Identity, servedPlmnCell->m_plmId, 3);
           
-          EPC_DU_PM_Container_t *edpc =
-              (EPC_DU_PM_Container_t *) calloc (1, sizeof (EPC_DU_PM_Container_t));
+          EPC_DU_PM_Container_t *edpc = arena.Allocate<EPC_DU_PM_Container_t> ();
+          arena.AllocateList (&edpc->perQCIReportList_du.list,
+                              servedPlmnCell->m_perQciReportItems.size ());
 
-          for (auto perQciReportItem : servedPlmnCell->m_perQciReportItems)
+          for (const auto &perQciReportItem : servedPlmnCell->m_perQciReportItems)
             {
               NS_LOG_LOGIC ("O-DU: Add Per QCI Report Item");
-              PerQCIReportListItem_t *pqrl =
-                  (PerQCIReportListItem_t *) calloc (1, sizeof (PerQCIReportListItem_t));
+              PerQCIReportListItem_t *pqrl = arena.Allocate<PerQCIReportListItem_t> ();
               pqrl->qci = perQciReportItem->m_qci;
               
               NS_ABORT_MSG_IF ((perQciReportItem->m_dlPrbUsage < 0) | (perQciReportItem->m_dlPrbUsage > 100), 
                               "As per ASN definition, dl_PRBUsage should be between 0 and 100");
-              long *dlUsedPrbs = (long *) calloc (1, sizeof (long));
+              long *dlUsedPrbs = arena.Allocate<long> ();
               *dlUsedPrbs = perQciReportItem->m_dlPrbUsage;
               pqrl->dl_PRBUsage = dlUsedPrbs;
               NS_LOG_LOGIC ("DL PRBs " << dlUsedPrbs);
               
               NS_ABORT_MSG_IF ((perQciReportItem->m_ulPrbUsage < 0) | (perQciReportItem->m_ulPrbUsage > 100), 
                               "As per ASN definition, ul_PRBUsage should be between 0 and 100");
-              long *ulUsedPrbs = (long *) calloc (1, sizeof (long));
+              long *ulUsedPrbs = arena.Allocate<long> ();
               *ulUsedPrbs = perQciReportItem->m_ulPrbUsage;
               pqrl->ul_PRBUsage = ulUsedPrbs;
-              ASN_SEQUENCE_ADD (&edpc->perQCIReportList_du.list, pqrl);
+              Asn1cArena::AddToList (&edpc->perQCIReportList_du.list, pqrl);
             }
 
           sppcl->du_PM_EPC = edpc;
-          ASN_SEQUENCE_ADD (&crrli->servedPlmnPerCellList.list, sppcl);
+          Asn1cArena::AddToList (&crrli->servedPlmnPerCellList.list, sppcl);
         }
     }
   ranContainer->choice.oDU = odu;
@@ -398,52 +711,55 @@ KpmIndicationMessage::FillODuContainer (PF_Container_t *ranContainer,
 
 void
 KpmIndicationMessage::FillAndEncodeKpmIndicationMessage (E2SM_KPM_IndicationMessage_t *descriptor,
-                                                         KpmIndicationMessageValues values)
+                                                         const KpmIndicationMessageValues &values)
 {
+  // The whole tree, including the measurement items, is allocated from the
+  // arena and released at once after the encoding. The measurement names,
+  // the L3 RRC measurements and the UE IDs are only referenced by the tree.
+  Asn1cArena &arena = GetMessageArena ();
+
   // Create and fill the RAN Container
-  PF_Container_t *ranContainer = (PF_Container_t *) calloc (1, sizeof (PF_Container_t));
+  PF_Container_t *ranContainer = arena.Allocate<PF_Container_t> ();
   FillPmContainer (ranContainer, values.m_pmContainerValues);
 
   //------- now fill the message
-  PM_Containers_Item_t *containers_list =
-      (PM_Containers_Item_t *) calloc (1, sizeof (PM_Containers_Item_t));
+  PM_Containers_Item_t *containers_list = arena.Allocate<PM_Containers_Item_t> ();
   containers_list->performanceContainer = ranContainer;
 
-  E2SM_KPM_IndicationMessage_Format1_t *format = (E2SM_KPM_IndicationMessage_Format1_t *) calloc (
-      1, sizeof (E2SM_KPM_IndicationMessage_Format1_t));
+  E2SM_KPM_IndicationMessage_Format1_t *format =
+      arena.Allocate<E2SM_KPM_IndicationMessage_Format1_t> ();
 
-  ASN_SEQUENCE_ADD (&format->pm_Containers.list, containers_list);
+  arena.AllocateList (&format->pm_Containers.list, 1);
+  Asn1cArena::AddToList (&format->pm_Containers.list, containers_list);
 
   // Cell Object ID
-  CellObjectID_t *cellObjectID = (CellObjectID_t *) calloc (1, sizeof (CellObjectID_t));
-  cellObjectID->size = values.m_cellObjectId.length ();
-  cellObjectID->buf = (uint8_t *) calloc (1, cellObjectID->size);
-  memcpy (cellObjectID->buf, values.m_cellObjectId.c_str (), values.m_cellObjectId.length ());
-  format->cellObjectID = *cellObjectID;
+  FillArenaOctetString (arena, &format->cellObjectID, values.m_cellObjectId,
+                        values.m_cellObjectId.length ());
   
   // Measurement Information List
   if (values.m_cellMeasurementItems)
   {
-      format->list_of_PM_Information = (E2SM_KPM_IndicationMessage_Format1::
-                                        E2SM_KPM_IndicationMessage_Format1__list_of_PM_Information *) 
-                                        calloc (1, sizeof (E2SM_KPM_IndicationMessage_Format1::
-                                        E2SM_KPM_IndicationMessage_Format1__list_of_PM_Information));
-    for (auto item : values.m_cellMeasurementItems->GetItems ())
+    format->list_of_PM_Information = arena.Allocate<std::remove_pointer<decltype (
+        format->list_of_PM_Information)>::type> ();
+    size_t size = values.m_cellMeasurementItems->GetSize ();
+    PM_Info_Item_t *items = values.m_cellMeasurementItems->CreateItems (arena);
+    arena.AllocateList (&format->list_of_PM_Information->list, size);
+    for (size_t i = 0; i < size; i++)
     {
-      ASN_SEQUENCE_ADD (&format->list_of_PM_Information->list, item->GetPointer ());
+      Asn1cArena::AddToList (&format->list_of_PM_Information->list, &items[i]);
     }
   }
   
   // List of matched UEs
   if (values.m_ueIndications.size () > 0)
   {
-    format->list_of_matched_UEs = (E2SM_KPM_IndicationMessage_Format1_t::E2SM_KPM_IndicationMessage_Format1__list_of_matched_UEs*) 
-                                   calloc (1, sizeof (E2SM_KPM_IndicationMessage_Format1_t::E2SM_KPM_IndicationMessage_Format1__list_of_matched_UEs));
-
+    format->list_of_matched_UEs = arena.Allocate<std::remove_pointer<decltype (
+        format->list_of_matched_UEs)>::type> ();
+    arena.AllocateList (&format->list_of_matched_UEs->list, values.m_ueIndications.size ());
 
-    for (auto ueIndication : values.m_ueIndications)
+    for (const auto &ueIndication : values.m_ueIndications)
       {
-        PerUE_PM_Item_t *perUEItem = (PerUE_PM_Item_t *) calloc (1, sizeof (PerUE_PM_Item_t));
+        PerUE_PM_Item_t *perUEItem = arena.Allocate<PerUE_PM_Item_t> ();
 
         // UE Identity
         perUEItem->ueId = ueIndication->GetId ();
@@ -451,16 +767,17 @@ KpmIndicationMessage::FillAndEncodeKpmIndicationMessage (E2SM_KPM_IndicationMess
         // NS_LOG_UNCOND ("Values " << ueIndication->m_drbIPLateDlUEID);
 
         // List of Measurements PM information
-        perUEItem->list_of_PM_Information =
-            (PerUE_PM_Item::PerUE_PM_Item__list_of_PM_Information *) calloc (
-                1, sizeof (PerUE_PM_Item::PerUE_PM_Item__list_of_PM_Information));
+        perUEItem->list_of_PM_Information = arena.Allocate<std::remove_pointer<decltype (
+            perUEItem->list_of_PM_Information)>::type> ();
 
-        for (auto measurementItem : ueIndication->GetItems ())
+        size_t size = ueIndication->GetSize ();
+        PM_Info_Item_t *items = ueIndication->CreateItems (arena);
+        arena.AllocateList (&perUEItem->list_of_PM_Information->list, size);
+        for (size_t i = 0; i < size; i++)
         {
-          ASN_SEQUENCE_ADD (&perUEItem->list_of_PM_Information->list,
-            measurementItem->GetPointer ());
+          Asn1cArena::AddToList (&perUEItem->list_of_PM_Information->list, &items[i]);
         }
-        ASN_SEQUENCE_ADD (&format->list_of_matched_UEs->list, perUEItem);
+        Asn1cArena::AddToList (&format->list_of_matched_UEs->list, perUEItem);
       }
   }
 
@@ -473,9 +790,8 @@ KpmIndicationMessage::FillAndEncodeKpmIndicationMessage (E2SM_KPM_IndicationMess
   // xer_fprint (stderr, &asn_DEF_PF_Container, ranContainer);
   Encode (descriptor);
 
-  free (cellObjectID);
-  // free (ranContainer);
-  ASN_STRUCT_FREE (asn_DEF_E2SM_KPM_IndicationMessage_Format1, format);
+  NS_LOG_LOGIC ("RIC Indication Message tree used " << arena.GetUsedBytes () << " bytes");
+  arena.Reset ();
 }
 
 MeasurementItemList::MeasurementItemList ()
@@ -488,12 +804,241 @@ MeasurementItemList::MeasurementItemList (std::string id)
   m_id = Create<OctetString> (id, id.length ());
 }
 
-MeasurementItemList::~MeasurementItemList (){};
+MeasurementItemList::~MeasurementItemList ()
+{
+  // OctetString only releases the structure, the ID buffer is referenced
+  // by the encoded trees and is released here
+  if (m_id != NULL)
+    {
+      free (m_id->GetPointer ()->buf);
+    }
+
+  ClearItems ();
+}
+
+void
+MeasurementItemList::ClearItems ()
+{
+  // the L3 RRC trees are released by their L3RrcMeasurements, which may
+  // be shared with other lists
+  m_rrcValues.clear ();
+  m_nameIds.clear ();
+  m_valueTypes.clear ();
+  m_valueIndexes.clear ();
+  m_intValues.clear ();
+  m_realValues.clear ();
+}
+
+void
+MeasurementItemList::Reset ()
+{
+  ClearItems ();
+  if (m_id != NULL)
+    {
+      free (m_id->GetPointer ()->buf);
+      m_id = NULL;
+    }
+}
+
+void
+MeasurementItemList::Reset (const std::string &ueId)
+{
+  ClearItems ();
+
+  // the IMSIs of a cell usually have the same length, so the buffer of the
+  // ID is overwritten in place
+  if (m_id != NULL && m_id->GetPointer ()->size == ueId.length ())
+    {
+      memcpy (m_id->GetPointer ()->buf, ueId.c_str (), ueId.length ());
+      return;
+    }
+  if (m_id != NULL)
+    {
+      free (m_id->GetPointer ()->buf);
+    }
+  m_id = Create<OctetString> (ueId, ueId.length ());
+}
+
+void
+MeasurementItemList::AddItem (KpiNameRegistry::Id nameId, MeasurementValue_PR type,
+                              uint32_t valueIndex)
+{
+  m_nameIds.push_back (nameId);
+  m_valueTypes.push_back (type);
+  m_valueIndexes.push_back (valueIndex);
+}
+
+template<>
+void
+MeasurementItemList::AddItem<long> (KpiNameRegistry::Id nameId, long value)
+{
+  NS_LOG_FUNCTION (this << nameId << "long" << value);
+  AddItem (nameId, MeasurementValue_PR_valueInt, m_intValues.size ());
+  m_intValues.push_back (value);
+}
+
+template<>
+void
+MeasurementItemList::AddItem<double> (KpiNameRegistry::Id nameId, double value)
+{
+  NS_LOG_FUNCTION (this << nameId << "double" << value);
+  AddItem (nameId, MeasurementValue_PR_valueReal, m_realValues.size ());
+  m_realValues.push_back (value);
+}
+
+template<>
+void
+MeasurementItemList::AddItem<Ptr<L3RrcMeasurements>> (KpiNameRegistry::Id nameId,
+                                                      Ptr<L3RrcMeasurements> value)
+{
+  NS_LOG_FUNCTION (this << nameId << "L3 RRC" << value);
+  AddItem (nameId, MeasurementValue_PR_valueRRC, m_rrcValues.size ());
+  m_rrcValues.push_back (value);
+}
+
+size_t
+MeasurementItemList::GetSize () const
+{
+  return m_nameIds.size ();
+}
+
+KpiNameRegistry::Id
+MeasurementItemList::GetNameId (size_t i) const
+{
+  return m_nameIds.at (i);
+}
+
+MeasurementValue_PR
+MeasurementItemList::GetValueType (size_t i) const
+{
+  return m_valueTypes.at (i);
+}
+
+double
+MeasurementItemList::GetNumericValue (size_t i) const
+{
+  switch (m_valueTypes.at (i))
+    {
+    case MeasurementValue_PR_valueInt:
+      return m_intValues[m_valueIndexes[i]];
+    case MeasurementValue_PR_valueReal:
+      return m_realValues[m_valueIndexes[i]];
+    default:
+      NS_FATAL_ERROR ("Item " << i << " does not have a numeric value");
+    }
+}
+
+void
+MeasurementItemList::RetainItems (const std::vector<bool> &keep)
+{
+  NS_ABORT_MSG_IF (keep.size () != GetSize (),
+                   "Expected " << GetSize () << " flags, got " << keep.size ());
+
+  // the values of each column are in the order of the items, so the
+  // columns can be compacted in place
+  size_t items = 0;
+  uint32_t ints = 0;
+  uint32_t reals = 0;
+  uint32_t rrcs = 0;
+  for (size_t i = 0; i < keep.size (); i++)
+    {
+      uint32_t valueIndex = m_valueIndexes[i];
+      if (!keep[i])
+        {
+          if (m_valueTypes[i] == MeasurementValue_PR_valueRRC)
+            {
+              m_rrcValues[valueIndex] = nullptr;
+            }
+          continue;
+        }
+
+      m_nameIds[items] = m_nameIds[i];
+      m_valueTypes[items] = m_valueTypes[i];
+      switch (m_valueTypes[i])
+        {
+        case MeasurementValue_PR_valueInt:
+          m_intValues[ints] = m_intValues[valueIndex];
+          m_valueIndexes[items] = ints++;
+          break;
+        case MeasurementValue_PR_valueReal:
+          m_realValues[reals] = m_realValues[valueIndex];
+          m_valueIndexes[items] = reals++;
+          break;
+        case MeasurementValue_PR_valueRRC:
+          m_rrcValues[rrcs] = m_rrcValues[valueIndex];
+          m_valueIndexes[items] = rrcs++;
+          break;
+        default:
+          NS_FATAL_ERROR ("Unsupported measurement value type " << m_valueTypes[i]);
+        }
+      items++;
+    }
+
+  m_nameIds.resize (items);
+  m_valueTypes.resize (items);
+  m_valueIndexes.resize (items);
+  m_intValues.resize (ints);
+  m_realValues.resize (reals);
+  m_rrcValues.resize (rrcs);
+}
+
+PM_Info_Item_t *
+MeasurementItemList::CreateItems (Asn1cArena &arena) const
+{
+  size_t size = GetSize ();
+  PM_Info_Item_t *items = (PM_Info_Item_t *) arena.Allocate (size * sizeof (PM_Info_Item_t));
+  for (size_t i = 0; i < size; i++)
+    {
+      PM_Info_Item_t *item = &items[i];
+
+      // the name is only read by the encoder, so the buffer of the registry
+      // is referenced in place
+      item->pmType.present = MeasurementType_PR_measName;
+      item->pmType.choice.measName = *KpiNameRegistry::GetMeasurementTypeName (m_nameIds[i]);
+
+      item->pmVal.present = m_valueTypes[i];
+      switch (m_valueTypes[i])
+        {
+        case MeasurementValue_PR_valueInt:
+          item->pmVal.choice.valueInt = m_intValues[m_valueIndexes[i]];
+          break;
+        case MeasurementValue_PR_valueReal:
+          item->pmVal.choice.valueReal = m_realValues[m_valueIndexes[i]];
+          break;
+        case MeasurementValue_PR_valueRRC:
+          item->pmVal.choice.valueRRC = m_rrcValues[m_valueIndexes[i]]->GetPointer ();
+          break;
+        default:
+          NS_FATAL_ERROR ("Unsupported measurement value type " << m_valueTypes[i]);
+        }
+    }
+  return items;
+}
 
 std::vector<Ptr<MeasurementItem>>
-MeasurementItemList::GetItems ()
+MeasurementItemList::GetItems () const
 {
-  return m_items;
+  std::vector<Ptr<MeasurementItem>> items;
+  items.reserve (GetSize ());
+  for (size_t i = 0; i < GetSize (); i++)
+    {
+      std::string name = KpiNameRegistry::GetName (m_nameIds[i]);
+      switch (m_valueTypes[i])
+        {
+        case MeasurementValue_PR_valueInt:
+          items.push_back (Create<MeasurementItem> (name, m_intValues[m_valueIndexes[i]]));
+          break;
+        case MeasurementValue_PR_valueReal:
+          items.push_back (Create<MeasurementItem> (name, m_realValues[m_valueIndexes[i]]));
+          break;
+        case MeasurementValue_PR_valueRRC:
+          items.push_back (Create<MeasurementItem> (name, m_rrcValues[m_valueIndexes[i]]));
+          break;
+        default:
+          NS_FATAL_ERROR ("Unsupported measurement value type " << m_valueTypes[i]);
+        }
+    }
+  return items;
 }
 
 OCTET_STRING_t
@@ -503,4 +1048,20 @@ MeasurementItemList::GetId ()
   return m_id->GetValue ();
 }
 
+int
+MeasurementItemList::CompareId (const MeasurementItemList &other) const
+{
+  if (m_id == NULL || other.m_id == NULL)
+    {
+      return (m_id != NULL) - (other.m_id != NULL);
+    }
+  const OCTET_STRING_t *id = m_id->GetPointer ();
+  const OCTET_STRING_t *otherId = other.m_id->GetPointer ();
+  if (id->size != otherId->size)
+    {
+      return id->size < otherId->size ? -1 : 1;
+    }
+  return memcmp (id->buf, otherId->buf, id->size);
+}
+
 } // namespace ns3
@@ -26,7 +26,9 @@
 #define KPM_INDICATION_H
 
 #include "ns3/object.h"
-#include <set>
+#include <ns3/encode-buffer.h>
+#include <ns3/kpi-name-registry.h>
+#include <ns3/ordered-ptr-vector.h>
 
 extern "C" {
   #include "E2SM-KPM-RANfunction-Description.h"
@@ -43,6 +45,16 @@ extern "C" {
 
 namespace ns3 {
 
+  struct CachedKpmIndicationHeader;
+  class Asn1cArena;
+
+  /**
+  * RIC Indication Header.
+  * Only the collection timestamp changes between the headers of the same
+  * E2 node, so the encoding is cached per (node type, gNB ID, PLMN ID,
+  * cell ID) and later headers are obtained by copying the cached bytes
+  * and writing the new timestamp in place.
+  */
   class KpmIndicationHeader : public SimpleRefCount<KpmIndicationHeader>
   {
   public:
@@ -92,11 +104,61 @@ namespace ns3 {
     };
     
     KpmIndicationHeader (GlobalE2nodeType nodeType,KpmRicIndicationHeaderValues values);
+
+    /**
+    * Encode the header into a caller-owned buffer.
+    * m_buffer points into encodeBuffer, so it stays valid only until
+    * the next encoding performed with the same buffer.
+    *
+    * \param nodeType type of the E2 node
+    * \param values struct holding the values to be used to fill the header
+    * \param encodeBuffer buffer the header is encoded into
+    */
+    KpmIndicationHeader (GlobalE2nodeType nodeType, KpmRicIndicationHeaderValues values,
+                         Ptr<EncodeBuffer> encodeBuffer);
     ~KpmIndicationHeader ();
     void* m_buffer;
     size_t m_size;
+
+    /**
+    * Remove all the headers from the cache
+    */
+    static void ClearCache ();
+
+    /**
+    * \return true if the KpmDeterministicEncoding global value is set, in
+    *         which case the collection timestamp of the headers is derived
+    *         from the simulation time and the values passed are ignored
+    */
+    static bool IsDeterministicEncoding ();
+
+    /**
+    * \return a 64-bit hash of the encoded header, e.g., to compare or
+    *         cache the reports of different runs
+    */
+    uint64_t GetContentHash () const;
     
   private: 
+    KpmIndicationHeader (GlobalE2nodeType nodeType, KpmRicIndicationHeaderValues values,
+                         Ptr<EncodeBuffer> encodeBuffer, bool useCache);
+
+    /**
+    * Fill m_buffer from the cached encoding of the header, creating it if
+    * needed, and write the timestamp in place
+    *
+    * \param values struct holding the values to be used to fill the header
+    * \return false if the header cannot be cached and must be encoded
+    */
+    bool EncodeFromCache (KpmRicIndicationHeaderValues values);
+
+    /**
+    * Encode the header and locate the timestamp octets in the encoding
+    *
+    * \param values struct holding the values to be used to fill the header
+    * \return the cache entry
+    */
+    CachedKpmIndicationHeader CreateCachedHeader (KpmRicIndicationHeaderValues values);
+
     /**
     * Fills the KPM INDICATION Header descriptor
     * This function fills the RIC Indication Header with the provided 
@@ -111,30 +173,156 @@ namespace ns3 {
     void Encode (E2SM_KPM_IndicationHeader_t* descriptor);
 
     GlobalE2nodeType m_nodeType;
+    Ptr<EncodeBuffer> m_encodeBuffer; //!< caller-owned buffer, if any
     };
 
+  /**
+  * List of Measurement Information Items, e.g., the KPIs of a UE.
+  * The items are stored by column: the ID of the name of each item in the
+  * KpiNameRegistry, its type and its value, in the column of its type. The PM_Info_Item_t
+  * structures are only created, from an arena, when the list is encoded.
+  */
   class MeasurementItemList : public SimpleRefCount<MeasurementItemList>
   {
   private:
     Ptr<OctetString> m_id; // ID, contains the UE IMSI if used to carry UE-specific measurement items
-    std::vector<Ptr<MeasurementItem>> m_items; //!< list of Measurement Information Items
+    std::vector<KpiNameRegistry::Id> m_nameIds; //!< name of each item
+    std::vector<MeasurementValue_PR> m_valueTypes; //!< type of each item
+    std::vector<uint32_t> m_valueIndexes; //!< index of each item in the column of its type
+    std::vector<long> m_intValues; //!< values of the integer items
+    std::vector<double> m_realValues; //!< values of the real items
+    std::vector<Ptr<L3RrcMeasurements>> m_rrcValues; //!< values of the L3 RRC items
+
+    void AddItem (KpiNameRegistry::Id nameId, MeasurementValue_PR type, uint32_t valueIndex);
+    void ClearItems ();
+
   public:
     MeasurementItemList ();
     MeasurementItemList (std::string ueId);
      ~MeasurementItemList ();
 
-    // NOTE defined here to avoid undefined references
-    template<class T> 
+    /**
+    * Add a Measurement Information Item. Only long, double and
+    * Ptr<L3RrcMeasurements> values are supported. The L3 RRC
+    * measurements are referenced, and can be added to several lists.
+    *
+    * \param nameId the name of the measurement, see KpiNameRegistry
+    * \param value the value of the measurement
+    */
+    template<class T>
+    void AddItem (KpiNameRegistry::Id nameId, T value);
+
+    /**
+    * Add a Measurement Information Item, registering its name. Prefer the
+    * version taking the ID of the name when adding items periodically.
+    *
+    * \param name the name of the measurement
+    * \param value the value of the measurement
+    */
+    template<class T>
     void AddItem (std::string name, T value)
     {
-      Ptr<MeasurementItem> item = Create<MeasurementItem> (name, value);
-      m_items.push_back (item);
+      AddItem<T> (KpiNameRegistry::Register (name), value);
     }
-    
-    std::vector<Ptr<MeasurementItem>> GetItems();
+
+    /**
+    * \return the number of Measurement Information Items
+    */
+    size_t GetSize () const;
+
+    /**
+    * Remove all the items, keeping the capacity of the columns, so that
+    * the list can be reused for the next report
+    */
+    void Reset ();
+
+    /**
+    * Remove all the items and replace the ID, keeping the capacity of the
+    * columns and, if the size does not change, the buffer of the ID
+    *
+    * \param ueId the new ID, e.g., the UE IMSI
+    */
+    void Reset (const std::string &ueId);
+
+    /**
+    * \param i the index of the item
+    * \return the ID of the name of the item in the KpiNameRegistry
+    */
+    KpiNameRegistry::Id GetNameId (size_t i) const;
+
+    /**
+    * \param i the index of the item
+    * \return the type of the value of the item
+    */
+    MeasurementValue_PR GetValueType (size_t i) const;
+
+    /**
+    * \param i the index of an integer or real item
+    * \return the value of the item
+    */
+    double GetNumericValue (size_t i) const;
+
+    /**
+    * Remove the items not flagged in keep, preserving the order of the
+    * others.
+    *
+    * \param keep a flag per item, true if the item must be kept
+    */
+    void RetainItems (const std::vector<bool> &keep);
+
+    /**
+    * Create the PM_Info_Item_t structures of the items in a contiguous
+    * array allocated from the arena. The names are referenced from the
+    * KpiNameRegistry and the structures are valid until the arena is reset.
+    *
+    * \param arena the arena
+    * \return the array of GetSize () items
+    */
+    PM_Info_Item_t *CreateItems (Asn1cArena &arena) const;
+
+    /**
+    * Create a MeasurementItem for each item, e.g., to inspect the list.
+    * Prefer GetSize, GetNameId and the value accessors, which do not
+    * allocate.
+    *
+    * \return the items
+    */
+    std::vector<Ptr<MeasurementItem>> GetItems () const;
+
     OCTET_STRING_t GetId ();
+
+    /**
+    * Compare the IDs of two lists, ordering shorter IDs first and IDs of
+    * the same length byte by byte, i.e., IMSIs numerically. Lists without
+    * ID come first.
+    *
+    * \param other the other list
+    * \return a negative value, zero or a positive value if the ID of this
+    *         list is respectively before, equal to or after the other
+    */
+    int CompareId (const MeasurementItemList &other) const;
+
+    /**
+    * Orders the lists by ID, see CompareId
+    */
+    struct Less
+    {
+      bool
+      operator() (const MeasurementItemList &a, const MeasurementItemList &b) const
+      {
+        return a.CompareId (b) < 0;
+      }
+    };
   };
 
+  template<>
+  void MeasurementItemList::AddItem<long> (KpiNameRegistry::Id nameId, long value);
+  template<>
+  void MeasurementItemList::AddItem<double> (KpiNameRegistry::Id nameId, double value);
+  template<>
+  void MeasurementItemList::AddItem<Ptr<L3RrcMeasurements>> (KpiNameRegistry::Id nameId,
+                                                             Ptr<L3RrcMeasurements> value);
+
   /**
   * Base class to carry PM Container values  
   */    
@@ -174,6 +362,18 @@ namespace ns3 {
     long m_dlPrbUsage; //!< Used number of PRBs in an average of DL for the monitored slice during E2 reporting period
     long m_ulPrbUsage; //!< Used number of PRBs in an average of UL for the monitored slice during E2 reporting period
     virtual ~EpcDuPmContainer () = default;
+
+    /**
+    * Orders the reports by QCI
+    */
+    struct Less
+    {
+      bool
+      operator() (const EpcDuPmContainer &a, const EpcDuPmContainer &b) const
+      {
+        return a.m_qci < b.m_qci;
+      }
+    };
   };
 
   /**
@@ -194,7 +394,19 @@ namespace ns3 {
   public:
     std::string m_plmId; //!< PLMN identity, octet string, 3 bytes
     uint16_t m_nrCellId;
-    std::set<Ptr<EpcDuPmContainer>> m_perQciReportItems;
+    OrderedPtrVector<EpcDuPmContainer, EpcDuPmContainer::Less> m_perQciReportItems; //!< reports, by QCI
+
+    /**
+    * Orders the cells by cell ID and PLMN
+    */
+    struct Less
+    {
+      bool
+      operator() (const ServedPlmnPerCell &a, const ServedPlmnPerCell &b) const
+      {
+        return a.m_nrCellId != b.m_nrCellId ? a.m_nrCellId < b.m_nrCellId : a.m_plmId < b.m_plmId;
+      }
+    };
   };
 
   class CellResourceReport : public SimpleRefCount<CellResourceReport>
@@ -204,7 +416,20 @@ namespace ns3 {
     uint16_t m_nrCellId;
     long dlAvailablePrbs;
     long ulAvailablePrbs;
-    std::set<Ptr<ServedPlmnPerCell>> m_servedPlmnPerCellItems;
+    OrderedPtrVector<ServedPlmnPerCell, ServedPlmnPerCell::Less>
+        m_servedPlmnPerCellItems; //!< served PLMNs, by cell ID
+
+    /**
+    * Orders the reports by cell ID
+    */
+    struct Less
+    {
+      bool
+      operator() (const CellResourceReport &a, const CellResourceReport &b) const
+      {
+        return a.m_nrCellId < b.m_nrCellId;
+      }
+    };
   };
 
   /**
@@ -213,7 +438,8 @@ namespace ns3 {
   class ODuContainerValues : public PmContainerValues
   {
   public:
-    std::set<Ptr<CellResourceReport>> m_cellResourceReportItems;
+    OrderedPtrVector<CellResourceReport, CellResourceReport::Less>
+        m_cellResourceReportItems; //!< cell reports, by cell ID
   };
 
   class KpmIndicationMessage : public SimpleRefCount<KpmIndicationMessage>
@@ -228,17 +454,55 @@ namespace ns3 {
       std::string m_cellObjectId; //!< Cell Object ID
       Ptr<PmContainerValues> m_pmContainerValues; //!< struct containing values to be inserted in the PM Container
       Ptr<MeasurementItemList> m_cellMeasurementItems; //!< list of cell-specific Measurement Information Items
-      std::set<Ptr<MeasurementItemList>> m_ueIndications; //!< list of Measurement Information Items
+      OrderedPtrVector<MeasurementItemList, MeasurementItemList::Less>
+          m_ueIndications; //!< list of Measurement Information Items, by UE ID
+
+      /**
+      * Move the values into another struct, leaving this one without any
+      * reference to their objects. Ptr has no move constructor, so
+      * std::move would leave the references in place, which is not enough
+      * to hand the values over to another thread.
+      *
+      * \param other the destination
+      */
+      void
+      MoveTo (KpmIndicationMessageValues &other)
+      {
+        other.m_cellObjectId = std::move (m_cellObjectId);
+        other.m_pmContainerValues = m_pmContainerValues;
+        m_pmContainerValues = nullptr;
+        other.m_cellMeasurementItems = m_cellMeasurementItems;
+        m_cellMeasurementItems = nullptr;
+        other.m_ueIndications = std::move (m_ueIndications);
+        m_ueIndications.clear ();
+      }
     };
 
-    KpmIndicationMessage (KpmIndicationMessageValues values);
+    KpmIndicationMessage (const KpmIndicationMessageValues &values);
+
+    /**
+    * Encode the message into a caller-owned buffer.
+    * m_buffer points into encodeBuffer, so it stays valid only until
+    * the next encoding performed with the same buffer.
+    *
+    * \param values struct holding the values to be used to fill the message
+    * \param encodeBuffer buffer the message is encoded into
+    */
+    KpmIndicationMessage (const KpmIndicationMessageValues &values,
+                          Ptr<EncodeBuffer> encodeBuffer);
     ~KpmIndicationMessage ();
+
+    /**
+    * \return a 64-bit hash of the encoded message, e.g., to compare or
+    *         cache the reports of different runs
+    */
+    uint64_t GetContentHash () const;
     
     void* m_buffer;
     size_t m_size;
     
   private:
-    static void CheckConstraints (KpmIndicationMessageValues values);
+    static void CheckConstraints (const KpmIndicationMessageValues &values);
     void FillPmContainer (PF_Container_t *ranContainer, 
                           Ptr<PmContainerValues> values);
     void FillOCuUpContainer (PF_Container_t *ranContainer, 
@@ -248,8 +512,10 @@ namespace ns3 {
     void FillODuContainer (PF_Container_t *ranContainer, 
                            Ptr<ODuContainerValues> values);
     void FillAndEncodeKpmIndicationMessage (E2SM_KPM_IndicationMessage_t *descriptor,
-                                            KpmIndicationMessageValues values);
+                                            const KpmIndicationMessageValues &values);
     void Encode (E2SM_KPM_IndicationMessage_t *descriptor);
+
+    Ptr<EncodeBuffer> m_encodeBuffer; //!< caller-owned buffer, if any
   };
 }
 
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpm-trace-reader.h>
+#include <ns3/log.h>
+#include <cstring>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KpmTraceReader");
+
+static const uint8_t DICTIONARY_BLOCK = 1;
+static const uint8_t RECORD_BLOCK = 2;
+
+/**
+* Read a little-endian integer
+*
+* \param in the first byte
+* \param bytes the number of bytes
+* \return the value
+*/
+static uint64_t
+GetLittleEndian (const uint8_t *in, size_t bytes)
+{
+  uint64_t value = 0;
+  for (size_t i = 0; i < bytes; i++)
+    {
+      value |= (uint64_t) in[i] << (8 * i);
+    }
+  return value;
+}
+
+KpmTraceReader::KpmTraceReader (const std::string &fileName)
+  : m_blockRecords (0),
+    m_nextRecord (0)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  m_file.open (fileName, std::ios::in | std::ios::binary);
+  NS_ABORT_MSG_IF (!m_file.is_open (), "Unable to open the KPM trace file " << fileName);
+
+  uint8_t header[12];
+  m_file.read ((char *) header, sizeof (header));
+  NS_ABORT_MSG_IF (!m_file || memcmp (header, "KPMT", 4) != 0
+                       || GetLittleEndian (header + 4, 2) != 1,
+                   fileName << " is not a KPM trace file");
+  m_compression = (KpmTraceWriter::Compression) header[6];
+  NS_ABORT_MSG_IF (m_compression != KpmTraceWriter::NONE && m_compression != KpmTraceWriter::ZSTD,
+                   "Unknown compression " << (uint32_t) header[6] << " of " << fileName);
+  NS_ABORT_MSG_IF (m_compression == KpmTraceWriter::ZSTD && !KpmTraceWriter::IsZstdSupported (),
+                   "The KPM trace reader was built without zstd support");
+}
+
+bool
+KpmTraceReader::Next (Record &record)
+{
+  if (m_nextRecord == m_blockRecords && !ReadRecordBlock ())
+    {
+      return false;
+    }
+
+  // the columns of the block, see KpmTraceWriter
+  size_t n = m_blockRecords;
+  size_t i = m_nextRecord++;
+  const uint8_t *timestamps = m_block.data ();
+  const uint8_t *ueIds = timestamps + 8 * n;
+  const uint8_t *cellIds = ueIds + 8 * n;
+  const uint8_t *kpis = cellIds + 2 * n;
+  const uint8_t *types = kpis + 4 * n;
+  const uint8_t *values = types + n;
+
+  record.m_timestamp = GetLittleEndian (timestamps + 8 * i, 8);
+  record.m_ueId = GetLittleEndian (ueIds + 8 * i, 8);
+  record.m_cellId = GetLittleEndian (cellIds + 2 * i, 2);
+  record.m_kpi = GetLittleEndian (kpis + 4 * i, 4);
+  record.m_type = (MeasurementValue_PR) types[i];
+  uint64_t value = GetLittleEndian (values + 8 * i, 8);
+  record.m_intValue = (int64_t) value;
+  memcpy (&record.m_realValue, &value, sizeof (value));
+  return true;
+}
+
+bool
+KpmTraceReader::ReadRecordBlock ()
+{
+  while (true)
+    {
+      uint8_t header[16];
+      m_file.read ((char *) header, sizeof (header));
+      if (m_file.gcount () == 0)
+        {
+          return false;
+        }
+      NS_ABORT_MSG_IF (m_file.gcount () != sizeof (header), "Truncated KPM trace block header");
+      uint8_t type = header[0];
+      uint32_t entries = GetLittleEndian (header + 4, 4);
+      size_t rawSize = GetLittleEndian (header + 8, 4);
+      size_t storedSize = GetLittleEndian (header + 12, 4);
+
+      m_stored.resize (storedSize);
+      m_file.read ((char *) m_stored.data (), storedSize);
+      NS_ABORT_MSG_IF ((size_t) m_file.gcount () != storedSize, "Truncated KPM trace block");
+
+      // the blocks that do not compress are stored as they are
+      if (storedSize == rawSize)
+        {
+          m_block.swap (m_stored);
+        }
+      else
+        {
+#ifdef HAVE_ZSTD
+          m_block.resize (rawSize);
+          size_t size = ZSTD_decompress (m_block.data (), rawSize, m_stored.data (), storedSize);
+          NS_ABORT_MSG_IF (ZSTD_isError (size) || size != rawSize,
+                           "Corrupted compressed KPM trace block");
+#else
+          NS_FATAL_ERROR ("Compressed KPM trace block, but no zstd support");
+#endif
+        }
+
+      if (type == RECORD_BLOCK)
+        {
+          NS_ABORT_MSG_IF (rawSize != (size_t) entries * (8 + 8 + 2 + 4 + 1 + 8),
+                           "Malformed KPM trace record block");
+          m_blockRecords = entries;
+          m_nextRecord = 0;
+          if (entries > 0)
+            {
+              return true;
+            }
+          continue;
+        }
+
+      NS_ABORT_MSG_IF (type != DICTIONARY_BLOCK, "Unknown KPM trace block type " << (uint32_t) type);
+      size_t offset = 0;
+      for (uint32_t entry = 0; entry < entries; entry++)
+        {
+          NS_ABORT_MSG_IF (rawSize - offset < 6, "Malformed KPM trace dictionary block");
+          uint32_t kpi = GetLittleEndian (m_block.data () + offset, 4);
+          size_t length = GetLittleEndian (m_block.data () + offset + 4, 2);
+          offset += 6;
+          NS_ABORT_MSG_IF (rawSize - offset < length, "Malformed KPM trace dictionary block");
+          m_names[kpi].assign ((const char *) m_block.data () + offset, length);
+          offset += length;
+        }
+    }
+}
+
+std::string
+KpmTraceReader::GetKpiName (uint32_t kpi) const
+{
+  auto it = m_names.find (kpi);
+  return it == m_names.end () ? std::string () : it->second;
+}
+
+KpmTraceWriter::Compression
+KpmTraceReader::GetCompression () const
+{
+  return m_compression;
+}
+
+} // namespace ns3
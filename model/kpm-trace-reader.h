@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPM_TRACE_READER_H
+#define KPM_TRACE_READER_H
+
+#include "ns3/object.h"
+#include <ns3/kpm-trace-writer.h>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Reads back the records of a file written by KpmTraceWriter, e.g., to
+  * post-process an offline run. The blocks are read one at a time, and
+  * decompressed if needed.
+  */
+  class KpmTraceReader : public SimpleRefCount<KpmTraceReader>
+  {
+  public:
+    /**
+    * A record of the trace
+    */
+    struct Record
+    {
+      uint64_t m_timestamp; //!< the collection timestamp
+      uint64_t m_ueId; //!< the ID of the UE, or 0 for cell-level KPIs
+      uint16_t m_cellId; //!< the ID of the cell
+      uint32_t m_kpi; //!< the ID of the KPI in the file, see GetKpiName
+      MeasurementValue_PR m_type; //!< the type of the value
+      int64_t m_intValue; //!< the value, if an integer
+      double m_realValue; //!< the value, if a real
+    };
+
+    /**
+    * Open a trace file and check its header
+    *
+    * \param fileName the name of the file
+    */
+    KpmTraceReader (const std::string &fileName);
+
+    /**
+    * Read the next record
+    *
+    * \param record the record
+    * \return false at the end of the file
+    */
+    bool Next (Record &record);
+
+    /**
+    * \param kpi the ID of a KPI in the file
+    * \return the name of the KPI, or an empty string if the file does not
+    *         name it (yet)
+    */
+    std::string GetKpiName (uint32_t kpi) const;
+
+    /**
+    * \return the compression of the blocks of the file
+    */
+    KpmTraceWriter::Compression GetCompression () const;
+
+  private:
+    /**
+    * Read blocks until a record block, storing the dictionary entries
+    * found on the way
+    *
+    * \return false at the end of the file
+    */
+    bool ReadRecordBlock ();
+
+    std::ifstream m_file; //!< the trace file
+    KpmTraceWriter::Compression m_compression; //!< compression of the blocks
+    std::unordered_map<uint32_t, std::string> m_names; //!< names of the KPIs
+    std::vector<uint8_t> m_stored; //!< block as stored in the file
+    std::vector<uint8_t> m_block; //!< current block, decompressed
+    uint32_t m_blockRecords; //!< records of the current block
+    uint32_t m_nextRecord; //!< index of the next record in the current block
+  };
+
+} // namespace ns3
+
+#endif /* KPM_TRACE_READER_H */
@@ -0,0 +1,273 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/kpm-trace-writer.h>
+#include <ns3/log.h>
+#include <cstring>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("KpmTraceWriter");
+
+static const uint16_t TRACE_VERSION = 1;
+static const uint8_t DICTIONARY_BLOCK = 1;
+static const uint8_t RECORD_BLOCK = 2;
+
+/**
+* Append the least significant bytes of a value, little-endian
+*
+* \param out the destination
+* \param value the value
+* \param bytes the number of bytes
+*/
+static void
+PutLittleEndian (std::vector<uint8_t> &out, uint64_t value, size_t bytes)
+{
+  for (size_t i = 0; i < bytes; i++)
+    {
+      out.push_back ((value >> (8 * i)) & 0xff);
+    }
+}
+
+KpmTraceWriter::KpmTraceWriter (const std::string &fileName, Compression compression,
+                                uint32_t blockRecords)
+  : m_compression (compression),
+    m_blockRecords (blockRecords),
+    m_nRecords (0)
+{
+  NS_LOG_FUNCTION (this << fileName << compression << blockRecords);
+  NS_ABORT_MSG_IF (blockRecords == 0, "A block must hold at least one record");
+  NS_ABORT_MSG_IF (compression == ZSTD && !IsZstdSupported (),
+                   "The KPM trace writer was built without zstd support");
+
+  m_file.open (fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  NS_ABORT_MSG_IF (!m_file.is_open (), "Unable to open the KPM trace file " << fileName);
+
+  m_timestamps.reserve (blockRecords);
+  m_ueIds.reserve (blockRecords);
+  m_cellIds.reserve (blockRecords);
+  m_kpis.reserve (blockRecords);
+  m_types.reserve (blockRecords);
+  m_values.reserve (blockRecords);
+
+  m_block.clear ();
+  m_block.insert (m_block.end (), {'K', 'P', 'M', 'T'});
+  PutLittleEndian (m_block, TRACE_VERSION, 2);
+  PutLittleEndian (m_block, compression, 1);
+  PutLittleEndian (m_block, 0, 5);
+  m_file.write ((const char *) m_block.data (), m_block.size ());
+}
+
+KpmTraceWriter::~KpmTraceWriter ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_file.close ();
+}
+
+void
+KpmTraceWriter::Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                        const MeasurementItemList &items)
+{
+  for (size_t i = 0; i < items.GetSize (); i++)
+    {
+      switch (items.GetValueType (i))
+        {
+        case MeasurementValue_PR_valueInt:
+          Append (timestamp, cellId, ueId, items.GetNameId (i),
+                  (long) items.GetNumericValue (i));
+          break;
+        case MeasurementValue_PR_valueReal:
+          Append (timestamp, cellId, ueId, items.GetNameId (i), items.GetNumericValue (i));
+          break;
+        default:
+          NS_LOG_LOGIC ("Item " << i << " is not numeric, not logged");
+          break;
+        }
+    }
+}
+
+void
+KpmTraceWriter::Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                        KpiNameRegistry::Id kpi, long value)
+{
+  AppendRecord (timestamp, cellId, ueId, kpi, MeasurementValue_PR_valueInt, (int64_t) value);
+}
+
+void
+KpmTraceWriter::Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                        KpiNameRegistry::Id kpi, double value)
+{
+  uint64_t bits;
+  memcpy (&bits, &value, sizeof (bits));
+  AppendRecord (timestamp, cellId, ueId, kpi, MeasurementValue_PR_valueReal, bits);
+}
+
+void
+KpmTraceWriter::AppendRecord (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                              KpiNameRegistry::Id kpi, MeasurementValue_PR type, uint64_t value)
+{
+  if (kpi >= m_named.size ())
+    {
+      m_named.resize (kpi + 1, false);
+    }
+  if (!m_named[kpi])
+    {
+      m_named[kpi] = true;
+      m_unnamed.push_back (kpi);
+    }
+
+  m_timestamps.push_back (timestamp);
+  m_ueIds.push_back (ueId);
+  m_cellIds.push_back (cellId);
+  m_kpis.push_back (kpi);
+  m_types.push_back (type);
+  m_values.push_back (value);
+  m_nRecords++;
+
+  if (m_timestamps.size () == m_blockRecords)
+    {
+      Flush ();
+    }
+}
+
+void
+KpmTraceWriter::Flush ()
+{
+  WriteDictionary ();
+  uint32_t records = m_timestamps.size ();
+  if (records == 0)
+    {
+      return;
+    }
+
+  m_block.clear ();
+  for (uint64_t timestamp : m_timestamps)
+    {
+      PutLittleEndian (m_block, timestamp, 8);
+    }
+  for (uint64_t ueId : m_ueIds)
+    {
+      PutLittleEndian (m_block, ueId, 8);
+    }
+  for (uint16_t cellId : m_cellIds)
+    {
+      PutLittleEndian (m_block, cellId, 2);
+    }
+  for (uint32_t kpi : m_kpis)
+    {
+      PutLittleEndian (m_block, kpi, 4);
+    }
+  m_block.insert (m_block.end (), m_types.begin (), m_types.end ());
+  for (uint64_t value : m_values)
+    {
+      PutLittleEndian (m_block, value, 8);
+    }
+  WriteBlock (RECORD_BLOCK, records);
+
+  m_timestamps.clear ();
+  m_ueIds.clear ();
+  m_cellIds.clear ();
+  m_kpis.clear ();
+  m_types.clear ();
+  m_values.clear ();
+  m_file.flush ();
+}
+
+void
+KpmTraceWriter::WriteDictionary ()
+{
+  if (m_unnamed.empty ())
+    {
+      return;
+    }
+
+  m_block.clear ();
+  for (KpiNameRegistry::Id kpi : m_unnamed)
+    {
+      std::string name = KpiNameRegistry::GetName (kpi);
+      PutLittleEndian (m_block, kpi, 4);
+      PutLittleEndian (m_block, name.size (), 2);
+      m_block.insert (m_block.end (), name.begin (), name.end ());
+    }
+  WriteBlock (DICTIONARY_BLOCK, m_unnamed.size ());
+  m_unnamed.clear ();
+}
+
+void
+KpmTraceWriter::WriteBlock (uint8_t type, uint32_t entries)
+{
+  const uint8_t *payload = m_block.data ();
+  size_t storedSize = m_block.size ();
+
+#ifdef HAVE_ZSTD
+  if (m_compression == ZSTD)
+    {
+      m_compressed.resize (ZSTD_compressBound (m_block.size ()));
+      size_t compressedSize = ZSTD_compress (m_compressed.data (), m_compressed.size (),
+                                             m_block.data (), m_block.size (), 1);
+      NS_ABORT_MSG_IF (ZSTD_isError (compressedSize),
+                       "zstd compression failed: " << ZSTD_getErrorName (compressedSize));
+      // incompressible blocks are stored as they are
+      if (compressedSize < m_block.size ())
+        {
+          payload = m_compressed.data ();
+          storedSize = compressedSize;
+        }
+    }
+#endif
+
+  std::vector<uint8_t> header;
+  header.reserve (16);
+  PutLittleEndian (header, type, 1);
+  PutLittleEndian (header, 0, 3);
+  PutLittleEndian (header, entries, 4);
+  PutLittleEndian (header, m_block.size (), 4);
+  PutLittleEndian (header, storedSize, 4);
+  m_file.write ((const char *) header.data (), header.size ());
+  m_file.write ((const char *) payload, storedSize);
+  NS_ABORT_MSG_IF (!m_file, "Error while writing the KPM trace");
+}
+
+uint64_t
+KpmTraceWriter::GetNRecords () const
+{
+  return m_nRecords;
+}
+
+bool
+KpmTraceWriter::IsZstdSupported ()
+{
+#ifdef HAVE_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+} // namespace ns3
@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef KPM_TRACE_WRITER_H
+#define KPM_TRACE_WRITER_H
+
+#include "ns3/object.h"
+#include <ns3/kpm-indication.h>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Streaming binary log of KPM values, for offline runs that do not need
+  * the E2SM encoding.
+  *
+  * The values are appended as fixed-width records, buffered and written
+  * sequentially in blocks. Each block stores its records by column, which
+  * compresses well. The KPIs are identified by their ID in the
+  * KpiNameRegistry, and the names of the IDs used by a file are written to
+  * it in dictionary blocks, before the first block using them.
+  *
+  * File layout, all integers little-endian:
+  * - header: magic "KPMT", uint16 version (1), uint8 compression, 5
+  *   reserved bytes;
+  * - blocks: uint8 type, 3 reserved bytes, uint32 number of entries,
+  *   uint32 raw size, uint32 stored size, payload of stored size bytes,
+  *   compressed with the compression of the file if smaller than raw;
+  * - dictionary block (type 1) entries: uint32 KPI ID, uint16 name
+  *   length, name;
+  * - record block (type 2) columns: uint64 timestamp[n], uint64 UE
+  *   ID[n] (0 for cell-level KPIs), uint16 cell ID[n], uint32 KPI ID[n],
+  *   uint8 value type[n] (MeasurementValue_PR), 8-byte value[n], int64
+  *   or IEEE 754 double.
+  *
+  * L3 RRC measurements are not numeric and are not logged. The files can
+  * be read back with KpmTraceReader.
+  */
+  class KpmTraceWriter : public SimpleRefCount<KpmTraceWriter>
+  {
+  public:
+    /**
+    * Compression of the blocks
+    */
+    enum Compression
+    {
+      NONE = 0, //!< blocks stored as they are
+      ZSTD = 1 //!< blocks compressed with zstd, if built with zstd support
+    };
+
+    /**
+    * Open a trace file, replacing any existing file
+    *
+    * \param fileName the name of the file
+    * \param compression the compression of the blocks
+    * \param blockRecords the number of records buffered before writing a
+    *        block
+    */
+    KpmTraceWriter (const std::string &fileName, Compression compression = NONE,
+                    uint32_t blockRecords = 4096);
+
+    /**
+    * Write the buffered records and close the file
+    */
+    ~KpmTraceWriter ();
+
+    /**
+    * Append the items of a measurement list
+    *
+    * \param timestamp the collection timestamp
+    * \param cellId the ID of the cell
+    * \param ueId the ID of the UE, or 0 for cell-level KPIs
+    * \param items the measurement items
+    */
+    void Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                 const MeasurementItemList &items);
+
+    /**
+    * Append an integer value
+    *
+    * \param timestamp the collection timestamp
+    * \param cellId the ID of the cell
+    * \param ueId the ID of the UE, or 0 for cell-level KPIs
+    * \param kpi the KPI
+    * \param value the value
+    */
+    void Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId, KpiNameRegistry::Id kpi,
+                 long value);
+
+    /**
+    * Append a real value
+    *
+    * \param timestamp the collection timestamp
+    * \param cellId the ID of the cell
+    * \param ueId the ID of the UE, or 0 for cell-level KPIs
+    * \param kpi the KPI
+    * \param value the value
+    */
+    void Append (uint64_t timestamp, uint16_t cellId, uint64_t ueId, KpiNameRegistry::Id kpi,
+                 double value);
+
+    /**
+    * Write the buffered records to the file
+    */
+    void Flush ();
+
+    /**
+    * \return the number of records appended
+    */
+    uint64_t GetNRecords () const;
+
+    /**
+    * \return true if the writer supports zstd compression
+    */
+    static bool IsZstdSupported ();
+
+  private:
+    /**
+    * Append a record
+    *
+    * \param timestamp the collection timestamp
+    * \param cellId the ID of the cell
+    * \param ueId the ID of the UE
+    * \param kpi the KPI
+    * \param type the type of the value
+    * \param value the value, as stored in the file
+    */
+    void AppendRecord (uint64_t timestamp, uint16_t cellId, uint64_t ueId,
+                       KpiNameRegistry::Id kpi, MeasurementValue_PR type, uint64_t value);
+
+    /**
+    * Write the dictionary entries of the KPIs not yet named in the file
+    */
+    void WriteDictionary ();
+
+    /**
+    * Write a block, compressing m_block if needed
+    *
+    * \param type the type of the block
+    * \param entries the number of entries of the block
+    */
+    void WriteBlock (uint8_t type, uint32_t entries);
+
+    std::ofstream m_file; //!< the trace file
+    Compression m_compression; //!< compression of the blocks
+    uint32_t m_blockRecords; //!< records per block
+    uint64_t m_nRecords; //!< records appended
+
+    std::vector<uint64_t> m_timestamps; //!< buffered timestamps
+    std::vector<uint64_t> m_ueIds; //!< buffered UE IDs
+    std::vector<uint16_t> m_cellIds; //!< buffered cell IDs
+    std::vector<uint32_t> m_kpis; //!< buffered KPI IDs
+    std::vector<uint8_t> m_types; //!< buffered value types
+    std::vector<uint64_t> m_values; //!< buffered values
+
+    std::vector<bool> m_named; //!< true for the KPIs with a dictionary entry
+    std::vector<KpiNameRegistry::Id> m_unnamed; //!< KPIs to add to the dictionary
+    std::vector<uint8_t> m_block; //!< serialized block
+    std::vector<uint8_t> m_compressed; //!< compressed block
+  };
+
+} // namespace ns3
+
+#endif /* KPM_TRACE_WRITER_H */
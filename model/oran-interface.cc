@@ -26,14 +26,32 @@
 #include <ns3/asn1c-types.h>
  
 #include <ns3/log.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/enum.h>
+#include <ns3/simulator.h>
+#include <algorithm>
+#include <chrono>
 #include <thread>
 #include "encode_e2apv1.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 extern "C" {
   #include "RICsubscriptionRequest.h"
   #include "RICactionType.h"
   #include "ProtocolIE-Field.h"
   #include "InitiatingMessage.h"
+  #include "SuccessfulOutcome.h"
+  #include "UnsuccessfulOutcome.h"
+  #include "RICcontrolRequest.h"
+  #include "E2SM-KPM-EventTriggerDefinition.h"
+  #include "E2SM-KPM-EventTriggerDefinition-Format1.h"
+  #include "Trigger-ConditionIE-Item.h"
+  #include "RT-Period-IE.h"
 }
 
 namespace ns3 {
@@ -42,15 +60,140 @@ NS_LOG_COMPONENT_DEFINE ("E2Termination");
 
 NS_OBJECT_ENSURE_REGISTERED (E2Termination);
 
+/**
+* Decode the reporting period from an E2SM-KPM Event Trigger Definition.
+* If the definition carries several trigger conditions the shortest
+* period is used.
+*
+* \param triggerDefinition the encoded Event Trigger Definition
+* \return the reporting period, or zero if the definition cannot be
+*         decoded or carries no period
+*/
+static Time
+DecodeReportingPeriod (const RICeventTriggerDefinition_t &triggerDefinition)
+{
+  // values of the RT-Period-IE enumeration, in ms
+  static const uint16_t periodsMs[] = {10,  20,  32,  40,   60,   64,   70,   80,   128,  160,
+                                       256, 320, 512, 640, 1024, 1280, 2048, 2560, 5120, 10240};
+
+  E2SM_KPM_EventTriggerDefinition_t *eventTrigger = nullptr;
+  asn_dec_rval_t rval =
+      asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_KPM_EventTriggerDefinition,
+                  (void **) &eventTrigger, triggerDefinition.buf, triggerDefinition.size);
+
+  Time period;
+  if (rval.code != RC_OK)
+    {
+      NS_LOG_DEBUG ("Unable to decode the RIC Event Trigger Definition");
+    }
+  else if (eventTrigger->present == E2SM_KPM_EventTriggerDefinition_PR_eventDefinition_Format1
+           && eventTrigger->choice.eventDefinition_Format1->policyTest_List != nullptr)
+    {
+      auto *conditions = &eventTrigger->choice.eventDefinition_Format1->policyTest_List->list;
+      for (int i = 0; i < conditions->count; i++)
+        {
+          RT_Period_IE_t periodIe = conditions->array[i]->report_Period_IE;
+          if (periodIe < 0 || periodIe >= (long) (sizeof (periodsMs) / sizeof (periodsMs[0])))
+            {
+              NS_LOG_DEBUG ("Unknown RT-Period-IE value " << periodIe);
+              continue;
+            }
+          Time conditionPeriod = MilliSeconds (periodsMs[periodIe]);
+          if (period.IsZero () || conditionPeriod < period)
+            {
+              period = conditionPeriod;
+            }
+        }
+    }
+
+  ASN_STRUCT_FREE (asn_DEF_E2SM_KPM_EventTriggerDefinition, eventTrigger);
+  return period;
+}
+
 TypeId E2Termination::GetTypeId ()
 {
   static TypeId tid = TypeId ("ns3::E2Termination")
     .SetParent<Object>()
-    .AddConstructor<E2Termination>();
+    .AddConstructor<E2Termination>()
+    .AddAttribute ("AsyncSend",
+                   "If true, the messages passed to QueueE2Message are encoded and sent "
+                   "by a dedicated thread, so that the caller never blocks on the socket",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&E2Termination::m_asyncSend),
+                   MakeBooleanChecker ())
+    .AddAttribute ("SendQueueDepth",
+                   "Maximum number of messages waiting in the send queue",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&E2Termination::m_sendQueueDepth),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SendQueueFullPolicy",
+                   "What to do with a message when the send queue is full",
+                   EnumValue (E2Termination::DROP),
+                   MakeEnumAccessor (&E2Termination::m_sendQueueFullPolicy),
+                   MakeEnumChecker (E2Termination::DROP, "Drop",
+                                    E2Termination::BLOCK, "Block"))
+    .AddAttribute ("TransportMode",
+                   "E2Sim runs the e2sim main loop on a dedicated thread per termination, "
+                   "Reactor serves the SCTP association of every termination from the "
+                   "event loop shared by the process (see the E2ReactorThreads global value)",
+                   EnumValue (E2Termination::E2SIM),
+                   MakeEnumAccessor (&E2Termination::m_transportMode),
+                   MakeEnumChecker (E2Termination::E2SIM, "E2Sim",
+                                    E2Termination::REACTOR, "Reactor"))
+    .AddAttribute ("EncodeThreads",
+                   "Number of threads encoding and sending the messages passed to "
+                   "EncodeAndSendIndication, or 0 to encode them on the simulator thread",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&E2Termination::m_encodeThreads),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("EncodeQueueDepth",
+                   "Maximum number of messages waiting to be encoded or sent by the "
+                   "encoding threads, beyond which EncodeAndSendIndication blocks",
+                   UintegerValue (256),
+                   MakeUintegerAccessor (&E2Termination::m_encodeQueueDepth),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DeliverOnSimulatorThread",
+                   "If true, the subscription and control requests received from the RIC are "
+                   "passed from the network thread to the simulator thread through a lock-free "
+                   "inbox, and their callbacks run at the next event boundary of the simulation",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&E2Termination::m_deliverOnSimulatorThread),
+                   MakeBooleanChecker ())
+    .AddAttribute ("InboxDepth",
+                   "Maximum number of requests from the RIC waiting for the simulator thread, "
+                   "beyond which the network thread waits",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&E2Termination::m_inboxDepth),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("InboxTimeout",
+                   "Longest wait of the network thread for a free slot of the inbox, "
+                   "after which the request from the RIC is dropped",
+                   TimeValue (Seconds (1)),
+                   MakeTimeAccessor (&E2Termination::m_inboxTimeout),
+                   MakeTimeChecker ());
   return tid;
 }
 
 E2Termination::E2Termination ()
+  : m_asyncSend (false),
+    m_sendQueueDepth (1024),
+    m_sendQueueFullPolicy (DROP),
+    m_senderRunning (false),
+    m_senderParked (false),
+    m_blockedProducers (0),
+    m_queuedMessages (0),
+    m_sentMessages (0),
+    m_droppedMessages (0),
+    m_sendQueueHighWater (0),
+    m_transportMode (E2SIM),
+    m_socket (-1),
+    m_receivedBytes (0),
+    m_encodeThreads (0),
+    m_encodeQueueDepth (256),
+    m_deliverOnSimulatorThread (false),
+    m_inboxDepth (1024),
+    m_inboxTimeout (Seconds (1)),
+    m_reportGeneration (0)
 {
   NS_FATAL_ERROR("Do not use the default constructor");
 }
@@ -64,10 +207,34 @@ E2Termination::E2Termination(const std::string ricAddress,
     m_ricPort (ricPort),
     m_clientPort (clientPort),
     m_gnbId (gnbId),
-    m_plmnId(plmnId)
+    m_plmnId(plmnId),
+    m_asyncSend (false),
+    m_sendQueueDepth (1024),
+    m_sendQueueFullPolicy (DROP),
+    m_senderRunning (false),
+    m_senderParked (false),
+    m_blockedProducers (0),
+    m_queuedMessages (0),
+    m_sentMessages (0),
+    m_droppedMessages (0),
+    m_sendQueueHighWater (0),
+    m_transportMode (E2SIM),
+    m_socket (-1),
+    m_receivedBytes (0),
+    m_encodeThreads (0),
+    m_encodeQueueDepth (256),
+    m_deliverOnSimulatorThread (false),
+    m_inboxDepth (1024),
+    m_inboxTimeout (Seconds (1)),
+    m_reportGeneration (0)
 {
   NS_LOG_FUNCTION (this);
   m_e2sim = new E2Sim;
+  m_headerEncodeBuffer = Create<EncodeBuffer> ();
+  m_messageEncodeBuffer = Create<EncodeBuffer> ();
+  m_transmitBuffer = Create<EncodeBuffer> ();
+  m_inboxBuffer = Create<EncodeBuffer> ();
+  m_reportLifetime = std::make_shared<E2Termination *> (this);
   
   // create a new file which will be used to trace the encoded messages
   // TODO create an appropriate log class to handle these messages
@@ -85,6 +252,9 @@ E2Termination::RegisterFunctionDescToE2Sm (long ranFunctionId, Ptr<FunctionDescr
   memcpy (rfdBuf->buf, ranFunctionDescription->m_buffer, ranFunctionDescription->m_size);
 
   m_e2sim->register_e2sm (ranFunctionId, rfdBuf);
+
+  std::lock_guard<std::mutex> lock (m_callbacksMutex);
+  m_ranFunctionDescriptions[ranFunctionId] = rfdBuf;
 }
 
 void
@@ -92,14 +262,50 @@ E2Termination::RegisterKpmCallbackToE2Sm (long ranFunctionId, Ptr<FunctionDescri
                              SubscriptionCallback sbCb)
 {
   RegisterFunctionDescToE2Sm (ranFunctionId,ranFunctionDescription);
-  m_e2sim->register_subscription_callback (ranFunctionId, sbCb);
+  m_e2sim->register_subscription_callback (ranFunctionId, [this, ranFunctionId] (E2AP_PDU_t *pdu) {
+    ReceiveFromRic (RicRequestInbox::SUBSCRIPTION, ranFunctionId, pdu, false);
+  });
+
+  std::lock_guard<std::mutex> lock (m_callbacksMutex);
+  m_subscriptionCallbacks[ranFunctionId] = sbCb;
 }
 
 void
 E2Termination::RegisterSmCallbackToE2Sm (long ranFunctionId, Ptr<FunctionDescription> ranFunctionDescription, SmCallback smCb)
 {
   RegisterFunctionDescToE2Sm (ranFunctionId,ranFunctionDescription);
-  m_e2sim->register_sm_callback (ranFunctionId, smCb);
+  m_e2sim->register_sm_callback (ranFunctionId, [this, ranFunctionId] (E2AP_PDU_t *pdu) {
+    ReceiveFromRic (RicRequestInbox::CONTROL, ranFunctionId, pdu, false);
+  });
+
+  std::lock_guard<std::mutex> lock (m_callbacksMutex);
+  m_smCallbacks[ranFunctionId] = smCb;
+}
+
+void
+E2Termination::RegisterControlDispatcher (long ranFunctionId,
+                                          Ptr<FunctionDescription> ranFunctionDescription,
+                                          Ptr<RicControlDispatcher> dispatcher)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId);
+  RegisterSmCallbackToE2Sm (ranFunctionId, ranFunctionDescription, [this, dispatcher] (E2AP_PDU_t *pdu) {
+    RicControlMessage message (pdu, m_controlArena);
+    uint32_t handled = dispatcher->Dispatch (message);
+    NS_LOG_DEBUG ("Dispatched " << handled << " RAN parameters of RIC Control Message");
+  });
+}
+
+RicControlDecodeArena&
+E2Termination::GetControlDecodeArena ()
+{
+  return m_controlArena;
+}
+
+void
+E2Termination::RegisterReportCallback (long ranFunctionId, ReportCallback reportCb)
+{
+  std::lock_guard<std::mutex> lock (m_callbacksMutex);
+  m_reportCallbacks[ranFunctionId] = reportCb;
 }
 
 void E2Termination::Start ()
@@ -108,6 +314,45 @@ void E2Termination::Start ()
 
   NS_ABORT_MSG_IF(m_ricAddress.empty(), "Set the RIC information first");
   
+  if (m_asyncSend && !m_sendQueue)
+    {
+      NS_LOG_INFO ("Asynchronous send enabled, queue depth " << m_sendQueueDepth);
+      m_sendQueue.reset (new BoundedMpscQueue<QueuedPdu> (m_sendQueueDepth));
+      m_senderRunning = true;
+      m_senderThread = std::thread (&E2Termination::DoSend, this);
+    }
+
+  if (m_deliverOnSimulatorThread && !m_inbox)
+    {
+      NS_LOG_INFO ("RIC requests delivered on the simulator thread, inbox depth " << m_inboxDepth);
+      // the drain events only hold a weak reference to the inbox, so they
+      // are harmless once the termination is destroyed
+      m_inbox = std::make_shared<RicRequestInbox> (
+          m_inboxDepth, m_inboxTimeout,
+          [this] (const RicRequestInbox::Request &request) {
+            DeliverFromRic (request.m_kind, request.m_ranFunctionId, request.m_pdu);
+          });
+    }
+
+  if (m_encodeThreads > 0 && !m_encodeOffload)
+    {
+      NS_LOG_INFO ("Encoding offloaded to " << m_encodeThreads << " threads");
+      m_encodeOffload.reset (new KpmEncodeOffload (
+          m_encodeThreads, m_encodeQueueDepth,
+          [this] (const KpmEncodeOffload::Job &job, Ptr<KpmIndicationMessage> message) {
+            DoSendIndicationToSubscribers (job.m_timestamp, job.m_ranFunctionId,
+                                           job.m_header.data (), job.m_header.size (),
+                                           (const uint8_t *) message->m_buffer,
+                                           message->m_size);
+          }));
+    }
+
+  if (m_transportMode == REACTOR)
+    {
+      DoStartReactor ();
+      return;
+    }
+
   // create a thread to host e2sim execution
   std::thread e2simThread (&E2Termination::DoStart, this);
   e2simThread.detach ();
@@ -140,6 +385,24 @@ void E2Termination::DoStart ()
 E2Termination::~E2Termination ()
 {
   NS_LOG_FUNCTION (this);
+  // the encoding threads send the pending messages before stopping
+  m_encodeOffload.reset ();
+  StopSender ();
+  CloseSocket ();
+
+  if (m_inbox)
+    {
+      m_inbox->Close ();
+    }
+
+  // the report events still pending, including the first ones that could
+  // not be cancelled, find the token expired
+  m_reportLifetime.reset ();
+  {
+    std::lock_guard<std::mutex> lock (m_reportSchedulesMutex);
+    m_reportSchedules.clear ();
+  }
+
   delete m_e2sim;
 }
 
@@ -170,8 +433,10 @@ E2Termination::ProcessRicSubscriptionRequest (E2AP_PDU_t* sub_req_pdu)
   uint16_t reqInstanceId {};
   uint16_t ranFuncionId {};
   uint8_t reqActionId {};
+  Time reportingPeriod;
   
   std::vector<long> actionIdsAccept;
+  std::vector<long> actionTypesAccept;
   std::vector<long> actionIdsReject;
   
   // iterate over the IEs
@@ -207,23 +472,16 @@ E2Termination::ProcessRicSubscriptionRequest (E2AP_PDU_t* sub_req_pdu)
           RICsubscriptionDetails_t subDetails = next_ie->value.choice.RICsubscriptionDetails;
           
           // RIC Event Trigger Definition
-          RICeventTriggerDefinition_t triggerDef = subDetails.ricEventTriggerDefinition;
-
-          // TODO How to decode this field?
-          uint8_t size = 20;  
-          uint8_t *buf = (uint8_t *)calloc(1,size);
-          memcpy(buf, &triggerDef, size);
-          NS_LOG_DEBUG ("RIC Event Trigger Definition " << std::to_string (*buf));
-                    
+          reportingPeriod = DecodeReportingPeriod (subDetails.ricEventTriggerDefinition);
+          NS_LOG_DEBUG ("Reporting period " << reportingPeriod.As (Time::MS));
+
           // Sequence of actions
           RICactions_ToBeSetup_List_t actionList = subDetails.ricAction_ToBeSetup_List;
-          // TODO We are ignoring the trigger definition
   
           int actionCount = actionList.list.count;
           NS_LOG_DEBUG ("Number of actions " << actionCount);
   
           auto **item_array = actionList.list.array;
-          bool foundAction = false;
   
           for (int i = 0; i < actionCount; i++) 
           {
@@ -231,20 +489,21 @@ E2Termination::ProcessRicSubscriptionRequest (E2AP_PDU_t* sub_req_pdu)
             RICactionID_t actionId = ((RICaction_ToBeSetup_ItemIEs*)next_item)->value.choice.RICaction_ToBeSetup_Item.ricActionID;
             RICactionType_t actionType = ((RICaction_ToBeSetup_ItemIEs*)next_item)->value.choice.RICaction_ToBeSetup_Item.ricActionType;
                         
-            //We identify the first action whose type is REPORT
-            //That is the only one accepted; all others are rejected
-            if (!foundAction && (actionType == RICactionType_report || actionType == RICactionType_insert))
+            // Every REPORT and INSERT action is accepted, all others are rejected
+            if (actionType == RICactionType_report || actionType == RICactionType_insert)
             {
-              reqActionId = actionId;
-              actionIdsAccept.push_back(reqActionId);
+              if (actionIdsAccept.empty ())
+              {
+                reqActionId = actionId;
+              }
+              actionIdsAccept.push_back (actionId);
+              actionTypesAccept.push_back (actionType);
               NS_LOG_DEBUG ("Action ID " << actionId << " accepted");
-              foundAction = true;
             } 
             else 
             {
-              reqActionId = actionId;
               NS_LOG_DEBUG ("Action ID " << actionId << " rejected");
-              // actionIdsReject.push_back(reqActionId);
+              actionIdsReject.push_back (actionId);
             }
           }
           break;
@@ -257,32 +516,1336 @@ E2Termination::ProcessRicSubscriptionRequest (E2AP_PDU_t* sub_req_pdu)
       }
   }
   
+  RicSubscriptionRequest_rval_s reqParams;
+  reqParams.requestorId = reqRequestorId;
+  reqParams.instanceId = reqInstanceId;
+  reqParams.ranFuncionId = ranFuncionId;
+  reqParams.actionId = reqActionId;
+  reqParams.accepted = !actionIdsAccept.empty ();
+
+  if (!reqParams.accepted)
+    {
+      NS_LOG_WARN ("No action accepted for RIC Request ID " << reqRequestorId << "/"
+                                                             << reqInstanceId);
+      SendRicSubscriptionFailure (reqRequestorId, reqInstanceId, ranFuncionId, actionIdsReject);
+      return reqParams;
+    }
+
   NS_LOG_DEBUG ("Create RIC Subscription Response");
   
   E2AP_PDU *e2ap_pdu = (E2AP_PDU*)calloc(1,sizeof(E2AP_PDU));
 
-  long *accept_array = &actionIdsAccept[0];
-  long *reject_array = &actionIdsReject[0];
+  long *accept_array = actionIdsAccept.data ();
+  long *reject_array = actionIdsReject.data ();
   int accept_size = actionIdsAccept.size();
   int reject_size = actionIdsReject.size();
 
   encoding::generate_e2apv1_subscription_response_success(e2ap_pdu, accept_array, reject_array, accept_size, reject_size, reqRequestorId, reqInstanceId);
 
   NS_LOG_DEBUG ("Send RIC Subscription Response");
-  m_e2sim->encode_and_send_sctp_data(e2ap_pdu);
+  Transmit (e2ap_pdu, Simulator::Now (), false);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, e2ap_pdu);
+
+  auto subscription = std::make_shared<RicSubscription> (actionIdsAccept.size ());
+  subscription->requestorId = reqRequestorId;
+  subscription->instanceId = reqInstanceId;
+  subscription->ranFunctionId = ranFuncionId;
+  subscription->reportingPeriod = reportingPeriod;
+  for (size_t i = 0; i < actionIdsAccept.size (); i++)
+    {
+      subscription->actions[i].actionId = actionIdsAccept[i];
+      subscription->actions[i].actionType = actionTypesAccept[i];
+      subscription->actions[i].indicationSn = 0;
+    }
+  AddSubscription (subscription);
+
+  if (reportingPeriod.IsStrictlyPositive ())
+    {
+      ReportCallback reportCb;
+      {
+        std::lock_guard<std::mutex> lock (m_callbacksMutex);
+        auto it = m_reportCallbacks.find (ranFuncionId);
+        if (it != m_reportCallbacks.end ())
+          {
+            reportCb = it->second;
+          }
+      }
+      if (!reportCb.IsNull ())
+        {
+          StartReportSchedule (reqParams, reportingPeriod, reportCb);
+        }
+    }
 
-  RicSubscriptionRequest_rval_s reqParams;
-  reqParams.requestorId = reqRequestorId;
-  reqParams.instanceId = reqInstanceId;
-  reqParams.ranFuncionId = ranFuncionId;
-  reqParams.actionId = reqActionId;
   return reqParams;
 }
 
+void
+E2Termination::SendRicSubscriptionFailure (uint16_t requestorId, uint16_t instanceId,
+                                           uint16_t ranFunctionId,
+                                           const std::vector<long> &actionIdsReject)
+{
+  E2AP_PDU *e2ap_pdu = (E2AP_PDU *) calloc (1, sizeof (E2AP_PDU));
+  e2ap_pdu->present = E2AP_PDU_PR_unsuccessfulOutcome;
+  UnsuccessfulOutcome_t *unsuccessfulOutcome =
+      (UnsuccessfulOutcome_t *) calloc (1, sizeof (UnsuccessfulOutcome_t));
+  e2ap_pdu->choice.unsuccessfulOutcome = unsuccessfulOutcome;
+  unsuccessfulOutcome->procedureCode = ProcedureCode_id_RICsubscription;
+  unsuccessfulOutcome->criticality = Criticality_reject;
+  unsuccessfulOutcome->value.present = UnsuccessfulOutcome__value_PR_RICsubscriptionFailure;
+  RICsubscriptionFailure_t *failure = &unsuccessfulOutcome->value.choice.RICsubscriptionFailure;
+
+  RICsubscriptionFailure_IEs_t *requestIdIe =
+      (RICsubscriptionFailure_IEs_t *) calloc (1, sizeof (RICsubscriptionFailure_IEs_t));
+  requestIdIe->id = ProtocolIE_ID_id_RICrequestID;
+  requestIdIe->criticality = Criticality_reject;
+  requestIdIe->value.present = RICsubscriptionFailure_IEs__value_PR_RICrequestID;
+  requestIdIe->value.choice.RICrequestID.ricRequestorID = requestorId;
+  requestIdIe->value.choice.RICrequestID.ricInstanceID = instanceId;
+  ASN_SEQUENCE_ADD (&failure->protocolIEs.list, requestIdIe);
+
+  RICsubscriptionFailure_IEs_t *ranFunctionIdIe =
+      (RICsubscriptionFailure_IEs_t *) calloc (1, sizeof (RICsubscriptionFailure_IEs_t));
+  ranFunctionIdIe->id = ProtocolIE_ID_id_RANfunctionID;
+  ranFunctionIdIe->criticality = Criticality_reject;
+  ranFunctionIdIe->value.present = RICsubscriptionFailure_IEs__value_PR_RANfunctionID;
+  ranFunctionIdIe->value.choice.RANfunctionID = ranFunctionId;
+  ASN_SEQUENCE_ADD (&failure->protocolIEs.list, ranFunctionIdIe);
+
+  // every action requested is listed, with the REPORT and INSERT types
+  // being the only ones supported
+  RICsubscriptionFailure_IEs_t *notAdmittedIe =
+      (RICsubscriptionFailure_IEs_t *) calloc (1, sizeof (RICsubscriptionFailure_IEs_t));
+  notAdmittedIe->id = ProtocolIE_ID_id_RICactions_NotAdmitted;
+  notAdmittedIe->criticality = Criticality_reject;
+  notAdmittedIe->value.present = RICsubscriptionFailure_IEs__value_PR_RICaction_NotAdmitted_List;
+  for (long actionId : actionIdsReject)
+    {
+      RICaction_NotAdmitted_ItemIEs_t *itemIe =
+          (RICaction_NotAdmitted_ItemIEs_t *) calloc (1, sizeof (RICaction_NotAdmitted_ItemIEs_t));
+      itemIe->id = ProtocolIE_ID_id_RICaction_NotAdmitted_Item;
+      itemIe->criticality = Criticality_reject;
+      itemIe->value.present = RICaction_NotAdmitted_ItemIEs__value_PR_RICaction_NotAdmitted_Item;
+      itemIe->value.choice.RICaction_NotAdmitted_Item.ricActionID = actionId;
+      itemIe->value.choice.RICaction_NotAdmitted_Item.cause.present = Cause_PR_ricRequest;
+      itemIe->value.choice.RICaction_NotAdmitted_Item.cause.choice.ricRequest =
+          CauseRIC_action_not_supported;
+      ASN_SEQUENCE_ADD (&notAdmittedIe->value.choice.RICaction_NotAdmitted_List.list, itemIe);
+    }
+  ASN_SEQUENCE_ADD (&failure->protocolIEs.list, notAdmittedIe);
+
+  NS_LOG_DEBUG ("Send RIC Subscription Failure");
+  Transmit (e2ap_pdu, Simulator::Now (), false);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, e2ap_pdu);
+}
+
+void
+E2Termination::ProcessRicSubscriptionDeleteRequest (E2AP_PDU_t* del_req_pdu)
+{
+  RICsubscriptionDeleteRequest_t *request =
+      &del_req_pdu->choice.initiatingMessage->value.choice.RICsubscriptionDeleteRequest;
+
+  uint16_t reqRequestorId {};
+  uint16_t reqInstanceId {};
+  uint16_t ranFunctionId {};
+  for (int i = 0; i < request->protocolIEs.list.count; i++)
+    {
+      RICsubscriptionDeleteRequest_IEs_t *ie = request->protocolIEs.list.array[i];
+      switch (ie->value.present)
+        {
+          case RICsubscriptionDeleteRequest_IEs__value_PR_RICrequestID:
+            reqRequestorId = ie->value.choice.RICrequestID.ricRequestorID;
+            reqInstanceId = ie->value.choice.RICrequestID.ricInstanceID;
+            break;
+          case RICsubscriptionDeleteRequest_IEs__value_PR_RANfunctionID:
+            ranFunctionId = ie->value.choice.RANfunctionID;
+            break;
+          default:
+            break;
+        }
+    }
+
+  NS_LOG_DEBUG ("RIC Subscription Delete Request for RIC Request ID "
+                << reqRequestorId << "/" << reqInstanceId << ", RAN Function " << ranFunctionId);
+
+  // deleting an unknown subscription is not an error, the RIC may retry a
+  // request whose response was lost
+  if (!RemoveSubscription (reqRequestorId, reqInstanceId, ranFunctionId))
+    {
+      NS_LOG_WARN ("Unknown subscription " << reqRequestorId << "/" << reqInstanceId
+                                           << ", RAN Function " << ranFunctionId);
+    }
+
+  RicSubscriptionRequest_rval_s params;
+  params.requestorId = reqRequestorId;
+  params.instanceId = reqInstanceId;
+  params.ranFuncionId = ranFunctionId;
+  params.actionId = 0;
+  params.accepted = true;
+  StopReportSchedule (params);
+
+  // RIC Subscription Delete Response
+  E2AP_PDU *e2ap_pdu = (E2AP_PDU *) calloc (1, sizeof (E2AP_PDU));
+  e2ap_pdu->present = E2AP_PDU_PR_successfulOutcome;
+  SuccessfulOutcome_t *successfulOutcome =
+      (SuccessfulOutcome_t *) calloc (1, sizeof (SuccessfulOutcome_t));
+  e2ap_pdu->choice.successfulOutcome = successfulOutcome;
+  successfulOutcome->procedureCode = ProcedureCode_id_RICsubscriptionDelete;
+  successfulOutcome->criticality = Criticality_reject;
+  successfulOutcome->value.present = SuccessfulOutcome__value_PR_RICsubscriptionDeleteResponse;
+  RICsubscriptionDeleteResponse_t *response =
+      &successfulOutcome->value.choice.RICsubscriptionDeleteResponse;
+
+  RICsubscriptionDeleteResponse_IEs_t *requestIdIe =
+      (RICsubscriptionDeleteResponse_IEs_t *) calloc (1,
+                                                      sizeof (RICsubscriptionDeleteResponse_IEs_t));
+  requestIdIe->id = ProtocolIE_ID_id_RICrequestID;
+  requestIdIe->criticality = Criticality_reject;
+  requestIdIe->value.present = RICsubscriptionDeleteResponse_IEs__value_PR_RICrequestID;
+  requestIdIe->value.choice.RICrequestID.ricRequestorID = reqRequestorId;
+  requestIdIe->value.choice.RICrequestID.ricInstanceID = reqInstanceId;
+  ASN_SEQUENCE_ADD (&response->protocolIEs.list, requestIdIe);
+
+  RICsubscriptionDeleteResponse_IEs_t *ranFunctionIdIe =
+      (RICsubscriptionDeleteResponse_IEs_t *) calloc (1,
+                                                      sizeof (RICsubscriptionDeleteResponse_IEs_t));
+  ranFunctionIdIe->id = ProtocolIE_ID_id_RANfunctionID;
+  ranFunctionIdIe->criticality = Criticality_reject;
+  ranFunctionIdIe->value.present = RICsubscriptionDeleteResponse_IEs__value_PR_RANfunctionID;
+  ranFunctionIdIe->value.choice.RANfunctionID = ranFunctionId;
+  ASN_SEQUENCE_ADD (&response->protocolIEs.list, ranFunctionIdIe);
+
+  NS_LOG_DEBUG ("Send RIC Subscription Delete Response");
+  Transmit (e2ap_pdu, Simulator::Now (), false);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, e2ap_pdu);
+}
+
+uint64_t
+E2Termination::GetSubscriptionKey (uint16_t requestorId, uint16_t instanceId,
+                                   uint16_t ranFunctionId)
+{
+  return ((uint64_t) requestorId << 32) | ((uint64_t) instanceId << 16) | ranFunctionId;
+}
+
+void
+E2Termination::AddSubscription (std::shared_ptr<const RicSubscription> subscription)
+{
+  NS_LOG_FUNCTION (this << subscription->requestorId << subscription->instanceId
+                        << subscription->ranFunctionId);
+
+  RemoveSubscription (subscription->requestorId, subscription->instanceId,
+                      subscription->ranFunctionId);
+
+  std::lock_guard<std::mutex> lock (m_subscriptionsMutex);
+  m_subscriptions[GetSubscriptionKey (subscription->requestorId, subscription->instanceId,
+                                      subscription->ranFunctionId)] = subscription;
+  m_subscriptionsPerFunction[subscription->ranFunctionId].push_back (subscription);
+}
+
+bool
+E2Termination::RemoveSubscription (uint16_t requestorId, uint16_t instanceId,
+                                   uint16_t ranFunctionId)
+{
+  std::lock_guard<std::mutex> lock (m_subscriptionsMutex);
+  auto it = m_subscriptions.find (GetSubscriptionKey (requestorId, instanceId, ranFunctionId));
+  if (it == m_subscriptions.end ())
+    {
+      return false;
+    }
+
+  std::vector<std::shared_ptr<const RicSubscription>> &functionSubscriptions =
+      m_subscriptionsPerFunction[ranFunctionId];
+  functionSubscriptions.erase (
+      std::find (functionSubscriptions.begin (), functionSubscriptions.end (), it->second));
+  if (functionSubscriptions.empty ())
+    {
+      m_subscriptionsPerFunction.erase (ranFunctionId);
+    }
+  m_subscriptions.erase (it);
+  return true;
+}
+
+std::shared_ptr<const E2Termination::RicSubscription>
+E2Termination::GetSubscription (uint16_t requestorId, uint16_t instanceId,
+                                uint16_t ranFunctionId) const
+{
+  std::lock_guard<std::mutex> lock (m_subscriptionsMutex);
+  auto it = m_subscriptions.find (GetSubscriptionKey (requestorId, instanceId, ranFunctionId));
+  if (it == m_subscriptions.end ())
+    {
+      return nullptr;
+    }
+  return it->second;
+}
+
+std::vector<std::shared_ptr<const E2Termination::RicSubscription>>
+E2Termination::GetSubscriptions (long ranFunctionId) const
+{
+  std::lock_guard<std::mutex> lock (m_subscriptionsMutex);
+  auto it = m_subscriptionsPerFunction.find (ranFunctionId);
+  if (it == m_subscriptionsPerFunction.end ())
+    {
+      return {};
+    }
+  return it->second;
+}
+
+size_t
+E2Termination::GetNSubscriptions () const
+{
+  std::lock_guard<std::mutex> lock (m_subscriptionsMutex);
+  return m_subscriptions.size ();
+}
+
+void
+E2Termination::StartReportSchedule (RicSubscriptionRequest_rval_s params, Time period,
+                                    ReportCallback reportCb)
+{
+  NS_LOG_FUNCTION (this << params.requestorId << params.instanceId << params.ranFuncionId
+                        << period);
+
+  ReportScheduleKey key (params.requestorId, params.instanceId, params.ranFuncionId);
+  uint64_t generation;
+  {
+    std::lock_guard<std::mutex> lock (m_reportSchedulesMutex);
+    generation = ++m_reportGeneration;
+    ReportSchedule &schedule = m_reportSchedules[key];
+    schedule.m_params = params;
+    schedule.m_period = period;
+    schedule.m_callback = reportCb;
+    schedule.m_generation = generation;
+  }
+
+  // the subscriptions are received outside of the simulator thread, so the
+  // first report is scheduled through the thread-safe ScheduleWithContext;
+  // the events of a previous schedule for the same key stop by themselves
+  // since their generation no longer matches
+  Simulator::ScheduleWithContext (Simulator::NO_CONTEXT, period,
+                                  &E2Termination::FireReportIfAlive,
+                                  std::weak_ptr<E2Termination *> (m_reportLifetime), key,
+                                  generation);
+}
+
+void
+E2Termination::StopReportSchedule (RicSubscriptionRequest_rval_s params)
+{
+  NS_LOG_FUNCTION (this << params.requestorId << params.instanceId << params.ranFuncionId);
+
+  std::lock_guard<std::mutex> lock (m_reportSchedulesMutex);
+  auto it = m_reportSchedules.find (
+      ReportScheduleKey (params.requestorId, params.instanceId, params.ranFuncionId));
+  if (it != m_reportSchedules.end ())
+    {
+      // the pending report, if any, finds the schedule gone
+      m_reportSchedules.erase (it);
+    }
+}
+
+void
+E2Termination::FireReportIfAlive (std::weak_ptr<E2Termination *> lifetime,
+                                  ReportScheduleKey key, uint64_t generation)
+{
+  std::shared_ptr<E2Termination *> termination = lifetime.lock ();
+  if (termination)
+    {
+      (*termination)->FireReport (key, generation);
+    }
+}
+
+void
+E2Termination::FireReport (ReportScheduleKey key, uint64_t generation)
+{
+  RicSubscriptionRequest_rval_s params;
+  ReportCallback reportCb;
+  {
+    std::lock_guard<std::mutex> lock (m_reportSchedulesMutex);
+    auto it = m_reportSchedules.find (key);
+    if (it == m_reportSchedules.end () || it->second.m_generation != generation)
+      {
+        NS_LOG_LOGIC ("Report schedule stopped, generation " << generation);
+        return;
+      }
+    params = it->second.m_params;
+    reportCb = it->second.m_callback;
+    Simulator::Schedule (it->second.m_period, &E2Termination::FireReportIfAlive,
+                         std::weak_ptr<E2Termination *> (m_reportLifetime), key, generation);
+  }
+
+  // invoked without holding the lock, so that the callback can send
+  // messages or modify the subscriptions
+  reportCb (params);
+}
+
 void
 E2Termination::SendE2Message (E2AP_PDU* pdu)
 {
-  m_e2sim->encode_and_send_sctp_data (pdu);
+  Transmit (pdu, Simulator::Now ());
+}
+
+void
+E2Termination::QueueE2Message (E2AP_PDU* pdu)
+{
+  if (!m_sendQueue)
+    {
+      Transmit (pdu, Simulator::Now ());
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+      return;
+    }
+
+  QueuedPdu queued;
+  queued.pdu = pdu;
+  queued.timestamp = Simulator::Now ();
+  Enqueue (queued);
+}
+
+void
+E2Termination::Enqueue (QueuedPdu queued)
+{
+  while (!m_sendQueue->TryPush (queued))
+    {
+      if (m_sendQueueFullPolicy == DROP || !m_senderRunning)
+        {
+          NS_LOG_LOGIC ("Send queue full, dropping the message");
+          m_droppedMessages++;
+          ReleaseQueuedPdu (queued);
+          return;
+        }
+
+      // wait for the sender thread to free a slot. The sender only
+      // notifies once it sees a blocked producer, so the queue is checked
+      // again after this producer is counted: a slot freed before that is
+      // seen by the predicate, one freed after is notified under the mutex
+      std::unique_lock<std::mutex> lock (m_senderMutex);
+      m_blockedProducers++;
+      m_spaceCv.wait (lock, [this] {
+        return m_sendQueue->GetSize () < m_sendQueue->GetCapacity () || !m_senderRunning;
+      });
+      m_blockedProducers--;
+    }
+
+  m_queuedMessages++;
+  uint32_t occupancy = m_sendQueue->GetSize ();
+  uint32_t highWater = m_sendQueueHighWater.load (std::memory_order_relaxed);
+  while (occupancy > highWater
+         && !m_sendQueueHighWater.compare_exchange_weak (highWater, occupancy,
+                                                         std::memory_order_relaxed))
+    {
+    }
+
+  if (m_senderParked)
+    {
+      std::lock_guard<std::mutex> lock (m_senderMutex);
+      m_senderCv.notify_one ();
+    }
+}
+
+void
+E2Termination::ReleaseQueuedPdu (QueuedPdu& queued)
+{
+  if (queued.payload)
+    {
+      DetachIndicationPayload (queued.pdu);
+      queued.payload.reset ();
+    }
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, queued.pdu);
+  queued.pdu = nullptr;
+}
+
+E2AP_PDU*
+E2Termination::CreateIndicationPdu (const uint8_t* header, size_t headerSize,
+                                    const uint8_t* message, size_t messageSize)
+{
+  E2AP_PDU *pdu = (E2AP_PDU *) calloc (1, sizeof (E2AP_PDU));
+  pdu->present = E2AP_PDU_PR_initiatingMessage;
+  InitiatingMessage_t *initiatingMessage =
+      (InitiatingMessage_t *) calloc (1, sizeof (InitiatingMessage_t));
+  pdu->choice.initiatingMessage = initiatingMessage;
+  initiatingMessage->procedureCode = ProcedureCode_id_RICindication;
+  initiatingMessage->criticality = Criticality_ignore;
+  initiatingMessage->value.present = InitiatingMessage__value_PR_RICindication;
+  RICindication_t *indication = &initiatingMessage->value.choice.RICindication;
+
+  // same IEs, in the same order, as generate_e2apv1_indication_request_parameterized
+  static const struct
+  {
+    ProtocolIE_ID_t id;
+    RICindication_IEs__value_PR present;
+  } ies[] = {{ProtocolIE_ID_id_RICrequestID, RICindication_IEs__value_PR_RICrequestID},
+             {ProtocolIE_ID_id_RANfunctionID, RICindication_IEs__value_PR_RANfunctionID},
+             {ProtocolIE_ID_id_RICactionID, RICindication_IEs__value_PR_RICactionID},
+             {ProtocolIE_ID_id_RICindicationSN, RICindication_IEs__value_PR_RICindicationSN},
+             {ProtocolIE_ID_id_RICindicationType, RICindication_IEs__value_PR_RICindicationType},
+             {ProtocolIE_ID_id_RICindicationHeader, RICindication_IEs__value_PR_RICindicationHeader},
+             {ProtocolIE_ID_id_RICindicationMessage,
+              RICindication_IEs__value_PR_RICindicationMessage}};
+
+  for (auto &ieInfo : ies)
+    {
+      RICindication_IEs_t *ie = (RICindication_IEs_t *) calloc (1, sizeof (RICindication_IEs_t));
+      ie->id = ieInfo.id;
+      ie->criticality = Criticality_reject;
+      ie->value.present = ieInfo.present;
+      ASN_SEQUENCE_ADD (&indication->protocolIEs.list, ie);
+    }
+
+  SetIndicationPayload (pdu, header, headerSize, message, messageSize);
+  return pdu;
+}
+
+void
+E2Termination::SetIndicationPayload (E2AP_PDU* pdu, const uint8_t* header, size_t headerSize,
+                                     const uint8_t* message, size_t messageSize)
+{
+  // the payload is only read by the encoder
+  RICindication_IEs_t **array =
+      pdu->choice.initiatingMessage->value.choice.RICindication.protocolIEs.list.array;
+  array[5]->value.choice.RICindicationHeader.buf = (uint8_t *) header;
+  array[5]->value.choice.RICindicationHeader.size = headerSize;
+  array[6]->value.choice.RICindicationMessage.buf = (uint8_t *) message;
+  array[6]->value.choice.RICindicationMessage.size = messageSize;
+}
+
+void
+E2Termination::SetIndicationIds (E2AP_PDU* pdu, const RicSubscription& subscription,
+                                 const RicAction& action, uint16_t sn)
+{
+  RICindication_IEs_t **array =
+      pdu->choice.initiatingMessage->value.choice.RICindication.protocolIEs.list.array;
+  array[0]->value.choice.RICrequestID.ricRequestorID = subscription.requestorId;
+  array[0]->value.choice.RICrequestID.ricInstanceID = subscription.instanceId;
+  array[1]->value.choice.RANfunctionID = subscription.ranFunctionId;
+  array[2]->value.choice.RICactionID = action.actionId;
+  array[3]->value.choice.RICindicationSN = sn;
+  array[4]->value.choice.RICindicationType =
+      action.actionType == RICactionType_insert ? RICindicationType_insert
+                                                : RICindicationType_report;
+}
+
+void
+E2Termination::DetachIndicationPayload (E2AP_PDU* pdu)
+{
+  RICindication_IEs_t **array =
+      pdu->choice.initiatingMessage->value.choice.RICindication.protocolIEs.list.array;
+  array[5]->value.choice.RICindicationHeader.buf = nullptr;
+  array[5]->value.choice.RICindicationHeader.size = 0;
+  array[6]->value.choice.RICindicationMessage.buf = nullptr;
+  array[6]->value.choice.RICindicationMessage.size = 0;
+}
+
+uint32_t
+E2Termination::SendIndicationToSubscribers (long ranFunctionId, const uint8_t* header,
+                                            size_t headerSize, const uint8_t* message,
+                                            size_t messageSize)
+{
+  return DoSendIndicationToSubscribers (Simulator::Now (), ranFunctionId, header, headerSize,
+                                        message, messageSize);
+}
+
+uint32_t
+E2Termination::DoSendIndicationToSubscribers (Time timestamp, long ranFunctionId,
+                                              const uint8_t* header, size_t headerSize,
+                                              const uint8_t* message, size_t messageSize)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId << headerSize << messageSize);
+
+  return DoSendIndication (timestamp, GetSubscriptions (ranFunctionId), header, headerSize,
+                           message, messageSize);
+}
+
+uint32_t
+E2Termination::SendIndicationToSubscription (RicSubscriptionRequest_rval_s subscription,
+                                             const uint8_t* header, size_t headerSize,
+                                             const uint8_t* message, size_t messageSize)
+{
+  NS_LOG_FUNCTION (this << subscription.requestorId << subscription.instanceId
+                        << subscription.ranFuncionId << headerSize << messageSize);
+
+  std::shared_ptr<const RicSubscription> found = GetSubscription (
+      subscription.requestorId, subscription.instanceId, subscription.ranFuncionId);
+  if (!found)
+    {
+      NS_LOG_LOGIC ("Subscription " << subscription.requestorId << "/"
+                                    << subscription.instanceId << " not found");
+      return 0;
+    }
+  return DoSendIndication (Simulator::Now (), {found}, header, headerSize, message, messageSize);
+}
+
+uint32_t
+E2Termination::SendIndicationToSubscription (RicSubscriptionRequest_rval_s subscription,
+                                             Ptr<KpmIndicationHeader> header,
+                                             Ptr<KpmIndicationMessage> message)
+{
+  return SendIndicationToSubscription (subscription, (const uint8_t *) header->m_buffer,
+                                       header->m_size, (const uint8_t *) message->m_buffer,
+                                       message->m_size);
+}
+
+uint32_t
+E2Termination::DoSendIndication (
+    Time timestamp, const std::vector<std::shared_ptr<const RicSubscription>>& subscriptions,
+    const uint8_t* header, size_t headerSize, const uint8_t* message, size_t messageSize)
+{
+  uint32_t sent = 0;
+
+  if (!m_sendQueue)
+    {
+      // a single PDU is patched and sent for every action
+      E2AP_PDU *pdu = nullptr;
+      for (auto &subscription : subscriptions)
+        {
+          for (auto &action : subscription->actions)
+            {
+              // the RIC Indication SN ranges from 0 to 65535
+              uint16_t sn = action.indicationSn++ & 0xFFFF;
+              if (pdu == nullptr)
+                {
+                  pdu = CreateIndicationPdu (header, headerSize, message, messageSize);
+                }
+
+              if (m_transportMode != REACTOR)
+                {
+                  SetIndicationIds (pdu, *subscription, action, sn);
+                  Transmit (pdu, timestamp);
+                  sent++;
+                  continue;
+                }
+
+              std::lock_guard<std::mutex> lock (m_transmitMutex);
+              EncodeIndication (pdu, *subscription, action, sn, header, headerSize, message,
+                                messageSize, m_transmitBuffer);
+              TransmitEncoded (m_transmitBuffer->GetData (), m_transmitBuffer->GetSize (),
+                               timestamp);
+              sent++;
+            }
+        }
+      if (pdu != nullptr)
+        {
+          DetachIndicationPayload (pdu);
+          ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+        }
+      return sent;
+    }
+
+  // the queued PDUs outlive the caller's buffers, so the payload is copied
+  // once and shared by all of them
+  std::shared_ptr<IndicationPayload> payload;
+  for (auto &subscription : subscriptions)
+    {
+      for (auto &action : subscription->actions)
+        {
+          if (!payload)
+            {
+              payload = std::make_shared<IndicationPayload> ();
+              payload->header.assign (header, header + headerSize);
+              payload->message.assign (message, message + messageSize);
+            }
+          QueuedPdu queued;
+          queued.pdu = CreateIndicationPdu (payload->header.data (), payload->header.size (),
+                                            payload->message.data (), payload->message.size ());
+          queued.payload = payload;
+          queued.timestamp = timestamp;
+          SetIndicationIds (queued.pdu, *subscription, action, action.indicationSn++ & 0xFFFF);
+          Enqueue (queued);
+          sent++;
+        }
+    }
+  return sent;
+}
+
+uint32_t
+E2Termination::SendIndicationToSubscribers (long ranFunctionId, Ptr<KpmIndicationHeader> header,
+                                            Ptr<KpmIndicationMessage> message)
+{
+  return SendIndicationToSubscribers (ranFunctionId, (const uint8_t *) header->m_buffer,
+                                      header->m_size, (const uint8_t *) message->m_buffer,
+                                      message->m_size);
+}
+
+uint32_t
+E2Termination::SendIndicationsToSubscribers (long ranFunctionId,
+                                             const std::vector<Ptr<KpmIndicationHeader>>& headers,
+                                             Ptr<KpmIndicationMessageBatch> messages)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId << headers.size ());
+  NS_ABORT_MSG_IF (headers.size () != messages->GetN (),
+                   "The batch has " << messages->GetN () << " messages but " << headers.size ()
+                                    << " headers");
+
+  uint32_t sent = 0;
+  if (m_sendQueue || m_transportMode != REACTOR)
+    {
+      for (size_t i = 0; i < headers.size (); i++)
+        {
+          sent += SendIndicationToSubscribers (ranFunctionId, headers[i], messages->Get (i));
+        }
+      return sent;
+    }
+
+  std::vector<std::shared_ptr<const RicSubscription>> subscriptions =
+      GetSubscriptions (ranFunctionId);
+  if (subscriptions.empty ())
+    {
+      return 0;
+    }
+
+  std::lock_guard<std::mutex> lock (m_transmitMutex);
+  E2AP_PDU *pdu = nullptr;
+  for (size_t i = 0; i < headers.size (); i++)
+    {
+      const uint8_t *header = (const uint8_t *) headers[i]->m_buffer;
+      const uint8_t *message = (const uint8_t *) messages->Get (i)->m_buffer;
+      size_t headerSize = headers[i]->m_size;
+      size_t messageSize = messages->Get (i)->m_size;
+      if (pdu == nullptr)
+        {
+          pdu = CreateIndicationPdu (header, headerSize, message, messageSize);
+        }
+      else
+        {
+          SetIndicationPayload (pdu, header, headerSize, message, messageSize);
+        }
+
+      for (auto &subscription : subscriptions)
+        {
+          for (auto &action : subscription->actions)
+            {
+              if (sent == m_batchBuffers.size ())
+                {
+                  m_batchBuffers.push_back (Create<EncodeBuffer> ());
+                }
+              // the RIC Indication SN ranges from 0 to 65535
+              uint16_t sn = action.indicationSn++ & 0xFFFF;
+              EncodeIndication (pdu, *subscription, action, sn, header, headerSize, message,
+                                messageSize, m_batchBuffers[sent]);
+              sent++;
+            }
+        }
+    }
+  DetachIndicationPayload (pdu);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+
+  TransmitEncodedBatch (m_batchBuffers, sent, Simulator::Now ());
+  return sent;
+}
+
+void
+E2Termination::EncodeAndSendIndication (long ranFunctionId, Ptr<KpmIndicationHeader> header,
+                                        KpmIndicationMessage::KpmIndicationMessageValues &&values)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId);
+
+  if (!m_encodeOffload)
+    {
+      SendIndicationToSubscribers (ranFunctionId, header, Create<KpmIndicationMessage> (values));
+      return;
+    }
+
+  m_encodeOffload->Submit (Simulator::Now (), ranFunctionId, (const uint8_t *) header->m_buffer,
+                           header->m_size, std::move (values));
+}
+
+void
+E2Termination::FlushIndications ()
+{
+  if (m_encodeOffload)
+    {
+      m_encodeOffload->Flush ();
+    }
+}
+
+void
+E2Termination::CollectSentIndicationValues (
+    std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values)
+{
+  if (m_encodeOffload)
+    {
+      m_encodeOffload->CollectEmitted (values);
+    }
+}
+
+void
+E2Termination::EncodeIndication (E2AP_PDU* pdu, const RicSubscription& subscription,
+                                 const RicAction& action, uint16_t sn, const uint8_t* header,
+                                 size_t headerSize, const uint8_t* message, size_t messageSize,
+                                 Ptr<EncodeBuffer> buffer)
+{
+  // the envelope is created from the first indication of the action, and
+  // reused as long as the payload fits in it
+  SetIndicationIds (pdu, subscription, action, sn);
+  if (!action.envelope)
+    {
+      action.envelope = E2apIndicationEnvelope::Create (pdu);
+    }
+  if (!action.envelope
+      || !action.envelope->Encode (buffer, sn, header, headerSize, message, messageSize))
+    {
+      buffer->Encode (&asn_DEF_E2AP_PDU, pdu);
+    }
+}
+
+void
+E2Termination::DoSend ()
+{
+  NS_LOG_FUNCTION (this);
+
+  QueuedPdu queued;
+  while (true)
+    {
+      if (m_sendQueue->TryPop (queued))
+        {
+          Transmit (queued.pdu, queued.timestamp);
+          ReleaseQueuedPdu (queued);
+          m_sentMessages++;
+
+          // orders the pop before reading the blocked producers, which
+          // count themselves before checking the queue
+          std::atomic_thread_fence (std::memory_order_seq_cst);
+          if (m_blockedProducers > 0)
+            {
+              std::lock_guard<std::mutex> lock (m_senderMutex);
+              m_spaceCv.notify_all ();
+            }
+          continue;
+        }
+
+      // the queue is drained before exiting
+      if (!m_senderRunning)
+        {
+          break;
+        }
+
+      std::unique_lock<std::mutex> lock (m_senderMutex);
+      m_senderParked = true;
+      m_senderCv.wait_for (lock, std::chrono::milliseconds (10), [this] {
+        return m_sendQueue->GetSize () > 0 || !m_senderRunning;
+      });
+      m_senderParked = false;
+    }
+}
+
+void
+E2Termination::StopSender ()
+{
+  if (!m_senderThread.joinable ())
+    {
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock (m_senderMutex);
+    m_senderRunning = false;
+    m_senderCv.notify_one ();
+    // the blocked producers drop their messages
+    m_spaceCv.notify_all ();
+  }
+  m_senderThread.join ();
+
+  // a producer may have pushed a message after the last drain of the
+  // sender thread, it is released here
+  QueuedPdu queued;
+  while (m_sendQueue->TryPop (queued))
+    {
+      NS_LOG_LOGIC ("Sender thread stopped, dropping a message");
+      m_droppedMessages++;
+      ReleaseQueuedPdu (queued);
+    }
+  NS_LOG_INFO ("Sender thread stopped, sent " << m_sentMessages << ", dropped "
+                                              << m_droppedMessages);
+}
+
+E2Termination::SendQueueStats
+E2Termination::GetSendQueueStats () const
+{
+  SendQueueStats stats;
+  stats.queued = m_queuedMessages;
+  stats.sent = m_sentMessages;
+  stats.dropped = m_droppedMessages;
+  stats.occupancy = m_sendQueue ? m_sendQueue->GetSize () : 0;
+  stats.highWater = m_sendQueueHighWater;
+  return stats;
+}
+
+void
+E2Termination::DoStartReactor ()
+{
+  NS_LOG_FUNCTION (this);
+
+  m_socket = socket (AF_INET, SOCK_STREAM, IPPROTO_SCTP);
+  if (m_socket < 0)
+    {
+      NS_FATAL_ERROR ("Unable to create the SCTP socket, errno: " << strerror (errno));
+    }
+
+  int reuse = 1;
+  setsockopt (m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof (reuse));
+
+  struct sockaddr_in local;
+  memset (&local, 0, sizeof (local));
+  local.sin_family = AF_INET;
+  local.sin_addr.s_addr = htonl (INADDR_ANY);
+  local.sin_port = htons (m_clientPort);
+  if (bind (m_socket, (struct sockaddr *) &local, sizeof (local)) < 0)
+    {
+      NS_FATAL_ERROR ("Unable to bind the SCTP socket to port " << m_clientPort
+                                                              << ", errno: " << strerror (errno));
+    }
+
+  struct sockaddr_in remote;
+  memset (&remote, 0, sizeof (remote));
+  remote.sin_family = AF_INET;
+  remote.sin_port = htons (m_ricPort);
+  if (inet_pton (AF_INET, m_ricAddress.c_str (), &remote.sin_addr) != 1)
+    {
+      NS_FATAL_ERROR ("Invalid RIC address " << m_ricAddress);
+    }
+  if (connect (m_socket, (struct sockaddr *) &remote, sizeof (remote)) < 0)
+    {
+      NS_FATAL_ERROR ("Unable to connect to the RIC " << m_ricAddress << ":" << m_ricPort
+                                                      << ", errno: " << strerror (errno));
+    }
+
+  NS_LOG_INFO ("In ns3::E2Term: GNB " << m_gnbId << " connected to the RIC " << m_ricAddress
+                                      << ":" << m_ricPort << " from port " << m_clientPort);
+
+  m_receiveBuffer.resize (65536);
+  m_receivedBytes = 0;
+  m_reactor = E2Reactor::GetInstance ();
+  m_reactor->Register (m_socket, [this] (uint32_t events) { HandleSocketEvent (events); });
+
+  // E2 Setup Request with all the registered RAN functions
+  std::vector<encoding::ran_func_info> allFunctions;
+  {
+    std::lock_guard<std::mutex> lock (m_callbacksMutex);
+    for (auto &function : m_ranFunctionDescriptions)
+      {
+        encoding::ran_func_info info;
+        info.ranFunctionId = function.first;
+        info.ranFunctionDesc = function.second;
+        info.ranFunctionRev = (long) 2;
+        allFunctions.push_back (info);
+      }
+  }
+
+  E2AP_PDU_t *setupPdu = (E2AP_PDU_t *) calloc (1, sizeof (E2AP_PDU));
+  encoding::generate_e2apv1_setup_request_parameterized (
+      setupPdu, allFunctions, (uint8_t *) m_gnbId.c_str (), (uint8_t *) m_plmnId.c_str ());
+  NS_LOG_DEBUG ("Send E2 Setup Request");
+  Transmit (setupPdu, Simulator::Now (), false);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, setupPdu);
+}
+
+void
+E2Termination::Transmit (E2AP_PDU* pdu, Time timestamp, bool record)
+{
+  if (m_transportMode != REACTOR)
+    {
+      // e2sim encodes internally, so the PDU is encoded once more to be
+      // recorded
+      if (record)
+        {
+          std::lock_guard<std::mutex> lock (m_transmitMutex);
+          if (m_pduRecorder)
+            {
+              size_t size = m_transmitBuffer->Encode (&asn_DEF_E2AP_PDU, pdu);
+              m_pduRecorder->Record (timestamp, m_transmitBuffer->GetData (), size);
+            }
+        }
+      m_e2sim->encode_and_send_sctp_data (pdu);
+      return;
+    }
+
+  std::lock_guard<std::mutex> lock (m_transmitMutex);
+  size_t size = m_transmitBuffer->Encode (&asn_DEF_E2AP_PDU, pdu);
+  TransmitEncoded (m_transmitBuffer->GetData (), size, timestamp, record);
+}
+
+void
+E2Termination::TransmitEncoded (const uint8_t* buffer, size_t size, Time timestamp,
+                                bool record)
+{
+  // recorded even without a RIC, as with the E2SIM transport, so that a
+  // run can be recorded offline
+  if (m_pduRecorder && record)
+    {
+      m_pduRecorder->Record (timestamp, buffer, size);
+    }
+  if (m_socket < 0)
+    {
+      NS_LOG_WARN ("The association with the RIC is closed, dropping " << size << " bytes");
+      return;
+    }
+
+  // one SCTP message per E2AP PDU
+  while (send (m_socket, buffer, size, MSG_NOSIGNAL) < 0)
+    {
+      if (errno != EINTR)
+        {
+          NS_LOG_ERROR ("Error while sending to the RIC, errno: " << strerror (errno));
+          return;
+        }
+    }
+}
+
+void
+E2Termination::TransmitEncodedBatch (const std::vector<Ptr<EncodeBuffer>>& buffers, size_t n,
+                                     Time timestamp)
+{
+  if (m_pduRecorder)
+    {
+      for (size_t i = 0; i < n; i++)
+        {
+          m_pduRecorder->Record (timestamp, buffers[i]->GetData (),
+                                 buffers[i]->GetSize ());
+        }
+    }
+  if (m_socket < 0)
+    {
+      NS_LOG_WARN ("The association with the RIC is closed, dropping " << n << " PDUs");
+      return;
+    }
+
+  // one SCTP message per E2AP PDU, written with as few system calls as
+  // possible; the descriptors are reused across batches
+  static thread_local std::vector<struct iovec> iovecs;
+  static thread_local std::vector<struct mmsghdr> headers;
+  iovecs.resize (n);
+  headers.resize (n);
+  for (size_t i = 0; i < n; i++)
+    {
+      iovecs[i].iov_base = (void *) buffers[i]->GetData ();
+      iovecs[i].iov_len = buffers[i]->GetSize ();
+      memset (&headers[i], 0, sizeof (struct mmsghdr));
+      headers[i].msg_hdr.msg_iov = &iovecs[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+
+  size_t offset = 0;
+  while (offset < n)
+    {
+      // the kernel caps the messages per call to UIO_MAXIOV
+      unsigned int count = std::min<size_t> (n - offset, 1024);
+      int rc = sendmmsg (m_socket, headers.data () + offset, count, MSG_NOSIGNAL);
+      if (rc < 0)
+        {
+          if (errno == EINTR)
+            {
+              continue;
+            }
+          NS_LOG_ERROR ("Error while sending to the RIC, errno: " << strerror (errno) << ", "
+                                                                   << n - offset
+                                                                   << " PDUs dropped");
+          return;
+        }
+      offset += rc;
+    }
+}
+
+void
+E2Termination::EnablePduRecording (const std::string &fileName)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  // the file is opened before taking the lock, and the previous recorder,
+  // if any, is closed after releasing it
+  std::unique_ptr<E2PduRecorder> recorder (new E2PduRecorder (fileName));
+  {
+    std::lock_guard<std::mutex> lock (m_transmitMutex);
+    m_pduRecorder.swap (recorder);
+  }
+}
+
+void
+E2Termination::DisablePduRecording ()
+{
+  NS_LOG_FUNCTION (this);
+  std::unique_ptr<E2PduRecorder> recorder;
+  {
+    std::lock_guard<std::mutex> lock (m_transmitMutex);
+    m_pduRecorder.swap (recorder);
+  }
+}
+
+void
+E2Termination::SendEncoded (const uint8_t* buffer, size_t size)
+{
+  if (m_transportMode == REACTOR)
+    {
+      // the replayed PDUs were recorded already, and the replay runs
+      // outside of the simulator thread
+      std::lock_guard<std::mutex> lock (m_transmitMutex);
+      TransmitEncoded (buffer, size, Time (), false);
+      return;
+    }
+
+  // e2sim only sends PDUs it encodes itself, so the bytes are decoded
+  // first; unlike with the REACTOR transport this allocates per message
+  E2AP_PDU *pdu = nullptr;
+  asn_dec_rval_t rval = asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU,
+                                    (void **) &pdu, buffer, size);
+  if (rval.code != RC_OK)
+    {
+      NS_LOG_ERROR ("Unable to decode the E2AP PDU to send, " << size << " bytes");
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+      return;
+    }
+  Transmit (pdu, Time (), false);
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+}
+
+void
+E2Termination::HandleSocketEvent (uint32_t events)
+{
+  if (events & EPOLLERR)
+    {
+      int error = 0;
+      socklen_t length = sizeof (error);
+      getsockopt (m_socket, SOL_SOCKET, SO_ERROR, &error, &length);
+      NS_LOG_ERROR ("Error on the association with the RIC, errno: " << strerror (error));
+      CloseSocket ();
+      return;
+    }
+  // with EPOLLIN the pending messages are read first, and the end of the
+  // association is then seen by recvmsg
+  if ((events & (EPOLLHUP | EPOLLRDHUP)) && !(events & EPOLLIN))
+    {
+      NS_LOG_WARN ("The RIC closed the association of GNB " << m_gnbId);
+      CloseSocket ();
+      return;
+    }
+
+  while (true)
+    {
+      if (m_receivedBytes == m_receiveBuffer.size ())
+        {
+          m_receiveBuffer.resize (2 * m_receiveBuffer.size ());
+        }
+
+      struct iovec iov;
+      iov.iov_base = m_receiveBuffer.data () + m_receivedBytes;
+      iov.iov_len = m_receiveBuffer.size () - m_receivedBytes;
+      struct msghdr msg;
+      memset (&msg, 0, sizeof (msg));
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+
+      ssize_t n = recvmsg (m_socket, &msg, MSG_DONTWAIT);
+      if (n < 0)
+        {
+          if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+              return;
+            }
+          NS_LOG_ERROR ("Error while receiving from the RIC, errno: " << strerror (errno));
+          CloseSocket ();
+          return;
+        }
+      if (n == 0)
+        {
+          NS_LOG_WARN ("The RIC closed the association of GNB " << m_gnbId);
+          CloseSocket ();
+          return;
+        }
+
+      m_receivedBytes += n;
+      if (msg.msg_flags & MSG_EOR)
+        {
+          HandleE2Message (m_receiveBuffer.data (), m_receivedBytes);
+          m_receivedBytes = 0;
+        }
+    }
+}
+
+void
+E2Termination::HandleE2Message (const uint8_t* buffer, size_t size)
+{
+  E2AP_PDU_t *pdu = nullptr;
+  asn_dec_rval_t rval = asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU,
+                                    (void **) &pdu, buffer, size);
+  if (rval.code != RC_OK)
+    {
+      NS_LOG_ERROR ("Unable to decode the E2AP PDU received from the RIC, " << size << " bytes");
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+      return;
+    }
+
+  if (pdu->present == E2AP_PDU_PR_initiatingMessage)
+    {
+      InitiatingMessage_t *initiatingMessage = pdu->choice.initiatingMessage;
+      switch (initiatingMessage->value.present)
+        {
+          case InitiatingMessage__value_PR_RICsubscriptionRequest: {
+            RICsubscriptionRequest_t *request =
+                &initiatingMessage->value.choice.RICsubscriptionRequest;
+            long ranFunctionId = -1;
+            for (int i = 0; i < request->protocolIEs.list.count; i++)
+              {
+                RICsubscriptionRequest_IEs_t *ie = request->protocolIEs.list.array[i];
+                if (ie->value.present == RICsubscriptionRequest_IEs__value_PR_RANfunctionID)
+                  {
+                    ranFunctionId = ie->value.choice.RANfunctionID;
+                  }
+              }
+
+            NS_LOG_DEBUG ("Received RIC Subscription Request for RAN Function " << ranFunctionId);
+            ReceiveFromRic (RicRequestInbox::SUBSCRIPTION, ranFunctionId, pdu, true);
+          }
+          return;
+
+          case InitiatingMessage__value_PR_RICsubscriptionDeleteRequest:
+            ReceiveFromRic (RicRequestInbox::SUBSCRIPTION_DELETE, -1, pdu, true);
+            return;
+
+          case InitiatingMessage__value_PR_RICcontrolRequest: {
+            RICcontrolRequest_t *request = &initiatingMessage->value.choice.RICcontrolRequest;
+            long ranFunctionId = -1;
+            for (int i = 0; i < request->protocolIEs.list.count; i++)
+              {
+                RICcontrolRequest_IEs_t *ie = request->protocolIEs.list.array[i];
+                if (ie->value.present == RICcontrolRequest_IEs__value_PR_RANfunctionID)
+                  {
+                    ranFunctionId = ie->value.choice.RANfunctionID;
+                  }
+              }
+
+            NS_LOG_DEBUG ("Received RIC Control Request for RAN Function " << ranFunctionId);
+            ReceiveFromRic (RicRequestInbox::CONTROL, ranFunctionId, pdu, true);
+          }
+          return;
+
+        default:
+          NS_LOG_DEBUG ("Ignoring initiating message with procedure code "
+                        << initiatingMessage->procedureCode);
+          break;
+        }
+    }
+  else if (pdu->present == E2AP_PDU_PR_successfulOutcome)
+    {
+      NS_LOG_INFO ("Received successful outcome with procedure code "
+                   << pdu->choice.successfulOutcome->procedureCode);
+    }
+  else if (pdu->present == E2AP_PDU_PR_unsuccessfulOutcome)
+    {
+      NS_LOG_WARN ("Received unsuccessful outcome with procedure code "
+                   << pdu->choice.unsuccessfulOutcome->procedureCode);
+    }
+
+  ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+}
+
+void
+E2Termination::ReceiveFromRic (RicRequestInbox::Kind kind, long ranFunctionId, E2AP_PDU_t* pdu,
+                               bool owned)
+{
+  if (!m_inbox)
+    {
+      DeliverFromRic (kind, ranFunctionId, pdu);
+      if (owned)
+        {
+          ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+        }
+      return;
+    }
+
+  if (!owned)
+    {
+      // e2sim releases its PDU when the callback returns, so the inbox gets
+      // a copy, encoded and decoded again
+      size_t size = m_inboxBuffer->Encode (&asn_DEF_E2AP_PDU, pdu);
+      pdu = nullptr;
+      asn_dec_rval_t rval = asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU,
+                                        (void **) &pdu, m_inboxBuffer->GetData (), size);
+      if (rval.code != RC_OK)
+        {
+          NS_LOG_ERROR ("Unable to copy the RIC request into the inbox");
+          ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+          return;
+        }
+    }
+
+  // the inbox takes ownership of the PDU, and frees it if it is dropped
+  m_inbox->Post (kind, ranFunctionId, pdu);
+}
+
+void
+E2Termination::DeliverFromRic (RicRequestInbox::Kind kind, long ranFunctionId, E2AP_PDU_t* pdu)
+{
+  if (kind == RicRequestInbox::SUBSCRIPTION_DELETE)
+    {
+      ProcessRicSubscriptionDeleteRequest (pdu);
+      return;
+    }
+
+  // the lock only covers the lookup, not the callback
+  SubscriptionCallback subscriptionCallback;
+  SmCallback controlCallback;
+  {
+    std::lock_guard<std::mutex> lock (m_callbacksMutex);
+    if (kind == RicRequestInbox::SUBSCRIPTION)
+      {
+        auto it = m_subscriptionCallbacks.find (ranFunctionId);
+        if (it != m_subscriptionCallbacks.end ())
+          {
+            subscriptionCallback = it->second;
+          }
+      }
+    else
+      {
+        auto it = m_smCallbacks.find (ranFunctionId);
+        if (it != m_smCallbacks.end ())
+          {
+            controlCallback = it->second;
+          }
+      }
+  }
+
+  if (kind == RicRequestInbox::SUBSCRIPTION)
+    {
+      if (subscriptionCallback)
+        {
+          subscriptionCallback (pdu);
+        }
+      else
+        {
+          NS_LOG_WARN ("No subscription callback for RAN Function " << ranFunctionId);
+        }
+    }
+  else
+    {
+      if (controlCallback)
+        {
+          controlCallback (pdu);
+          m_controlArena.Reset ();
+        }
+      else
+        {
+          NS_LOG_WARN ("No control callback for RAN Function " << ranFunctionId);
+        }
+    }
+}
+
+void
+E2Termination::CloseSocket ()
+{
+  if (m_socket < 0)
+    {
+      return;
+    }
+
+  m_reactor->Unregister (m_socket);
+  std::lock_guard<std::mutex> lock (m_transmitMutex);
+  close (m_socket);
+  m_socket = -1;
+}
+
+Ptr<EncodeBuffer>
+E2Termination::GetHeaderEncodeBuffer () const
+{
+  return m_headerEncodeBuffer;
+}
+
+Ptr<EncodeBuffer>
+E2Termination::GetMessageEncodeBuffer () const
+{
+  return m_messageEncodeBuffer;
 }
 
 }
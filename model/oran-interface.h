@@ -26,11 +26,30 @@
 #define ORAN_INTERFACE_H
 
 #include "ns3/object.h"
+#include <ns3/nstime.h>
 #include <ns3/kpm-indication.h>
 #include <ns3/kpm-function-description.h>
 #include <ns3/ric-control-function-description.h>
 #include <ns3/ric-control-message.h>
+#include <ns3/ric-control-dispatcher.h>
+#include <ns3/encode-buffer.h>
+#include <ns3/bounded-mpsc-queue.h>
+#include <ns3/ric-request-inbox.h>
+#include <ns3/e2-reactor.h>
+#include <ns3/e2ap-indication-envelope.h>
+#include <ns3/kpm-indication-batch.h>
+#include <ns3/kpm-encode-offload.h>
+#include <ns3/e2-pdu-recorder.h>
 #include "e2sim.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3 {
   
@@ -38,6 +57,36 @@ namespace ns3 {
   {
     public:
 
+      /**
+      * How the termination talks to the RIC
+      */
+      enum TransportMode
+      {
+        E2SIM = 0, //!< e2sim main loop, running on a dedicated thread per termination
+        REACTOR = 1 //!< own SCTP socket served by the event loop shared by all terminations
+      };
+
+      /**
+      * Behavior of QueueE2Message when the send queue is full
+      */
+      enum SendQueueFullPolicy
+      {
+        DROP = 0, //!< drop the message
+        BLOCK = 1 //!< wait until the sender thread frees a slot
+      };
+
+      /**
+      * Counters of the asynchronous send queue
+      */
+      struct SendQueueStats
+      {
+        uint64_t queued; //!< messages accepted in the queue
+        uint64_t sent; //!< messages sent by the sender thread
+        uint64_t dropped; //!< messages dropped because the queue was full
+        uint32_t occupancy; //!< messages currently in the queue
+        uint32_t highWater; //!< maximum occupancy observed
+      };
+
       E2Termination();
 
       /**
@@ -64,8 +113,10 @@ namespace ns3 {
       
       /**
       * Start the E2 termination.
-      * Create a separate thread to host the execution of e2sim. The thread will 
-      * execute the method DoStart.  
+      * With the E2SIM transport, create a separate thread to host the 
+      * execution of e2sim. The thread will execute the method DoStart.
+      * With the REACTOR transport, connect to the RIC, send the E2 Setup 
+      * Request and hand the socket to the shared E2Reactor.
       */
       void Start ();
       
@@ -93,6 +144,8 @@ namespace ns3 {
       * register a callback.
       * Whenever a Sm message to this RAN Function is received, 
       * the callback is triggered.  
+      * The callback runs on the network thread, or on the simulator thread
+      * if the DeliverOnSimulatorThread attribute is set.
       *
       * \param ranFunctionId ID used to identify the KPM RAN Function
       * \param ranFunctionDescription 
@@ -103,6 +156,28 @@ namespace ns3 {
                                      Ptr<FunctionDescription> ranFunctionDescription,
                                      SmCallback smCb);
 
+      /**
+      * Register an E2 Service Model whose RIC Control Messages are decoded
+      * by the termination and passed to the handlers of a dispatcher,
+      * instead of to a callback as in RegisterSmCallbackToE2Sm.
+      *
+      * \param ranFunctionId ID used to identify the RAN Function
+      * \param ranFunctionDescription the description of the RAN Function
+      * \param dispatcher the dispatcher of the RAN parameters
+      */
+      void RegisterControlDispatcher (long ranFunctionId,
+                                      Ptr<FunctionDescription> ranFunctionDescription,
+                                      Ptr<RicControlDispatcher> dispatcher);
+
+      /**
+      * Get the arena the RIC Control Messages can be decoded with, see
+      * RicControlMessage. The arena is reset whenever a control callback
+      * returns, so it can only be used within the control callbacks.
+      *
+      * \return the arena of the RIC Control Messages
+      */
+      RicControlDecodeArena& GetControlDecodeArena ();
+
       /**
       * Struct holding the values returned by ProcessRicSubscriptionRequest
       */
@@ -111,19 +186,239 @@ namespace ns3 {
         uint16_t requestorId; //!< RIC Requestor ID
         uint16_t instanceId; //!< RIC Instance ID
         uint16_t ranFuncionId; //!< RAN Function ID
-        uint8_t actionId; //!< RIC Action ID
+        uint8_t actionId; //!< RIC Action ID, of the first accepted action
+        bool accepted; //!< false if no action was accepted and a RIC Subscription Failure was sent
       }; 
 
       /**
       * Process RIC Subscription Request.
       * This function processes the RIC Subscription Request and sends the 
       * RIC Subscription Response.
+      * Every REPORT and INSERT action is accepted, the others are rejected.
+      * If at least one action is accepted the subscription is stored in the
+      * subscription table, replacing any previous subscription with the
+      * same RIC Request ID and RAN Function ID; otherwise a RIC
+      * Subscription Failure is sent instead of the response.
       *
       * \param sub_req_pdu request message
-      * \return RIC subscription request parameters
+      * \return RIC subscription request parameters, with the first
+      *         accepted action, or with accepted set to false if the
+      *         subscription was refused
       */
       RicSubscriptionRequest_rval_s ProcessRicSubscriptionRequest (E2AP_PDU_t* sub_req_pdu);
 
+      /**
+      * State of an action accepted in a RIC Subscription
+      */
+      struct RicAction
+      {
+        uint8_t actionId; //!< RIC Action ID
+        long actionType; //!< RIC Action Type, REPORT or INSERT
+        mutable std::atomic<uint32_t> indicationSn; //!< RIC Indication SN of the next report
+        mutable std::unique_ptr<E2apIndicationEnvelope> envelope; //!< cached E2AP encoding, REACTOR transport only
+      };
+
+      /**
+      * RIC Subscription accepted by the termination.
+      * The subscription is immutable once stored in the subscription table,
+      * except for the sequence numbers of its actions; a new subscription
+      * with the same key replaces it.
+      */
+      struct RicSubscription
+      {
+        uint16_t requestorId; //!< RIC Requestor ID
+        uint16_t instanceId; //!< RIC Instance ID
+        uint16_t ranFunctionId; //!< RAN Function ID
+        Time reportingPeriod; //!< reporting period of the event trigger, zero if none
+        std::vector<RicAction> actions; //!< accepted actions, in the order of the request
+
+        /**
+        * \param nActions the number of accepted actions
+        */
+        RicSubscription (size_t nActions) : actions (nActions)
+        {
+        }
+      };
+
+      /**
+      * Process RIC Subscription Delete Request.
+      * Remove the subscription from the subscription table, stop its
+      * periodic report, if any, and send the RIC Subscription Delete
+      * Response. With the REACTOR transport the requests are processed
+      * automatically, with the E2SIM transport this function must be
+      * called by the user.
+      *
+      * \param del_req_pdu request message
+      */
+      void ProcessRicSubscriptionDeleteRequest (E2AP_PDU_t* del_req_pdu);
+
+      /**
+      * Look up a subscription, in constant time
+      *
+      * \param requestorId RIC Requestor ID
+      * \param instanceId RIC Instance ID
+      * \param ranFunctionId RAN Function ID
+      * \return the subscription, or nullptr if there is none
+      */
+      std::shared_ptr<const RicSubscription> GetSubscription (uint16_t requestorId,
+                                                              uint16_t instanceId,
+                                                              uint16_t ranFunctionId) const;
+
+      /**
+      * \param ranFunctionId RAN Function ID
+      * \return the subscriptions to the RAN Function, in the order they
+      *         were received
+      */
+      std::vector<std::shared_ptr<const RicSubscription>> GetSubscriptions (long ranFunctionId) const;
+
+      /**
+      * \return the number of active subscriptions
+      */
+      size_t GetNSubscriptions () const;
+
+      /**
+      * Send a RIC Indication to every action of every subscription to a
+      * RAN Function.
+      * The E2SM header and message are encoded once by the caller and
+      * shared by all the indications, which only differ in the E2AP
+      * fields: RIC Request ID, RIC Action ID, RIC Indication SN and Type.
+      * The bytes are not copied when the messages are sent immediately,
+      * and are copied once, in a buffer shared by all the queued
+      * indications, when AsyncSend is enabled.
+      * With the REACTOR transport and AsyncSend disabled, the E2AP PDU is
+      * not built nor encoded by asn1c: the payload is spliced into an APER
+      * envelope cached per action, see E2apIndicationEnvelope.
+      *
+      * \param ranFunctionId ID of the RAN Function
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \return the number of indications sent or queued
+      */
+      uint32_t SendIndicationToSubscribers (long ranFunctionId, const uint8_t* header,
+                                            size_t headerSize, const uint8_t* message,
+                                            size_t messageSize);
+
+      /**
+      * Send a RIC Indication to every action of a single subscription,
+      * e.g., from a ReportCallback, so that each subscription is reported
+      * at its own period. The bytes are handled as in
+      * SendIndicationToSubscribers.
+      *
+      * \param subscription the subscription, as passed to the ReportCallback
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \return the number of indications sent or queued, zero if the
+      *         subscription does not exist anymore
+      */
+      uint32_t SendIndicationToSubscription (RicSubscriptionRequest_rval_s subscription,
+                                             const uint8_t* header, size_t headerSize,
+                                             const uint8_t* message, size_t messageSize);
+
+      /**
+      * Send a RIC Indication to every action of a single subscription, see
+      * the version taking the encoded bytes
+      *
+      * \param subscription the subscription, as passed to the ReportCallback
+      * \param header the E2SM Indication Header
+      * \param message the E2SM Indication Message
+      * \return the number of indications sent or queued
+      */
+      uint32_t SendIndicationToSubscription (RicSubscriptionRequest_rval_s subscription,
+                                             Ptr<KpmIndicationHeader> header,
+                                             Ptr<KpmIndicationMessage> message);
+
+      /**
+      * Send a RIC Indication to every action of every subscription to a
+      * RAN Function, see the version taking the encoded bytes
+      *
+      * \param ranFunctionId ID of the RAN Function
+      * \param header the E2SM Indication Header
+      * \param message the E2SM Indication Message
+      * \return the number of indications sent or queued
+      */
+      uint32_t SendIndicationToSubscribers (long ranFunctionId, Ptr<KpmIndicationHeader> header,
+                                            Ptr<KpmIndicationMessage> message);
+
+      /**
+      * Send the RIC Indications of the cells of a multi-cell node to every
+      * subscription to a RAN Function.
+      * With the REACTOR transport and AsyncSend disabled, all the
+      * indications are encoded first and then written to the socket with
+      * a single vectored write; otherwise the cells are sent one by one
+      * as in SendIndicationToSubscribers.
+      *
+      * \param ranFunctionId ID of the RAN Function
+      * \param headers the E2SM Indication Header of each cell, each owning
+      *        its encoding, i.e., not created with a shared EncodeBuffer
+      * \param messages the E2SM Indication Message of each cell
+      * \return the number of indications sent or queued
+      */
+      uint32_t SendIndicationsToSubscribers (long ranFunctionId,
+                                             const std::vector<Ptr<KpmIndicationHeader>>& headers,
+                                             Ptr<KpmIndicationMessageBatch> messages);
+
+      /**
+      * Encode a RIC Indication Message from its values and send it to
+      * every subscription to a RAN Function.
+      * If EncodeThreads is not zero the values are handed over to the
+      * encoding threads, which encode and send the messages in the order
+      * of the calls; otherwise the message is encoded on the calling thread.
+      * The termination takes ownership of the objects of the values, e.g.,
+      * with IndicationMessageHelper::TakeMessageValues, and the caller must
+      * not keep references to them.
+      *
+      * \param ranFunctionId ID of the RAN Function
+      * \param header the E2SM Indication Header
+      * \param values the values of the E2SM Indication Message
+      */
+      void EncodeAndSendIndication (long ranFunctionId, Ptr<KpmIndicationHeader> header,
+                                    KpmIndicationMessage::KpmIndicationMessageValues &&values);
+
+      /**
+      * Wait until every message passed to EncodeAndSendIndication is sent
+      */
+      void FlushIndications ();
+
+      /**
+      * Move out the values of the messages sent by the encoding threads
+      * since the previous call, e.g., to give their measurement lists back
+      * to IndicationMessageHelper::RecycleMessageValues. The encoding
+      * threads hold no reference to the values anymore.
+      *
+      * \param values filled with the values of the sent messages
+      */
+      void CollectSentIndicationValues (
+          std::vector<KpmIndicationMessage::KpmIndicationMessageValues> &values);
+
+      /**
+      * Callback building and sending a report of a subscription, e.g.,
+      * a RIC Indication carrying the current KPM values. The report must
+      * be sent with SendIndicationToSubscription, since the other
+      * subscriptions to the RAN Function have their own schedules.
+      */
+      typedef Callback<void, RicSubscriptionRequest_rval_s> ReportCallback;
+
+      /**
+      * Register a report builder for a RAN Function.
+      * Whenever ProcessRicSubscriptionRequest accepts a subscription to
+      * this RAN Function whose E2SM-KPM Event Trigger Definition carries a
+      * reporting period, the callback is invoked on the simulator thread
+      * every period, in simulation time, starting one period after the
+      * subscription, with the subscription it reports for. A new
+      * subscription with the same RIC Request ID restarts the schedule
+      * with the new period.
+      * Subscriptions without a valid reporting period are left to the
+      * subscription callback, as before.
+      *
+      * \param ranFunctionId ID of the RAN Function
+      * \param reportCb the report builder
+      */
+      void RegisterReportCallback (long ranFunctionId, ReportCallback reportCb);
+
       /**
       * Sends an E2 message to the RIC
       * This function encodes and sends an E2 message to the RIC
@@ -132,7 +427,236 @@ namespace ns3 {
       */
       void SendE2Message (E2AP_PDU* pdu);   
 
+      /**
+      * Sends an E2 message to the RIC without blocking the caller.
+      * If the AsyncSend attribute is true, the message is appended to the
+      * send queue and encoded and sent by a dedicated thread, otherwise it
+      * is sent immediately as in SendE2Message.
+      * In both cases the termination takes ownership of the PDU, which must
+      * be allocated with calloc and is released with ASN_STRUCT_FREE once
+      * sent or dropped.
+      *
+      * \param pdu the PDU of the message
+      */
+      void QueueE2Message (E2AP_PDU* pdu);
+
+      /**
+      * \return the counters of the asynchronous send queue
+      */
+      SendQueueStats GetSendQueueStats () const;
+
+      /**
+      * Append every outbound E2AP PDU sent afterwards, with the simulation
+      * time at which it was submitted, to a file that E2PduReplayer can
+      * replay. The E2 Setup Request and the responses to the RIC
+      * Subscription requests are not recorded, since they answer the RIC
+      * the termination is connected to, and neither are the PDUs sent by
+      * SendEncoded, so that a replay does not record itself. The PDUs are
+      * recorded even if the termination is not connected to a RIC, e.g.,
+      * to record a run offline.
+      * Can be called while messages are being sent: the recorder is
+      * swapped under the mutex serializing the transmissions.
+      *
+      * \param fileName the name of the file, replaced if it exists
+      */
+      void EnablePduRecording (const std::string &fileName);
+
+      /**
+      * Stop recording the outbound E2AP PDUs and close the file.
+      * Can be called while messages are being sent, see EnablePduRecording.
+      */
+      void DisablePduRecording ();
+
+      /**
+      * Send an already encoded E2AP PDU, e.g., one replayed from a record
+      * file. The PDU is written as it is, without allocating, with the
+      * REACTOR transport. With the E2SIM transport it is decoded and
+      * encoded again by e2sim, which allocates the decoded PDU and is not
+      * guaranteed to reproduce the same bytes.
+      *
+      * \param buffer the encoded PDU
+      * \param size the size of the encoded PDU
+      */
+      void SendEncoded (const uint8_t* buffer, size_t size);
+
+      /**
+      * Get the scratch buffer used to encode the RIC Indication Headers
+      * sent through this termination.
+      * The buffer is reused across reports, so its content is only valid
+      * until the next header is encoded into it.
+      *
+      * \return the header encode buffer
+      */
+      Ptr<EncodeBuffer> GetHeaderEncodeBuffer () const;
+
+      /**
+      * Get the scratch buffer used to encode the RIC Indication Messages
+      * sent through this termination.
+      * The buffer is reused across reports, so its content is only valid
+      * until the next message is encoded into it.
+      *
+      * \return the message encode buffer
+      */
+      Ptr<EncodeBuffer> GetMessageEncodeBuffer () const;
+
     private:
+      /**
+      * Implementation of SendIndicationToSubscribers, which may run on the
+      * encoding threads
+      *
+      * \param timestamp the simulation time at which the indication was
+      *        submitted, read on the simulator thread
+      * \param ranFunctionId ID of the RAN Function
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \return the number of indications sent or queued
+      */
+      uint32_t DoSendIndicationToSubscribers (Time timestamp, long ranFunctionId,
+                                              const uint8_t* header, size_t headerSize,
+                                              const uint8_t* message, size_t messageSize);
+
+      /**
+      * Send a RIC Indication to every action of the given subscriptions
+      *
+      * \param timestamp the simulation time at which the indication was
+      *        submitted, read on the simulator thread
+      * \param subscriptions the subscriptions
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \return the number of indications sent or queued
+      */
+      uint32_t DoSendIndication (Time timestamp,
+                                 const std::vector<std::shared_ptr<const RicSubscription>>& subscriptions,
+                                 const uint8_t* header, size_t headerSize,
+                                 const uint8_t* message, size_t messageSize);
+
+      /**
+      * Send a RIC Subscription Failure, listing the actions not admitted
+      *
+      * \param requestorId RIC Requestor ID
+      * \param instanceId RIC Instance ID
+      * \param ranFunctionId RAN Function ID
+      * \param actionIdsReject the IDs of the actions not admitted
+      */
+      void SendRicSubscriptionFailure (uint16_t requestorId, uint16_t instanceId,
+                                       uint16_t ranFunctionId,
+                                       const std::vector<long> &actionIdsReject);
+
+      /**
+      * Copy of the encoded E2SM header and message of a RIC Indication,
+      * shared by the queued indications sent to different subscribers
+      */
+      struct IndicationPayload
+      {
+        std::vector<uint8_t> header; //!< the encoded E2SM Indication Header
+        std::vector<uint8_t> message; //!< the encoded E2SM Indication Message
+      };
+
+      /**
+      * Element of the send queue
+      */
+      struct QueuedPdu
+      {
+        E2AP_PDU* pdu; //!< the message, owned by the queue
+        Time timestamp; //!< simulation time of the submission, recorded with the message
+        std::shared_ptr<const IndicationPayload> payload; //!< payload referenced by pdu, if any
+      };
+
+      /**
+      * Append a message to the send queue, applying the SendQueueFullPolicy
+      *
+      * \param queued the message
+      */
+      void Enqueue (QueuedPdu queued);
+
+      /**
+      * Release a message taken from, or refused by, the send queue
+      *
+      * \param queued the message
+      */
+      static void ReleaseQueuedPdu (QueuedPdu& queued);
+
+      /**
+      * Create a RIC Indication whose header and message reference the given
+      * bytes, which are not copied. The PDU must be released with
+      * DetachIndicationPayload followed by ASN_STRUCT_FREE.
+      *
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \return the PDU
+      */
+      static E2AP_PDU* CreateIndicationPdu (const uint8_t* header, size_t headerSize,
+                                            const uint8_t* message, size_t messageSize);
+
+      /**
+      * Replace the payload referenced by a RIC Indication built by
+      * CreateIndicationPdu
+      *
+      * \param pdu the PDU
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      */
+      static void SetIndicationPayload (E2AP_PDU* pdu, const uint8_t* header, size_t headerSize,
+                                        const uint8_t* message, size_t messageSize);
+
+      /**
+      * Encode a RIC Indication for an action, with the cached envelope of
+      * the action if possible. Must be called holding m_transmitMutex.
+      *
+      * \param pdu a PDU built by CreateIndicationPdu, referencing the payload
+      * \param subscription the subscription
+      * \param action the action of the subscription
+      * \param sn the RIC Indication SN
+      * \param header the encoded E2SM Indication Header
+      * \param headerSize the size of the header
+      * \param message the encoded E2SM Indication Message
+      * \param messageSize the size of the message
+      * \param buffer the destination buffer
+      */
+      void EncodeIndication (E2AP_PDU* pdu, const RicSubscription& subscription,
+                             const RicAction& action, uint16_t sn, const uint8_t* header, size_t headerSize,
+                             const uint8_t* message, size_t messageSize,
+                             Ptr<EncodeBuffer> buffer);
+
+      /**
+      * Send several encoded E2AP PDUs on the socket of the REACTOR
+      * transport with a single vectored write. Must be called holding
+      * m_transmitMutex.
+      *
+      * \param buffers the encoded PDUs
+      * \param n the number of PDUs to send, from the first buffer
+      * \param timestamp the simulation time at which the PDUs were submitted
+      */
+      void TransmitEncodedBatch (const std::vector<Ptr<EncodeBuffer>>& buffers, size_t n,
+                                 Time timestamp);
+
+      /**
+      * Set the E2AP fields of a RIC Indication built by CreateIndicationPdu
+      *
+      * \param pdu the PDU
+      * \param subscription the subscription
+      * \param action the action of the subscription
+      * \param sn the RIC Indication SN
+      */
+      static void SetIndicationIds (E2AP_PDU* pdu, const RicSubscription& subscription,
+                                    const RicAction& action, uint16_t sn);
+
+      /**
+      * Clear the references to the payload of a RIC Indication built by
+      * CreateIndicationPdu, so that it can be released with ASN_STRUCT_FREE
+      *
+      * \param pdu the PDU
+      */
+      static void DetachIndicationPayload (E2AP_PDU* pdu);
+
       /**
       * Run the e2sim main loop.
       * Starts the e2sim main loop, it will open a socket towards the RIC and 
@@ -140,6 +664,178 @@ namespace ns3 {
       */
       void DoStart ();
 
+      /**
+      * Main loop of the sender thread.
+      * Drains the send queue until the termination is destroyed, parking
+      * on a condition variable while the queue is empty.
+      */
+      void DoSend ();
+
+      /**
+      * Stop the sender thread, after all the queued messages are sent
+      */
+      void StopSender ();
+
+      /**
+      * Open the SCTP association with the RIC, register the socket to the
+      * reactor and send the E2 Setup Request
+      */
+      void DoStartReactor ();
+
+      /**
+      * Encode and send a PDU with the configured transport
+      *
+      * \param pdu the PDU of the message
+      * \param timestamp the simulation time at which the PDU was submitted,
+      *        read on the simulator thread
+      * \param record if false the PDU is not recorded, see EnablePduRecording
+      */
+      void Transmit (E2AP_PDU* pdu, Time timestamp, bool record = true);
+
+      /**
+      * Send an already encoded E2AP PDU on the socket of the REACTOR
+      * transport. Must be called holding m_transmitMutex.
+      *
+      * \param buffer the encoded PDU
+      * \param size the size of the encoded PDU
+      * \param timestamp the simulation time at which the PDU was submitted,
+      *        read on the simulator thread
+      * \param record if false the PDU is not recorded, see EnablePduRecording
+      */
+      void TransmitEncoded (const uint8_t* buffer, size_t size, Time timestamp,
+                            bool record = true);
+
+      /**
+      * Read from the socket, invoked by the reactor when it is readable,
+      * or close it if the association failed or was shut down
+      *
+      * \param events the epoll event mask
+      */
+      void HandleSocketEvent (uint32_t events);
+
+      /**
+      * Decode an E2AP PDU received from the RIC and dispatch it to the
+      * registered callbacks
+      *
+      * \param buffer the encoded PDU
+      * \param size the size of the encoded PDU
+      */
+      void HandleE2Message (const uint8_t* buffer, size_t size);
+
+      /**
+      * Close the socket of the REACTOR transport
+      */
+      void CloseSocket ();
+
+      /**
+      * \param requestorId RIC Requestor ID
+      * \param instanceId RIC Instance ID
+      * \param ranFunctionId RAN Function ID
+      * \return the key of the subscription table
+      */
+      static uint64_t GetSubscriptionKey (uint16_t requestorId, uint16_t instanceId,
+                                          uint16_t ranFunctionId);
+
+      /**
+      * Add a subscription to the subscription table, replacing the one with
+      * the same key, if any
+      *
+      * \param subscription the subscription
+      */
+      void AddSubscription (std::shared_ptr<const RicSubscription> subscription);
+
+      /**
+      * Remove a subscription from the subscription table
+      *
+      * \param requestorId RIC Requestor ID
+      * \param instanceId RIC Instance ID
+      * \param ranFunctionId RAN Function ID
+      * \return true if the subscription was found
+      */
+      bool RemoveSubscription (uint16_t requestorId, uint16_t instanceId, uint16_t ranFunctionId);
+
+      /**
+      * Key of the report schedules: RIC Requestor ID, RIC Instance ID and
+      * RAN Function ID
+      */
+      typedef std::tuple<uint16_t, uint16_t, uint16_t> ReportScheduleKey;
+
+      /**
+      * Periodic report of a subscription
+      */
+      struct ReportSchedule
+      {
+        RicSubscriptionRequest_rval_s m_params; //!< the subscription
+        Time m_period; //!< the reporting period
+        ReportCallback m_callback; //!< the report builder
+        uint64_t m_generation; //!< identifies the events of this schedule
+      };
+
+      /**
+      * Start, or restart, the periodic report of a subscription.
+      * Can be called from any thread.
+      *
+      * \param params the subscription
+      * \param period the reporting period
+      * \param reportCb the report builder
+      */
+      void StartReportSchedule (RicSubscriptionRequest_rval_s params, Time period,
+                                ReportCallback reportCb);
+
+      /**
+      * Stop the periodic report of a subscription, if any.
+      * Can be called from any thread: the pending report event is not
+      * cancelled, which is only safe on the simulator thread, but finds
+      * the schedule gone and does nothing.
+      *
+      * \param params the subscription
+      */
+      void StopReportSchedule (RicSubscriptionRequest_rval_s params);
+
+      /**
+      * Invoke the report builder of a subscription and schedule the next
+      * report. Runs on the simulator thread.
+      *
+      * \param key the subscription
+      * \param generation the schedule that created the event; the event
+      *        is ignored if the schedule was stopped or restarted since
+      */
+      void FireReport (ReportScheduleKey key, uint64_t generation);
+
+      /**
+      * Body of the report events: the first report is scheduled with
+      * ScheduleWithContext, which cannot be cancelled, so the events reach
+      * the termination through a token that is reset on destruction.
+      *
+      * \param lifetime the token of the termination
+      * \param key the subscription
+      * \param generation the schedule that created the event
+      */
+      static void FireReportIfAlive (std::weak_ptr<E2Termination *> lifetime,
+                                     ReportScheduleKey key, uint64_t generation);
+
+      /**
+      * Handle a request received from the RIC on the network thread: run
+      * its callback right away, or post it to the inbox if
+      * DeliverOnSimulatorThread is set.
+      *
+      * \param kind the kind of the request
+      * \param ranFunctionId the RAN function of the request
+      * \param pdu the request
+      * \param owned if true the termination takes ownership of the PDU,
+      *        otherwise the PDU is copied if needed
+      */
+      void ReceiveFromRic (RicRequestInbox::Kind kind, long ranFunctionId, E2AP_PDU_t* pdu, bool owned);
+
+      /**
+      * Run the callback registered for a request received from the RIC
+      *
+      * \param kind the kind of the request
+      * \param ranFunctionId the RAN function of the request
+      * \param pdu the request
+      */
+      void DeliverFromRic (RicRequestInbox::Kind kind, long ranFunctionId, E2AP_PDU_t* pdu);
+
       /**
        * \brief Accessory function to populate to the registration of the ran function description to e2sim
        * 
@@ -155,6 +851,57 @@ namespace ns3 {
       uint16_t m_clientPort; //!< local bind port
       std::string m_gnbId; //!< GNB id
       std::string m_plmnId; //!< PLMN Id
+      Ptr<EncodeBuffer> m_headerEncodeBuffer; //!< scratch buffer for the indication headers
+      Ptr<EncodeBuffer> m_messageEncodeBuffer; //!< scratch buffer for the indication messages
+
+      bool m_asyncSend; //!< if true, QueueE2Message hands the messages to the sender thread
+      uint32_t m_sendQueueDepth; //!< capacity of the send queue
+      SendQueueFullPolicy m_sendQueueFullPolicy; //!< behavior when the send queue is full
+      std::unique_ptr<BoundedMpscQueue<QueuedPdu>> m_sendQueue; //!< queue drained by the sender thread
+      std::thread m_senderThread; //!< thread sending the queued messages
+      std::atomic<bool> m_senderRunning; //!< false when the sender thread must exit
+      std::atomic<bool> m_senderParked; //!< true while the sender thread waits for messages
+      std::mutex m_senderMutex; //!< mutex used for parking the sender thread and blocked producers
+      std::condition_variable m_senderCv; //!< signaled when a message is queued
+      std::condition_variable m_spaceCv; //!< signaled when a slot of the queue is freed
+      std::atomic<uint32_t> m_blockedProducers; //!< producers waiting for a free slot
+      std::atomic<uint64_t> m_queuedMessages; //!< messages accepted in the queue
+      std::atomic<uint64_t> m_sentMessages; //!< messages sent by the sender thread
+      std::atomic<uint64_t> m_droppedMessages; //!< messages dropped because the queue was full
+      std::atomic<uint32_t> m_sendQueueHighWater; //!< maximum occupancy of the queue
+
+      TransportMode m_transportMode; //!< how the termination talks to the RIC
+      Ptr<E2Reactor> m_reactor; //!< event loop serving the socket, REACTOR transport only
+      int m_socket; //!< SCTP socket, REACTOR transport only
+      std::vector<uint8_t> m_receiveBuffer; //!< reassembly buffer of the inbound messages
+      size_t m_receivedBytes; //!< bytes of the current inbound message
+      std::mutex m_transmitMutex; //!< serializes the encodings and the writes on the socket
+      Ptr<EncodeBuffer> m_transmitBuffer; //!< scratch buffer for the outbound E2AP PDUs
+      std::vector<Ptr<EncodeBuffer>> m_batchBuffers; //!< scratch buffers for the vectored writes
+      uint32_t m_encodeThreads; //!< threads encoding the messages of EncodeAndSendIndication
+      uint32_t m_encodeQueueDepth; //!< messages waiting to be encoded or sent
+      std::unique_ptr<KpmEncodeOffload> m_encodeOffload; //!< encoding threads, if enabled
+      std::unique_ptr<E2PduRecorder> m_pduRecorder; //!< recorder of the outbound PDUs, if any, under m_transmitMutex
+      bool m_deliverOnSimulatorThread; //!< run the callbacks of the RIC requests on the simulator thread
+      uint32_t m_inboxDepth; //!< RIC requests waiting for the simulator thread
+      Time m_inboxTimeout; //!< longest wait of the network thread for a free slot of the inbox
+      std::shared_ptr<RicRequestInbox> m_inbox; //!< RIC requests waiting for the simulator thread, if enabled
+      Ptr<EncodeBuffer> m_inboxBuffer; //!< copies the PDUs owned by e2sim into the inbox
+      std::mutex m_callbacksMutex; //!< protects the registered RAN functions and callbacks
+      std::map<long, OCTET_STRING_t*> m_ranFunctionDescriptions; //!< registered RAN functions
+      std::map<long, SubscriptionCallback> m_subscriptionCallbacks; //!< subscription callbacks per RAN function
+      std::map<long, SmCallback> m_smCallbacks; //!< control callbacks per RAN function
+      RicControlDecodeArena m_controlArena; //!< storage of the RIC Control Messages decoded in the callbacks
+      std::map<long, ReportCallback> m_reportCallbacks; //!< report builders per RAN function
+      mutable std::mutex m_subscriptionsMutex; //!< protects the subscription table
+      std::unordered_map<uint64_t, std::shared_ptr<const RicSubscription>>
+          m_subscriptions; //!< subscriptions, indexed by GetSubscriptionKey
+      std::unordered_map<long, std::vector<std::shared_ptr<const RicSubscription>>>
+          m_subscriptionsPerFunction; //!< subscriptions, indexed by RAN function
+      std::mutex m_reportSchedulesMutex; //!< protects the report schedules
+      std::map<ReportScheduleKey, ReportSchedule> m_reportSchedules; //!< active periodic reports
+      uint64_t m_reportGeneration; //!< generation of the last report schedule started
+      std::shared_ptr<E2Termination *> m_reportLifetime; //!< token of the report events, reset on destruction
   };
 }
 
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef ORDERED_PTR_VECTOR_H
+#define ORDERED_PTR_VECTOR_H
+
+#include "ns3/ptr.h"
+#include <algorithm>
+#include <vector>
+
+namespace ns3 {
+
+  /**
+  * Contiguous container of Ptr kept sorted by a key of the objects, e.g.,
+  * the IMSI of a UE, so that iterating it is cache friendly and the order
+  * does not depend on the addresses of the objects.
+  *
+  * Objects with equal keys are kept in insertion order. Inserting in key
+  * order, the common case, appends without moving any element. The key of
+  * an object must be set before inserting it and must not change while the
+  * object is in the container.
+  *
+  * \tparam T the type of the objects
+  * \tparam Less the ordering, a functor comparing two const T &
+  */
+  template<class T, class Less>
+  class OrderedPtrVector
+  {
+  public:
+    typedef Ptr<T> value_type;
+    typedef typename std::vector<Ptr<T>>::const_iterator const_iterator;
+
+    /**
+    * Insert an object in key order
+    *
+    * \param item the object
+    */
+    void
+    insert (const Ptr<T> &item)
+    {
+      Less less;
+      if (m_items.empty () || !less (*item, *m_items.back ()))
+        {
+          m_items.push_back (item);
+          return;
+        }
+      auto position = std::upper_bound (
+          m_items.begin (), m_items.end (), item,
+          [&less] (const Ptr<T> &a, const Ptr<T> &b) { return less (*a, *b); });
+      m_items.insert (position, item);
+    }
+
+    /**
+    * \param n the number of objects to reserve space for
+    */
+    void
+    reserve (size_t n)
+    {
+      m_items.reserve (n);
+    }
+
+    /**
+    * Remove all the objects, keeping the capacity
+    */
+    void
+    clear ()
+    {
+      m_items.clear ();
+    }
+
+    size_t
+    size () const
+    {
+      return m_items.size ();
+    }
+
+    bool
+    empty () const
+    {
+      return m_items.empty ();
+    }
+
+    const_iterator
+    begin () const
+    {
+      return m_items.begin ();
+    }
+
+    const_iterator
+    end () const
+    {
+      return m_items.end ();
+    }
+
+  private:
+    std::vector<Ptr<T>> m_items; //!< the objects, in key order
+  };
+
+} // namespace ns3
+
+#endif /* ORDERED_PTR_VECTOR_H */
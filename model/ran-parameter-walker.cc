@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/ran-parameter-walker.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RanParameterWalker");
+
+RanParameterWalker::RanParameterWalker ()
+{
+}
+
+void
+RanParameterWalker::Walk (const RANParameter_Item_t *ranParameterItem, const Visitor &visitor)
+{
+  RANParameter_Item_t *const items[] = {const_cast<RANParameter_Item_t *> (ranParameterItem)};
+  WalkItems (items, 1, visitor);
+}
+
+void
+RanParameterWalker::Walk (const E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1,
+                          const Visitor &visitor)
+{
+  if (!e2SmRcControlMessageFormat1->ranParameters_List)
+    {
+      return;
+    }
+  WalkItems (e2SmRcControlMessageFormat1->ranParameters_List->list.array,
+             e2SmRcControlMessageFormat1->ranParameters_List->list.count, visitor);
+}
+
+void
+RanParameterWalker::WalkItems (RANParameter_Item_t *const *items, int count, const Visitor &visitor)
+{
+  m_stack.clear ();
+  m_path.clear ();
+  m_stack.push_back ({items, nullptr, count, 0, -1, false});
+
+  while (!m_stack.empty ())
+    {
+      // pushing a child invalidates the reference, so the frame is not used
+      // after a push
+      Frame &frame = m_stack.back ();
+      if (frame.m_next == frame.m_count)
+        {
+          if (frame.m_popPath)
+            {
+              m_path.pop_back ();
+            }
+          m_stack.pop_back ();
+          continue;
+        }
+
+      int index = frame.m_next++;
+      if (frame.m_entries)
+        {
+          // an entry of a list, i.e., a structure without its own ID
+          const RANParameter_STRUCTURE_t *entry = frame.m_entries[index];
+          if (entry)
+            {
+              m_stack.push_back ({entry->sequence_of_ranParameters.list.array, nullptr,
+                                  entry->sequence_of_ranParameters.list.count, 0, index, false});
+            }
+          continue;
+        }
+
+      const RANParameter_Item_t *ranParameterItem = frame.m_items[index];
+      if (!ranParameterItem || !ranParameterItem->ranParameterItem_valueType)
+        {
+          continue;
+        }
+      m_path.push_back ({ranParameterItem->ranParameterItem_ID, frame.m_listIndex});
+
+      const RANParameter_ValueType_t *valueType = ranParameterItem->ranParameterItem_valueType;
+      switch (valueType->present)
+        {
+          case RANParameter_ValueType_PR_ranParameter_Element: {
+            const RANParameter_Value_t &value = valueType->choice.ranParameter_Element->ranParameter_Value;
+            RanParameterView view = {ranParameterItem->ranParameterItem_ID,
+                                     RANParameterItem::ValueType::Nothing, 0, nullptr, 0,
+                                     ranParameterItem};
+            if (value.present == RANParameter_Value_PR_valueInt)
+              {
+                view.m_valueType = RANParameterItem::ValueType::Int;
+                view.m_valueInt = value.choice.valueInt;
+              }
+            else if (value.present == RANParameter_Value_PR_valueOctS)
+              {
+                view.m_valueType = RANParameterItem::ValueType::OctectString;
+                view.m_valueBuf = value.choice.valueOctS.buf;
+                view.m_valueSize = value.choice.valueOctS.size;
+              }
+            visitor (m_path, view);
+            m_path.pop_back ();
+            break;
+          }
+          case RANParameter_ValueType_PR_ranParameter_Structure: {
+            const RANParameter_STRUCTURE_t *structure = valueType->choice.ranParameter_Structure;
+            m_stack.push_back ({structure->sequence_of_ranParameters.list.array, nullptr,
+                                structure->sequence_of_ranParameters.list.count, 0, -1, true});
+            break;
+          }
+          case RANParameter_ValueType_PR_ranParameter_List: {
+            const RANParameter_LIST_t *list = valueType->choice.ranParameter_List;
+            m_stack.push_back ({nullptr, list->list_of_ranParameter.list.array,
+                                list->list_of_ranParameter.list.count, 0, -1, true});
+            break;
+          }
+          default:
+            NS_LOG_DEBUG ("[E2SM] RANParameter_ValueType_PR_NOTHING");
+            m_path.pop_back ();
+            break;
+        }
+    }
+}
+
+} // namespace ns3
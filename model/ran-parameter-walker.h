@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef RAN_PARAMETER_WALKER_H
+#define RAN_PARAMETER_WALKER_H
+
+#include "ns3/object.h"
+#include <ns3/asn1c-types.h>
+#include <functional>
+#include <vector>
+
+extern "C" {
+  #include "E2SM-RC-ControlMessage-Format1.h"
+  #include "RANParameter-LIST.h"
+ }
+
+namespace ns3 {
+
+  /**
+  * Non-owning view of a RAN parameter value of a RIC Control Message. It
+  * points into the decoded message and is valid as long as the message.
+  */
+  struct RanParameterView
+  {
+    long m_id; //!< the RAN parameter ID
+    RANParameterItem::ValueType m_valueType; //!< the type of the value
+    long m_valueInt; //!< the value, if m_valueType is Int
+    const uint8_t *m_valueBuf; //!< the octets of the value, if m_valueType is OctectString
+    size_t m_valueSize; //!< the number of octets of the value
+    const RANParameter_Item_t *m_item; //!< the parameter in the decoded message
+  };
+
+  /**
+  * Element of the path from a top-level RAN parameter down to a value
+  */
+  struct RanParameterPathElement
+  {
+    long m_id; //!< the RAN parameter ID
+    int32_t m_listIndex; //!< the entry of the enclosing RAN parameter list, or -1
+  };
+
+  /**
+  * Walks the RAN parameter trees of a RIC Control Message, i.e., elements,
+  * structures and lists, and streams every value with the path of IDs that
+  * leads to it. The walk is iterative with an explicit stack, so deep
+  * trees are visited in one linear pass without recursion or copies, and
+  * the stack keeps its capacity across walks.
+  */
+  class RanParameterWalker
+  {
+  public:
+    /**
+    * Called for every value. The path is valid during the call only, and
+    * its last element is the parameter holding the value.
+    */
+    typedef std::function<void (const std::vector<RanParameterPathElement> &path,
+                                const RanParameterView &value)> Visitor;
+
+    RanParameterWalker ();
+
+    /**
+    * Visit the values of a RAN parameter and of its children
+    *
+    * \param ranParameterItem the RAN parameter
+    * \param visitor the visitor
+    */
+    void Walk (const RANParameter_Item_t *ranParameterItem, const Visitor &visitor);
+
+    /**
+    * Visit the values of all the RAN parameters of a control message
+    *
+    * \param e2SmRcControlMessageFormat1 the control message
+    * \param visitor the visitor
+    */
+    void Walk (const E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1,
+               const Visitor &visitor);
+
+  private:
+    /**
+    * Visit the values of a sequence of RAN parameters
+    *
+    * \param items the RAN parameters
+    * \param count the number of RAN parameters
+    * \param visitor the visitor
+    */
+    void WalkItems (RANParameter_Item_t *const *items, int count, const Visitor &visitor);
+
+    /**
+    * Parameters still to be visited at one level of the tree, either the
+    * items of a structure or the entries of a list
+    */
+    struct Frame
+    {
+      RANParameter_Item_t *const *m_items; //!< the items of a structure, or nullptr
+      RANParameter_STRUCTURE_t *const *m_entries; //!< the entries of a list, or nullptr
+      int m_count; //!< the number of items or entries
+      int m_next; //!< the next item or entry to visit
+      int32_t m_listIndex; //!< the list entry the items belong to, or -1
+      bool m_popPath; //!< the frame pushed an element of the path
+    };
+
+    std::vector<Frame> m_stack; //!< the levels being visited
+    std::vector<RanParameterPathElement> m_path; //!< the path to the current level
+  };
+
+} // namespace ns3
+
+#endif /* RAN_PARAMETER_WALKER_H */
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/ric-control-dispatcher.h>
+#include <ns3/log.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RicControlDispatcher");
+
+bool
+RicControlDispatcher::Key::operator== (const Key &other) const
+{
+  return m_ranFunctionId == other.m_ranFunctionId && m_styleType == other.m_styleType
+         && m_actionId == other.m_actionId && m_ranParameterId == other.m_ranParameterId;
+}
+
+size_t
+RicControlDispatcher::KeyHash::operator() (const Key &key) const
+{
+  uint64_t hash = key.m_ranFunctionId;
+  hash = hash * 0x9e3779b97f4a7c15ULL + key.m_styleType;
+  hash = hash * 0x9e3779b97f4a7c15ULL + key.m_actionId;
+  hash = hash * 0x9e3779b97f4a7c15ULL + key.m_ranParameterId;
+  return hash ^ (hash >> 32);
+}
+
+RicControlDispatcher::RicControlDispatcher ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RicControlDispatcher::~RicControlDispatcher ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RicControlDispatcher::RegisterIntegerHandler (long ranFunctionId, long styleType, long actionId,
+                                              long ranParameterId, IntegerHandler handler)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId << styleType << actionId << ranParameterId);
+  Handler &entry = m_handlers[{ranFunctionId, styleType, actionId, ranParameterId}];
+  entry = Handler ();
+  entry.m_integer = handler;
+}
+
+void
+RicControlDispatcher::RegisterNrCgiHandler (long ranFunctionId, long styleType, long actionId,
+                                            long ranParameterId, NrCgiHandler handler,
+                                            NrCgiEncoding encoding)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId << styleType << actionId << ranParameterId << encoding);
+  Handler &entry = m_handlers[{ranFunctionId, styleType, actionId, ranParameterId}];
+  entry = Handler ();
+  entry.m_nrCgi = handler;
+  entry.m_nrCgiEncoding = encoding;
+}
+
+void
+RicControlDispatcher::RegisterOctetStringHandler (long ranFunctionId, long styleType,
+                                                  long actionId, long ranParameterId,
+                                                  OctetStringHandler handler)
+{
+  NS_LOG_FUNCTION (this << ranFunctionId << styleType << actionId << ranParameterId);
+  Handler &entry = m_handlers[{ranFunctionId, styleType, actionId, ranParameterId}];
+  entry = Handler ();
+  entry.m_octetString = handler;
+}
+
+uint32_t
+RicControlDispatcher::Dispatch (const RicControlMessage &message) const
+{
+  const E2SM_RC_ControlHeader_Format1_t *header = message.m_e2SmRcControlHeaderFormat1;
+  if (!header)
+    {
+      NS_LOG_WARN ("RIC Control Message without a format 1 header, not dispatched");
+      return 0;
+    }
+
+  RicControlAction action = {message.m_ranFunctionId, header->ric_ControlStyle_Type,
+                             header->ric_ControlAction_ID, header->ueId.buf,
+                             (size_t) header->ueId.size, &message};
+  Key key = {action.m_ranFunctionId, action.m_styleType, action.m_actionId, 0};
+
+  uint32_t handled = 0;
+  for (const RanParameterView &parameter : message.GetRanParameters ())
+    {
+      key.m_ranParameterId = parameter.m_id;
+      auto it = m_handlers.find (key);
+      if (it == m_handlers.end ())
+        {
+          NS_LOG_LOGIC ("No handler for RAN parameter " << parameter.m_id);
+          continue;
+        }
+
+      const Handler &handler = it->second;
+      if (handler.m_integer && parameter.m_valueType == RANParameterItem::ValueType::Int)
+        {
+          handler.m_integer (action, parameter.m_valueInt);
+        }
+      else if (handler.m_nrCgi && parameter.m_valueType == RANParameterItem::ValueType::OctectString)
+        {
+          NrCgi cgi;
+          if (!DecodeNrCgi (parameter.m_valueBuf, parameter.m_valueSize,
+                            handler.m_nrCgiEncoding, cgi))
+            {
+              NS_LOG_WARN ("RAN parameter " << parameter.m_id << " is not a valid NR CGI");
+              continue;
+            }
+          handler.m_nrCgi (action, cgi);
+        }
+      else if (handler.m_octetString
+               && parameter.m_valueType == RANParameterItem::ValueType::OctectString)
+        {
+          handler.m_octetString (action, parameter.m_valueBuf, parameter.m_valueSize);
+        }
+      else
+        {
+          NS_LOG_WARN ("RAN parameter " << parameter.m_id << " has an unexpected type "
+                                        << parameter.m_valueType);
+          continue;
+        }
+      handled++;
+    }
+  return handled;
+}
+
+bool
+RicControlDispatcher::DecodeNrCgi (const uint8_t *buffer, size_t size, NrCgiEncoding encoding,
+                                   NrCgi &cgi)
+{
+  // text: three digits of PLMN followed by the digits of the cell ID
+  if (encoding == NR_CGI_TEXT)
+    {
+      if (size <= 3 || size > 3 + 10)
+        {
+          return false;
+        }
+      for (size_t i = 0; i < size; i++)
+        {
+          if (buffer[i] < '0' || buffer[i] > '9')
+            {
+              return false;
+            }
+        }
+      cgi.m_plmnId.m_mcc = (buffer[0] - '0') * 100 + (buffer[1] - '0') * 10 + (buffer[2] - '0');
+      cgi.m_plmnId.m_mnc = 0;
+      cgi.m_plmnId.m_mncDigits = 0;
+      cgi.m_nrCellId = 0;
+      for (size_t i = 3; i < size; i++)
+        {
+          cgi.m_nrCellId = cgi.m_nrCellId * 10 + (buffer[i] - '0');
+        }
+      return cgi.m_nrCellId < (1ULL << 36);
+    }
+
+  // binary: PLMN in TBCD, TS 38.413 Section 9.3.3.5, and 36-bit NR cell identity
+  if (size != 8)
+    {
+      return false;
+    }
+  uint8_t mcc1 = buffer[0] & 0x0f;
+  uint8_t mcc2 = buffer[0] >> 4;
+  uint8_t mcc3 = buffer[1] & 0x0f;
+  uint8_t mnc3 = buffer[1] >> 4;
+  uint8_t mnc1 = buffer[2] & 0x0f;
+  uint8_t mnc2 = buffer[2] >> 4;
+  if (mcc1 > 9 || mcc2 > 9 || mcc3 > 9 || mnc1 > 9 || mnc2 > 9 || (mnc3 > 9 && mnc3 != 0x0f))
+    {
+      return false;
+    }
+  cgi.m_plmnId.m_mcc = mcc1 * 100 + mcc2 * 10 + mcc3;
+  if (mnc3 == 0x0f)
+    {
+      cgi.m_plmnId.m_mnc = mnc1 * 10 + mnc2;
+      cgi.m_plmnId.m_mncDigits = 2;
+    }
+  else
+    {
+      cgi.m_plmnId.m_mnc = mnc1 * 100 + mnc2 * 10 + mnc3;
+      cgi.m_plmnId.m_mncDigits = 3;
+    }
+  cgi.m_nrCellId = ((uint64_t) buffer[3] << 28) | ((uint64_t) buffer[4] << 20)
+                   | ((uint64_t) buffer[5] << 12) | ((uint64_t) buffer[6] << 4) | (buffer[7] >> 4);
+  return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef RIC_CONTROL_DISPATCHER_H
+#define RIC_CONTROL_DISPATCHER_H
+
+#include "ns3/object.h"
+#include <ns3/ric-control-message.h>
+#include <functional>
+#include <unordered_map>
+
+namespace ns3 {
+
+  /**
+  * PLMN identity, see 3GPP TS 38.473, Section 9.3.1.14
+  */
+  struct PlmnId
+  {
+    uint16_t m_mcc; //!< the mobile country code
+    uint16_t m_mnc; //!< the mobile network code
+    uint8_t m_mncDigits; //!< the digits of the MNC, 2 or 3, or 0 if absent
+  };
+
+  /**
+  * NR cell global identifier, see 3GPP TS 38.473, Section 9.3.1.12
+  */
+  struct NrCgi
+  {
+    PlmnId m_plmnId; //!< the PLMN of the cell
+    uint64_t m_nrCellId; //!< the 36-bit NR cell identity
+  };
+
+  /**
+  * The control action a RAN parameter is received with
+  */
+  struct RicControlAction
+  {
+    long m_ranFunctionId; //!< the RAN function
+    long m_styleType; //!< the RIC control style
+    long m_actionId; //!< the RIC control action
+    const uint8_t *m_ueId; //!< the UE ID of the control header
+    size_t m_ueIdSize; //!< the size of the UE ID
+    const RicControlMessage *m_message; //!< the decoded message
+  };
+
+  /**
+  * Dispatches the RAN parameters of the RIC Control Messages to typed
+  * handlers, registered per RAN function, control style, control action
+  * and RAN parameter ID. Each parameter is looked up in a hash table, so
+  * the cost of a message does not depend on the number of handlers.
+  *
+  * The values are decoded for the handlers: integers as they are, NR CGIs
+  * with the encoding chosen when the handler is registered, see
+  * NrCgiEncoding. The PLMN of the text encoding is kept in the MCC, with
+  * no MNC.
+  */
+  class RicControlDispatcher : public SimpleRefCount<RicControlDispatcher>
+  {
+  public:
+    /**
+    * Encoding of the NR CGI RAN parameters
+    */
+    enum NrCgiEncoding
+    {
+      NR_CGI_TEXT, //!< digits of the PLMN and the cell ID, e.g., "1112", sent by the xApps of this module
+      NR_CGI_BINARY //!< TS 38.473: three TBCD octets of PLMN and the 36-bit NR cell identity
+    };
+
+    /**
+    * Handler of the integer RAN parameters
+    */
+    typedef std::function<void (const RicControlAction &action, long value)> IntegerHandler;
+
+    /**
+    * Handler of the NR CGI RAN parameters
+    */
+    typedef std::function<void (const RicControlAction &action, const NrCgi &cgi)> NrCgiHandler;
+
+    /**
+    * Handler of the octet string RAN parameters
+    */
+    typedef std::function<void (const RicControlAction &action, const uint8_t *buffer,
+                                size_t size)> OctetStringHandler;
+
+    RicControlDispatcher ();
+    ~RicControlDispatcher ();
+
+    /**
+    * Register the handler of an integer RAN parameter, replacing any
+    * handler registered for the same parameter
+    *
+    * \param ranFunctionId the RAN function
+    * \param styleType the RIC control style
+    * \param actionId the RIC control action
+    * \param ranParameterId the RAN parameter ID
+    * \param handler the handler
+    */
+    void RegisterIntegerHandler (long ranFunctionId, long styleType, long actionId,
+                                 long ranParameterId, IntegerHandler handler);
+
+    /**
+    * Register the handler of an NR CGI RAN parameter, replacing any
+    * handler registered for the same parameter
+    *
+    * \param ranFunctionId the RAN function
+    * \param styleType the RIC control style
+    * \param actionId the RIC control action
+    * \param ranParameterId the RAN parameter ID
+    * \param handler the handler
+    * \param encoding the encoding of the parameter
+    */
+    void RegisterNrCgiHandler (long ranFunctionId, long styleType, long actionId,
+                               long ranParameterId, NrCgiHandler handler,
+                               NrCgiEncoding encoding = NR_CGI_TEXT);
+
+    /**
+    * Register the handler of an octet string RAN parameter, replacing any
+    * handler registered for the same parameter
+    *
+    * \param ranFunctionId the RAN function
+    * \param styleType the RIC control style
+    * \param actionId the RIC control action
+    * \param ranParameterId the RAN parameter ID
+    * \param handler the handler
+    */
+    void RegisterOctetStringHandler (long ranFunctionId, long styleType, long actionId,
+                                     long ranParameterId, OctetStringHandler handler);
+
+    /**
+    * Call the handlers of the RAN parameters of a message
+    *
+    * \param message the decoded message
+    * \return the number of RAN parameters handled
+    */
+    uint32_t Dispatch (const RicControlMessage &message) const;
+
+    /**
+    * Decode an NR CGI
+    *
+    * \param buffer the octets of the RAN parameter
+    * \param size the number of octets
+    * \param encoding the encoding of the octets
+    * \param cgi the decoded CGI
+    * \return false if the octets are not an NR CGI with the given encoding
+    */
+    static bool DecodeNrCgi (const uint8_t *buffer, size_t size, NrCgiEncoding encoding,
+                             NrCgi &cgi);
+
+  private:
+    /**
+    * Key of the handlers
+    */
+    struct Key
+    {
+      long m_ranFunctionId; //!< the RAN function
+      long m_styleType; //!< the RIC control style
+      long m_actionId; //!< the RIC control action
+      long m_ranParameterId; //!< the RAN parameter ID
+
+      /**
+      * \param other the key to compare with
+      * \return true if the keys are equal
+      */
+      bool operator== (const Key &other) const;
+    };
+
+    /**
+    * Hash of the keys of the handlers
+    */
+    struct KeyHash
+    {
+      /**
+      * \param key the key
+      * \return the hash of the key
+      */
+      size_t operator() (const Key &key) const;
+    };
+
+    /**
+    * The handler registered for a RAN parameter, of one of the types
+    */
+    struct Handler
+    {
+      IntegerHandler m_integer; //!< the handler, if the parameter is an integer
+      NrCgiHandler m_nrCgi; //!< the handler, if the parameter is an NR CGI
+      NrCgiEncoding m_nrCgiEncoding; //!< the encoding, if the parameter is an NR CGI
+      OctetStringHandler m_octetString; //!< the handler, if the parameter is an octet string
+    };
+
+    std::unordered_map<Key, Handler, KeyHash> m_handlers; //!< the handlers
+  };
+
+} // namespace ns3
+
+#endif /* RIC_CONTROL_DISPATCHER_H */
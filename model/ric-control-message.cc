@@ -26,20 +26,70 @@
 #include <ns3/asn1c-types.h>
 #include <ns3/log.h>
 #include <bitset>
+#include <cstring>
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("RicControlMessage");
 
 
+RicControlDecodeArena::RicControlDecodeArena ()
+  : m_headerDecoded (false),
+    m_messageDecoded (false)
+{
+  memset (&m_header, 0, sizeof (m_header));
+  memset (&m_message, 0, sizeof (m_message));
+}
+
+RicControlDecodeArena::~RicControlDecodeArena ()
+{
+  Reset ();
+}
+
+void
+RicControlDecodeArena::Reset ()
+{
+  if (m_headerDecoded)
+    {
+      ASN_STRUCT_RESET (asn_DEF_E2SM_RC_ControlHeader, &m_header);
+      m_headerDecoded = false;
+    }
+  if (m_messageDecoded)
+    {
+      ASN_STRUCT_RESET (asn_DEF_E2SM_RC_ControlMessage, &m_message);
+      m_messageDecoded = false;
+    }
+  m_parameters.clear ();
+}
+
 RicControlMessage::RicControlMessage (E2AP_PDU_t* pdu)
+  : m_requestType (ControlMessageRequestIdType::UNKNOWN),
+    m_e2SmRcControlHeaderFormat1 (nullptr),
+    m_ownedArena (new RicControlDecodeArena ()),
+    m_arena (m_ownedArena.get ())
 {
   DecodeRicControlMessage (pdu);
+  if (m_arena->m_messageDecoded
+      && m_arena->m_message.present == E2SM_RC_ControlMessage_PR_controlMessage_Format1)
+    {
+      m_valuesExtracted =
+          ExtractRANParametersFromControlMessage (m_arena->m_message.choice.controlMessage_Format1);
+    }
   NS_LOG_INFO ("End of RicControlMessage::RicControlMessage()");
 }
 
-RicControlMessage::~RicControlMessage ()
+RicControlMessage::RicControlMessage (E2AP_PDU_t* pdu, RicControlDecodeArena &arena)
+  : m_requestType (ControlMessageRequestIdType::UNKNOWN),
+    m_e2SmRcControlHeaderFormat1 (nullptr),
+    m_arena (&arena)
 {
+  // a previous message still holds the arena if the callback did not
+  // return in between, e.g., when decoding several messages in a row
+  m_arena->Reset ();
+  DecodeRicControlMessage (pdu);
+}
 
+RicControlMessage::~RicControlMessage ()
+{
 }
 
 void  
@@ -47,7 +97,7 @@ RicControlMessage::DecodeRicControlMessage(E2AP_PDU_t* pdu)
 {
     InitiatingMessage_t* mess = pdu->choice.initiatingMessage;
     auto *request = (RICcontrolRequest_t *) &mess->value.choice.RICcontrolRequest;
-    NS_LOG_INFO (xer_fprint(stderr, &asn_DEF_RICcontrolRequest, request));
+    NS_LOG_LOGIC (xer_fprint(stderr, &asn_DEF_RICcontrolRequest, request));
 
     size_t count = request->protocolIEs.list.count; 
     if (count <= 0) {
@@ -73,6 +123,11 @@ RicControlMessage::DecodeRicControlMessage(E2AP_PDU_t* pdu)
                         m_requestType = ControlMessageRequestIdType::QoS;
                         break;
                     }
+                    default: {
+                        NS_LOG_DEBUG("Message of an unknown xApp");
+                        m_requestType = ControlMessageRequestIdType::UNKNOWN;
+                        break;
+                    }
                 }
                 break;
             }
@@ -91,14 +146,24 @@ RicControlMessage::DecodeRicControlMessage(E2AP_PDU_t* pdu)
                 NS_LOG_DEBUG("[E2SM] RICcontrolRequest_IEs__value_PR_RICcontrolHeader");
                 // xer_fprint(stderr, &asn_DEF_RICcontrolHeader, &ie->value.choice.RICcontrolHeader);
 
-                auto *e2smControlHeader = (E2SM_RC_ControlHeader_t *) calloc(1,
-                                                                             sizeof(E2SM_RC_ControlHeader_t));
-                ASN_STRUCT_RESET(asn_DEF_E2SM_RC_ControlHeader, e2smControlHeader);
-                asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_RC_ControlHeader,
-                            (void **) &e2smControlHeader, ie->value.choice.RICcontrolHeader.buf,
-                            ie->value.choice.RICcontrolHeader.size);
+                // decode in place, into the header of the arena
+                E2SM_RC_ControlHeader_t *e2smControlHeader = &m_arena->m_header;
+                if (m_arena->m_headerDecoded)
+                  {
+                    ASN_STRUCT_RESET (asn_DEF_E2SM_RC_ControlHeader, e2smControlHeader);
+                  }
+                m_arena->m_headerDecoded = true;
+                asn_dec_rval_t rval =
+                    asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_RC_ControlHeader,
+                                (void **) &e2smControlHeader, ie->value.choice.RICcontrolHeader.buf,
+                                ie->value.choice.RICcontrolHeader.size);
+                if (rval.code != RC_OK)
+                  {
+                    NS_LOG_ERROR ("[E2SM] Unable to decode the E2SM Control Header");
+                    break;
+                  }
 
-                NS_LOG_INFO (xer_fprint (stderr, &asn_DEF_E2SM_RC_ControlHeader, e2smControlHeader));
+                NS_LOG_LOGIC (xer_fprint (stderr, &asn_DEF_E2SM_RC_ControlHeader, e2smControlHeader));
                 if (e2smControlHeader->present == E2SM_RC_ControlHeader_PR_controlHeader_Format1) {
                     m_e2SmRcControlHeaderFormat1 = e2smControlHeader->choice.controlHeader_Format1;
                     //m_e2SmRcControlHeaderFormat1->ric_ControlAction_ID;
@@ -113,36 +178,49 @@ RicControlMessage::DecodeRicControlMessage(E2AP_PDU_t* pdu)
                 NS_LOG_DEBUG("[E2SM] RICcontrolRequest_IEs__value_PR_RICcontrolMessage");
                 // xer_fprint(stderr, &asn_DEF_RICcontrolMessage, &ie->value.choice.RICcontrolMessage);
 
-                auto *e2SmControlMessage = (E2SM_RC_ControlMessage_t *) calloc(1,
-                                                                               sizeof(E2SM_RC_ControlMessage_t));
-                ASN_STRUCT_RESET(asn_DEF_E2SM_RC_ControlMessage, e2SmControlMessage);
-
-                asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_RC_ControlMessage,
-                            (void **) &e2SmControlMessage, ie->value.choice.RICcontrolMessage.buf,
-                            ie->value.choice.RICcontrolMessage.size);
+                // decode in place, into the message of the arena
+                E2SM_RC_ControlMessage_t *e2SmControlMessage = &m_arena->m_message;
+                if (m_arena->m_messageDecoded)
+                  {
+                    ASN_STRUCT_RESET (asn_DEF_E2SM_RC_ControlMessage, e2SmControlMessage);
+                    m_arena->m_parameters.clear ();
+                  }
+                m_arena->m_messageDecoded = true;
+                asn_dec_rval_t rval =
+                    asn_decode (nullptr, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_RC_ControlMessage,
+                                (void **) &e2SmControlMessage, ie->value.choice.RICcontrolMessage.buf,
+                                ie->value.choice.RICcontrolMessage.size);
+                if (rval.code != RC_OK)
+                  {
+                    NS_LOG_ERROR ("[E2SM] Unable to decode the E2SM Control Message");
+                    break;
+                  }
 
-                NS_LOG_INFO (xer_fprint(stderr, &asn_DEF_E2SM_RC_ControlMessage, e2SmControlMessage));
+                NS_LOG_LOGIC (xer_fprint(stderr, &asn_DEF_E2SM_RC_ControlMessage, e2SmControlMessage));
 
                 if (e2SmControlMessage->present == E2SM_RC_ControlMessage_PR_controlMessage_Format1)
                   {
                     NS_LOG_DEBUG ("[E2SM] E2SM_RC_ControlMessage_PR_controlMessage_Format1");
                     E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1 =
                         e2SmControlMessage->choice.controlMessage_Format1;
-                    m_valuesExtracted =
-                        ExtractRANParametersFromControlMessage (e2SmRcControlMessageFormat1);
+                    std::vector<RanParameterView> &parameters = m_arena->m_parameters;
+                    m_arena->m_walker.Walk (
+                        e2SmRcControlMessageFormat1,
+                        [&parameters] (const std::vector<RanParameterPathElement> &,
+                                       const RanParameterView &value) { parameters.push_back (value); });
                     if (m_requestType == ControlMessageRequestIdType::TS)
                       {
                         // Get and parse the secondaty cell id according to 3GPP TS 38.473, Section 9.2.2.1
-                        for (RANParameterItem item : m_valuesExtracted)
+                        for (const RanParameterView &view : m_arena->m_parameters)
                           {
-                            if (item.m_valueType == RANParameterItem::ValueType::OctectString)
+                            if (view.m_valueType == RANParameterItem::ValueType::OctectString
+                                && view.m_valueSize > 0)
                               {
                                 // First 3 digits are the PLMNID (always 111), last digit is CellId
-                                std::string cgi = item.m_valueStr->DecodeContent ();
-                                 NS_LOG_INFO ("Decoded CGI value is: " << cgi);
-                                m_secondaryCellId = cgi.back();
+                                m_secondaryCellId.assign (1, (char) view.m_valueBuf[view.m_valueSize - 1]);
+                                NS_LOG_INFO ("Decoded CGI cell is: " << m_secondaryCellId);
                               }
-                          }         
+                          }
                       }
                   }
                 else
@@ -195,23 +273,23 @@ RicControlMessage::GetSecondaryCellIdHO ()
   return m_secondaryCellId;
 }
 
+const std::vector<RanParameterView>&
+RicControlMessage::GetRanParameters () const
+{
+  return m_arena->m_parameters;
+}
+
 std::vector<RANParameterItem>
 RicControlMessage::ExtractRANParametersFromControlMessage (
     E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1)
 {
   std::vector<RANParameterItem> ranParameterList;
-  int count = e2SmRcControlMessageFormat1->ranParameters_List->list.count;
-  for (int i = 0; i < count; i++)
-    {
-      RANParameter_Item_t *ranParameterItem =
-          e2SmRcControlMessageFormat1->ranParameters_List->list.array[i];
-      for (RANParameterItem extractedParameter :
-           RANParameterItem::ExtractRANParametersFromRANParameter (ranParameterItem))
-        {
-          ranParameterList.push_back (extractedParameter);
-        }
-    }
-
+  RanParameterWalker walker;
+  walker.Walk (e2SmRcControlMessageFormat1,
+               [&ranParameterList] (const std::vector<RanParameterPathElement> &,
+                                    const RanParameterView &value) {
+                 ranParameterList.push_back (RANParameterItem::FromView (value));
+               });
   return ranParameterList;
 }
 
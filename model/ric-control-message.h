@@ -27,6 +27,9 @@
 
 #include "ns3/object.h"
 #include <ns3/asn1c-types.h>
+#include <ns3/ran-parameter-walker.h>
+#include <memory>
+#include <vector>
 
 extern "C" {
   #include "E2AP-PDU.h"
@@ -43,14 +46,63 @@ extern "C" {
 
 namespace ns3 {
 
+  /**
+  * Storage reused across the RIC Control Messages decoded by an E2
+  * termination. The E2SM header and message are decoded in place and the
+  * parameter views keep their capacity, so that decoding a message in
+  * steady state only allocates what asn1c allocates internally. Reset
+  * releases the decoded content, see E2Termination::GetControlDecodeArena.
+  */
+  class RicControlDecodeArena
+  {
+  public:
+    RicControlDecodeArena ();
+    ~RicControlDecodeArena ();
+
+    /**
+    * Release the content decoded since the last reset. The messages and
+    * views decoded with this arena are invalid afterwards.
+    */
+    void Reset ();
+
+  private:
+    friend class RicControlMessage;
+
+    RicControlDecodeArena (const RicControlDecodeArena &) = delete;
+    RicControlDecodeArena &operator= (const RicControlDecodeArena &) = delete;
+
+    E2SM_RC_ControlHeader_t m_header; //!< the decoded E2SM-RC header
+    E2SM_RC_ControlMessage_t m_message; //!< the decoded E2SM-RC message
+    bool m_headerDecoded; //!< m_header holds decoded content
+    bool m_messageDecoded; //!< m_message holds decoded content
+    std::vector<RanParameterView> m_parameters; //!< the parameters of the message
+    RanParameterWalker m_walker; //!< walks the parameters of the message
+  };
+
   class RicControlMessage : public SimpleRefCount<RicControlMessage>
   {
   public:
-    enum ControlMessageRequestIdType { TS = 1001, QoS = 1002 };
+    enum ControlMessageRequestIdType { UNKNOWN = 0, TS = 1001, QoS = 1002 };
+
+    /**
+    * Decode a RIC Control Request into storage owned by the message, and
+    * copy its RAN parameters into m_valuesExtracted.
+    *
+    * \param pdu PDU passed by the RIC
+    */
     RicControlMessage (E2AP_PDU_t *pdu);
+
+    /**
+    * Decode a RIC Control Request into an arena, without copying the RAN
+    * parameters. The message is valid until the arena is reset.
+    *
+    * \param pdu PDU passed by the RIC
+    * \param arena the arena, e.g., the one of the E2 termination
+    */
+    RicControlMessage (E2AP_PDU_t *pdu, RicControlDecodeArena &arena);
     ~RicControlMessage ();
 
-    ControlMessageRequestIdType m_requestType;
+    ControlMessageRequestIdType m_requestType; //!< the xApp of the request, from the RIC Requestor ID
     
     static std::vector<RANParameterItem> ExtractRANParametersFromControlMessage (
       E2SM_RC_ControlMessage_Format1_t *e2SmRcControlMessageFormat1);
@@ -62,6 +114,11 @@ namespace ns3 {
     E2SM_RC_ControlHeader_Format1_t *m_e2SmRcControlHeaderFormat1;
     std::string GetSecondaryCellIdHO ();
 
+    /**
+    * \return views of the RAN parameters of the message, flattened
+    */
+    const std::vector<RanParameterView>& GetRanParameters () const;
+
   private:
     /**
     * Decodes the RIC Control message .
@@ -69,7 +126,10 @@ namespace ns3 {
     * \param pdu PDU passed by the RIC
     */
     void DecodeRicControlMessage (E2AP_PDU_t *pdu);
+
     std::string m_secondaryCellId;
+    std::unique_ptr<RicControlDecodeArena> m_ownedArena; //!< the arena, if owned by the message
+    RicControlDecodeArena *m_arena; //!< the arena the message is decoded with
   };
 }
 
@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#include <ns3/ric-request-inbox.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <chrono>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RicRequestInbox");
+
+RicRequestInbox::RicRequestInbox (uint32_t depth, Time timeout, DeliverCallback deliver)
+  : m_queue (depth),
+    m_timeout (timeout),
+    m_deliver (deliver),
+    m_open (true),
+    m_drainScheduled (false),
+    m_droppedRequests (0)
+{
+  NS_LOG_FUNCTION (this << depth);
+}
+
+RicRequestInbox::~RicRequestInbox ()
+{
+  NS_LOG_FUNCTION (this);
+  m_open = false;
+  ReleaseWaiting ();
+}
+
+bool
+RicRequestInbox::Post (Kind kind, long ranFunctionId, E2AP_PDU_t* pdu)
+{
+  Request request = {kind, ranFunctionId, pdu};
+  auto deadline = std::chrono::steady_clock::now ()
+                  + std::chrono::nanoseconds (m_timeout.GetNanoSeconds ());
+  while (!m_queue.TryPush (request))
+    {
+      // the simulator thread frees the slots at its next event boundary,
+      // unless it stopped or the inbox was closed
+      if (!m_open || std::chrono::steady_clock::now () >= deadline)
+        {
+          NS_LOG_WARN ("RIC request inbox full, dropping a request for RAN Function "
+                       << ranFunctionId);
+          m_droppedRequests++;
+          ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, pdu);
+          return false;
+        }
+      std::this_thread::yield ();
+    }
+
+  // a single drain event is pending at any time; the drain clears the flag
+  // before emptying the queue, so the requests pushed after it was emptied
+  // schedule a new one
+  if (!m_drainScheduled.exchange (true))
+    {
+      Simulator::ScheduleWithContext (Simulator::NO_CONTEXT, Seconds (0),
+                                      &RicRequestInbox::DrainIfAlive,
+                                      std::weak_ptr<RicRequestInbox> (shared_from_this ()));
+    }
+  return true;
+}
+
+void
+RicRequestInbox::DrainIfAlive (std::weak_ptr<RicRequestInbox> inbox)
+{
+  std::shared_ptr<RicRequestInbox> alive = inbox.lock ();
+  if (alive)
+    {
+      alive->Drain ();
+    }
+}
+
+void
+RicRequestInbox::Drain ()
+{
+  NS_LOG_FUNCTION (this);
+  m_drainScheduled = false;
+  if (!m_open)
+    {
+      ReleaseWaiting ();
+      return;
+    }
+
+  Request request;
+  while (m_queue.TryPop (request))
+    {
+      m_deliver (request);
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, request.m_pdu);
+    }
+}
+
+void
+RicRequestInbox::Close ()
+{
+  NS_LOG_FUNCTION (this);
+  m_open = false;
+  ReleaseWaiting ();
+}
+
+uint64_t
+RicRequestInbox::GetDroppedRequests () const
+{
+  return m_droppedRequests;
+}
+
+void
+RicRequestInbox::ReleaseWaiting ()
+{
+  Request request;
+  while (m_queue.TryPop (request))
+    {
+      ASN_STRUCT_FREE (asn_DEF_E2AP_PDU, request.m_pdu);
+    }
+}
+
+} // namespace ns3
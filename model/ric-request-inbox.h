@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2022 Northeastern University
+ * Copyright (c) 2022 Sapienza, University of Rome
+ * Copyright (c) 2022 University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Andrea Lacava <thecave003@gmail.com>
+ *		   Tommaso Zugno <tommasozugno@gmail.com>
+ *		   Michele Polese <michele.polese@gmail.com>
+ */
+
+#ifndef RIC_REQUEST_INBOX_H
+#define RIC_REQUEST_INBOX_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include <ns3/bounded-mpsc-queue.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+extern "C" {
+  #include "E2AP-PDU.h"
+ }
+
+namespace ns3 {
+
+  /**
+  * Hands the requests received from the RIC over from the network threads
+  * to the simulator thread.
+  *
+  * The network threads post the requests into a bounded lock-free queue,
+  * and a single event scheduled with ScheduleWithContext delivers them on
+  * the simulator thread at the next event boundary. The event only holds
+  * a weak reference to the inbox and does nothing once the inbox is closed
+  * or destroyed, so the owner of the inbox can be destroyed while an event
+  * is pending.
+  */
+  class RicRequestInbox : public std::enable_shared_from_this<RicRequestInbox>
+  {
+  public:
+    /**
+    * Kind of the requests received from the RIC
+    */
+    enum Kind
+    {
+      SUBSCRIPTION,
+      SUBSCRIPTION_DELETE,
+      CONTROL
+    };
+
+    /**
+    * A request waiting for the simulator thread
+    */
+    struct Request
+    {
+      Kind m_kind; //!< the kind of the request
+      long m_ranFunctionId; //!< the RAN function of the request
+      E2AP_PDU_t* m_pdu; //!< the request, owned by the inbox
+    };
+
+    /**
+    * Called on the simulator thread with each request, which is released
+    * when the callback returns
+    */
+    typedef std::function<void (const Request &)> DeliverCallback;
+
+    /**
+    * \param depth the maximum number of requests waiting
+    * \param timeout how long Post waits for a free slot before dropping
+    *        the request
+    * \param deliver the callback receiving the requests
+    */
+    RicRequestInbox (uint32_t depth, Time timeout, DeliverCallback deliver);
+    ~RicRequestInbox ();
+
+    /**
+    * Post a request, may be called by any thread. If the inbox stays full
+    * for longer than the timeout, or is closed, the request is dropped.
+    *
+    * \param kind the kind of the request
+    * \param ranFunctionId the RAN function of the request
+    * \param pdu the request, whose ownership is taken in any case
+    * \return false if the request was dropped
+    */
+    bool Post (Kind kind, long ranFunctionId, E2AP_PDU_t* pdu);
+
+    /**
+    * Deliver the waiting requests. Runs on the simulator thread.
+    */
+    void Drain ();
+
+    /**
+    * Stop delivering: the waiting requests are released, and the ones
+    * posted afterwards are dropped. Runs on the simulator thread.
+    */
+    void Close ();
+
+    /**
+    * \return the number of requests dropped
+    */
+    uint64_t GetDroppedRequests () const;
+
+  private:
+    /**
+    * Body of the drain events
+    *
+    * \param inbox the inbox, if it still exists
+    */
+    static void DrainIfAlive (std::weak_ptr<RicRequestInbox> inbox);
+
+    /**
+    * Release the waiting requests
+    */
+    void ReleaseWaiting ();
+
+    BoundedMpscQueue<Request> m_queue; //!< the requests waiting
+    Time m_timeout; //!< the longest wait for a free slot
+    DeliverCallback m_deliver; //!< receives the requests
+    std::atomic<bool> m_open; //!< false once the inbox is closed
+    std::atomic<bool> m_drainScheduled; //!< a drain event is pending
+    std::atomic<uint64_t> m_droppedRequests; //!< requests dropped
+  };
+
+} // namespace ns3
+
+#endif /* RIC_REQUEST_INBOX_H */